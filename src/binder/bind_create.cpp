@@ -129,7 +129,39 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // The parser has no `INCLUDE (...)` clause, included columns are given as `WITH (include = 'v2, v3')` instead.
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  std::optional<int> fill_factor;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      auto option_name = StringUtil::Lower(option->defname);
+      if (option_name == "include") {
+        if (option->arg == nullptr || option->arg->type != duckdb_libpgquery::T_PGString) {
+          throw bustub::Exception("index option include expects a string of column names");
+        }
+        auto names = std::string(reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str);
+        for (auto &name : StringUtil::Split(names, ',')) {
+          auto column_ref = ResolveColumn(*table, std::vector{StringUtil::Strip(name, ' ')});
+          include_cols.emplace_back(
+              std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+        }
+      } else if (option_name == "fillfactor") {
+        if (option->arg == nullptr || option->arg->type != duckdb_libpgquery::T_PGInteger) {
+          throw bustub::Exception("index option fillfactor expects an integer");
+        }
+        fill_factor = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.ival;
+        if (*fill_factor < BPLUSTREE_MIN_FILL_FACTOR || *fill_factor > 100) {
+          throw bustub::Exception(fmt::format("fillfactor must be between {} and 100", BPLUSTREE_MIN_FILL_FACTOR));
+        }
+      } else {
+        throw NotImplementedException(fmt::format("unsupported index option {}", option->defname));
+      }
+    }
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), stmt->accessMethod,
+                                          stmt->unique, std::move(include_cols), fill_factor);
 }
 
 }  // namespace bustub
@@ -719,6 +719,22 @@ auto Binder::BindAExpr(duckdb_libpgquery::PGAExpr *root) -> std::unique_ptr<Boun
   BUSTUB_ASSERT(root, "nullptr");
   auto name = std::string((reinterpret_cast<duckdb_libpgquery::PGValue *>(root->name->head->data.ptr_value))->val.str);
 
+  if (root->kind == duckdb_libpgquery::PG_AEXPR_BETWEEN || root->kind == duckdb_libpgquery::PG_AEXPR_NOT_BETWEEN) {
+    // `x BETWEEN a AND b` is bound as `x >= a AND x <= b`, and `x NOT BETWEEN a AND b` as `x < a OR x > b`.
+    auto bounds = reinterpret_cast<duckdb_libpgquery::PGList *>(root->rexpr);
+    if (bounds == nullptr || bounds->length != 2) {
+      throw bustub::Exception("BETWEEN expects exactly two bounds");
+    }
+    auto low = reinterpret_cast<duckdb_libpgquery::PGNode *>(bounds->head->data.ptr_value);
+    auto high = reinterpret_cast<duckdb_libpgquery::PGNode *>(bounds->head->next->data.ptr_value);
+    bool negated = root->kind == duckdb_libpgquery::PG_AEXPR_NOT_BETWEEN;
+    auto low_cmp = std::make_unique<BoundBinaryOp>(negated ? "<" : ">=", BindExpression(root->lexpr),
+                                                   BindExpression(low));
+    auto high_cmp = std::make_unique<BoundBinaryOp>(negated ? ">" : "<=", BindExpression(root->lexpr),
+                                                    BindExpression(high));
+    return std::make_unique<BoundBinaryOp>(negated ? "or" : "and", std::move(low_cmp), std::move(high_cmp));
+  }
+
   if (root->kind != duckdb_libpgquery::PG_AEXPR_OP) {
     throw bustub::Exception("unsupported op in AExpr");
   }
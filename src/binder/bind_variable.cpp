@@ -3,6 +3,8 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/expressions/bound_constant.h"
+#include "binder/statement/analyze_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
 #include "binder/statement/set_show_statement.h"
 #include "common/exception.h"
 namespace bustub {
@@ -23,4 +25,15 @@ auto Binder::BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> st
   return std::make_unique<VariableShowStatement>(stmt->name);
 }
 
+auto Binder::BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_VACUUM) != 0) {
+    throw bustub::NotImplementedException("vacuum is not supported");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<AnalyzeStatement>(std::nullopt);
+  }
+  auto table = BindBaseTableRef(stmt->relation->relname, std::nullopt);
+  return std::make_unique<AnalyzeStatement>(table->table_);
+}
+
 }  // namespace bustub
@@ -7,14 +7,23 @@
 namespace bustub {
 
 IndexStatement::IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                               std::vector<std::unique_ptr<BoundColumnRef>> cols)
+                               std::vector<std::unique_ptr<BoundColumnRef>> cols, std::string index_type,
+                               bool is_unique, std::vector<std::unique_ptr<BoundColumnRef>> include_cols,
+                               std::optional<int> fill_factor)
     : BoundStatement(StatementType::INDEX_STATEMENT),
       index_name_(std::move(index_name)),
       table_(std::move(table)),
-      cols_(std::move(cols)) {}
+      cols_(std::move(cols)),
+      index_type_(std::move(index_type)),
+      is_unique_(is_unique),
+      include_cols_(std::move(include_cols)),
+      fill_factor_(fill_factor) {}
 
 auto IndexStatement::ToString() const -> std::string {
-  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={} }}", index_name_, *table_, cols_);
+  return fmt::format(
+      "BoundIndex {{ index_name={}, table={}, cols={}, index_type={}, unique={}, include={}, fill_factor={} }}",
+      index_name_, *table_, cols_, index_type_, is_unique_, include_cols_,
+      fill_factor_.has_value() ? std::to_string(*fill_factor_) : "default");
 }
 
 }  // namespace bustub
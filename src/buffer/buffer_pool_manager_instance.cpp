@@ -94,13 +94,18 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool { 
   std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  page_table_->Find(page_id,frame_id);
+  if (!page_table_->Find(page_id, frame_id)) {
+    return false;
+  }
   Page* page = pages_+frame_id;
   if ( page->GetPinCount() <= 0 ){
     return false;
   }
   page->DecPinCnt();
-  page->SetIsDirty(is_dirty);
+  // a clean unpin must not drop the changes made by another pinner
+  if (is_dirty) {
+    page->SetIsDirty(true);
+  }
   if ( page->GetPinCount() == 0 ){
     replacer_->SetEvictable(frame_id,true);
   }
@@ -1,11 +1,15 @@
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <tuple>
+#include <vector>
 
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
@@ -25,6 +29,7 @@
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/worker_pool.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "optimizer/optimizer.h"
@@ -38,7 +43,17 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  exec_ctx->GetMemoryBudget()->SetLimit(GetQueryMemoryBudget());
+  auto max_workers = GetMaxParallelWorkers();
+  if (max_workers > 1) {
+    if (worker_pool_ == nullptr) {
+      worker_pool_ = std::make_unique<WorkerPool>(std::max(1U, std::thread::hardware_concurrency()));
+    }
+    // The thread of the executor is a worker too.
+    exec_ctx->SetWorkerPool(worker_pool_.get(), std::min(max_workers, worker_pool_->Size() + 1));
+  }
+  return exec_ctx;
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -224,11 +239,26 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       case StatementType::INDEX_STATEMENT: {
         const auto &index_stmt = dynamic_cast<const IndexStatement &>(*statement);
 
+        IndexType index_type;
+        if (index_stmt.index_type_ == "btree") {
+          index_type = IndexType::BPlusTreeIndex;
+        } else if (index_stmt.index_type_ == "art") {
+          index_type = IndexType::ArtIndex;
+        } else if (index_stmt.index_type_ == "hash") {
+          index_type = IndexType::HashTableIndex;
+        } else if (index_stmt.index_type_ == "linear_hash") {
+          index_type = IndexType::LinearProbeHashTableIndex;
+        } else {
+          throw NotImplementedException(fmt::format("unsupported index type {}", index_stmt.index_type_));
+        }
+
         std::vector<uint32_t> col_ids;
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
+          // the art index checks its key types itself
+          if (index_type != IndexType::ArtIndex &&
+              index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
             throw NotImplementedException("only support creating index on integer column");
           }
         }
@@ -237,10 +267,43 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
+        std::vector<uint32_t> include_ids;
+        for (const auto &col : index_stmt.include_cols_) {
+          auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
+          include_ids.push_back(idx);
+          if (!index_stmt.table_->schema_.GetColumn(idx).IsInlined()) {
+            throw NotImplementedException("only support including fixed-length columns");
+          }
+        }
+        if (!include_ids.empty()) {
+          if (index_type != IndexType::BPlusTreeIndex) {
+            throw NotImplementedException("only b+ tree indexes support included columns");
+          }
+          // Duplicate keys share one leaf entry in a posting list, which has room for the columns of one tuple only.
+          if (!index_stmt.is_unique_) {
+            throw NotImplementedException("only unique indexes support included columns");
+          }
+          auto entry_ids = col_ids;
+          entry_ids.insert(entry_ids.end(), include_ids.begin(), include_ids.end());
+          if (Schema::CopySchema(&index_stmt.table_->schema_, entry_ids).GetLength() > COVERING_KEY_SIZE) {
+            throw NotImplementedException(
+                fmt::format("included columns take more than {} bytes with the key", COVERING_KEY_SIZE));
+          }
+        }
+
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        IndexInfo *info;
+        if (include_ids.empty()) {
+          info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              INTEGER_SIZE, IntegerHashFunctionType{}, index_type, index_stmt.is_unique_, {},
+              index_stmt.fill_factor_.value_or(BPLUSTREE_DEFAULT_FILL_FACTOR));
+        } else {
+          info = catalog_->CreateIndex<CoveringKeyType, IntegerValueType, CoveringComparatorType>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              COVERING_KEY_SIZE, CoveringHashFunctionType{}, index_type, index_stmt.is_unique_, include_ids,
+              index_stmt.fill_factor_.value_or(BPLUSTREE_DEFAULT_FILL_FACTOR));
+        }
         l.unlock();
 
         if (info == nullptr) {
@@ -249,6 +312,35 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
         continue;
       }
+      case StatementType::ANALYZE_STATEMENT: {
+        const auto &analyze_stmt = dynamic_cast<const AnalyzeStatement &>(*statement);
+
+        // Collecting the statistics only reads the indexes, but storing them changes what planners see.
+        std::unique_lock<std::shared_mutex> l(catalog_lock_);
+        std::vector<std::string> table_names;
+        if (analyze_stmt.table_.has_value()) {
+          table_names.push_back(*analyze_stmt.table_);
+        } else {
+          table_names = catalog_->GetTableNames();
+        }
+        writer.BeginTable(false);
+        writer.BeginHeader();
+        writer.WriteHeaderCell("table_name");
+        writer.WriteHeaderCell("index_name");
+        writer.WriteHeaderCell("stats");
+        writer.EndHeader();
+        for (const auto &table_name : table_names) {
+          for (const auto *index_info : catalog_->AnalyzeTable(table_name)) {
+            writer.BeginRow();
+            writer.WriteCell(table_name);
+            writer.WriteCell(index_info->name_);
+            writer.WriteCell(index_info->stats_.has_value() ? index_info->stats_->ToString() : "<none>");
+            writer.EndRow();
+          }
+        }
+        writer.EndTable();
+        continue;
+      }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
         auto content = GetSessionVariable(show_stmt.variable_);
@@ -288,7 +380,7 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         }
 
         // Print optimizer result.
-        bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+        bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(), GetMaxParallelWorkers());
         auto optimized_plan = optimizer.Optimize(planner.plan_);
 
         l.unlock();
@@ -315,7 +407,7 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     planner.PlanQuery(*statement);
 
     // Optimize the query.
-    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(), GetMaxParallelWorkers());
     auto optimized_plan = optimizer.Optimize(planner.plan_);
 
     l.unlock();
@@ -391,6 +483,7 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  worker_pool_.reset();
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
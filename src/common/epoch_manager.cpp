@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.cpp
+//
+// Identification: src/common/epoch_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/epoch_manager.h"
+
+#include <functional>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+EpochManager::~EpochManager() {
+  for (auto &retired : retired_) {
+    FreeAll(&retired);
+  }
+}
+
+auto EpochManager::Enter() -> std::atomic<int64_t> * {
+  thread_local const size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % NUM_STRIPES;
+  while (true) {
+    uint64_t epoch = epoch_.load();
+    auto *slot = &active_[epoch % 3][stripe].count_;
+    slot->fetch_add(1);
+    // If the epoch moved on meanwhile, the advancing thread may not have seen us, register in the new epoch instead.
+    if (epoch_.load() == epoch) {
+      return slot;
+    }
+    slot->fetch_sub(1);
+  }
+}
+
+void EpochManager::Retire(void *ptr, void (*deleter)(void *)) {
+  std::scoped_lock lock(retired_latch_);
+  retired_[epoch_.load() % 3].emplace_back(ptr, deleter);
+  if (++num_retired_ >= RETIRE_THRESHOLD) {
+    TryAdvance();
+  }
+}
+
+void EpochManager::TryAdvance() {
+  uint64_t epoch = epoch_.load();
+  for (const auto &counter : active_[(epoch + 2) % 3]) {
+    if (counter.count_.load() != 0) {
+      return;
+    }
+  }
+  if (!epoch_.compare_exchange_strong(epoch, epoch + 1)) {
+    return;
+  }
+  // Everything retired in epoch - 2 is unreachable now, and its slot is reused for epoch + 1.
+  auto &retired = retired_[(epoch + 1) % 3];
+  num_retired_ -= retired.size();
+  FreeAll(&retired);
+}
+
+void EpochManager::FreeAll(std::vector<std::pair<void *, void (*)(void *)>> *retired) {
+  for (auto &[ptr, deleter] : *retired) {
+    deleter(ptr);
+  }
+  retired->clear();
+}
+
+}  // namespace bustub
@@ -0,0 +1,1014 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art.cpp
+//
+// Identification: src/container/art/art.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/art/art.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** Number of prefix bytes stored in a node, longer prefixes are completed from a leaf when needed. */
+constexpr uint32_t MAX_STORED_PREFIX = 8;
+
+enum class NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+/*
+ * Version word layout: bit 0 marks a node that has been replaced (obsolete), bit 1 marks a locked node, the other
+ * bits count the modifications. Unlocking adds 0b10, which clears the lock bit and bumps the counter in one go.
+ */
+constexpr uint64_t OBSOLETE_BIT = 0b01;
+constexpr uint64_t LOCKED_BIT = 0b10;
+
+}  // namespace
+
+struct AdaptiveRadixTree::Node {
+  Node(NodeType type, const uint8_t *prefix, uint32_t prefix_len) : type_(type) { SetPrefix(prefix, prefix_len); }
+
+  /** Wait until the node is unlocked and return its version, restart if it is obsolete. */
+  auto ReadLockOrRestart(bool *restart) const -> uint64_t {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    while ((version & LOCKED_BIT) != 0) {
+      std::this_thread::yield();
+      version = version_.load(std::memory_order_acquire);
+    }
+    if ((version & OBSOLETE_BIT) != 0) {
+      *restart = true;
+    }
+    return version;
+  }
+
+  /** Restart if the node changed since `version` was read. */
+  void CheckOrRestart(uint64_t version, bool *restart) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load(std::memory_order_relaxed) != version) {
+      *restart = true;
+    }
+  }
+
+  void UpgradeToWriteLockOrRestart(uint64_t *version, bool *restart) {
+    if (version_.compare_exchange_strong(*version, *version + LOCKED_BIT, std::memory_order_acquire)) {
+      *version += LOCKED_BIT;
+    } else {
+      *restart = true;
+    }
+  }
+
+  void WriteLockOrRestart(bool *restart) {
+    uint64_t version;
+    do {
+      *restart = false;
+      version = ReadLockOrRestart(restart);
+      if (*restart) {
+        return;
+      }
+      UpgradeToWriteLockOrRestart(&version, restart);
+    } while (*restart);
+  }
+
+  void WriteUnlock() { version_.fetch_add(LOCKED_BIT, std::memory_order_release); }
+  void WriteUnlockObsolete() { version_.fetch_add(LOCKED_BIT | OBSOLETE_BIT, std::memory_order_release); }
+
+  void SetPrefix(const uint8_t *prefix, uint32_t prefix_len) {
+    if (prefix_len > 0) {
+      std::memcpy(prefix_, prefix, std::min(prefix_len, MAX_STORED_PREFIX));
+    }
+    prefix_len_ = prefix_len;
+  }
+
+  /** Prepend the prefix of the removed `parent` and the byte leading from it to this node. */
+  void AddPrefixBefore(const Node *parent, uint8_t key) {
+    uint32_t copy_count = std::min(MAX_STORED_PREFIX, parent->prefix_len_ + 1);
+    std::memmove(prefix_ + copy_count, prefix_, std::min(prefix_len_, MAX_STORED_PREFIX - copy_count));
+    std::memcpy(prefix_, parent->prefix_, std::min(copy_count, parent->prefix_len_));
+    if (parent->prefix_len_ < MAX_STORED_PREFIX) {
+      prefix_[copy_count - 1] = key;
+    }
+    prefix_len_ += parent->prefix_len_ + 1;
+  }
+
+  std::atomic<uint64_t> version_{0b100};
+  const NodeType type_;
+  uint16_t count_{0};
+  uint32_t prefix_len_{0};
+  uint8_t prefix_[MAX_STORED_PREFIX]{};
+};
+
+struct AdaptiveRadixTree::Leaf {
+  Leaf(ArtKey key, RID value) : key_(std::move(key)), value_(value) {}
+  const ArtKey key_;
+  const RID value_;
+};
+
+struct AdaptiveRadixTree::ScanBounds {
+  auto Contains(const ArtKey &key) const -> bool {
+    if (low_.has_value() && (low_inclusive_ ? key < *low_ : !(*low_ < key))) {
+      return false;
+    }
+    return !high_.has_value() || (high_inclusive_ ? !(*high_ < key) : key < *high_);
+  }
+
+  const std::optional<ArtKey> &low_;
+  const bool low_inclusive_;
+  const std::optional<ArtKey> &high_;
+  const bool high_inclusive_;
+};
+
+/*
+ * Leaves are kept in the child slots of inner nodes, tagged with the lowest pointer bit.
+ */
+namespace {
+
+template <typename N>
+auto IsLeaf(const N *child) -> bool {
+  return (reinterpret_cast<uintptr_t>(child) & 1) != 0;
+}
+
+template <typename L, typename N>
+auto AsLeaf(const N *child) -> L * {
+  return reinterpret_cast<L *>(reinterpret_cast<uintptr_t>(child) & ~uintptr_t{1});
+}
+
+template <typename N, typename L>
+auto LeafAsNode(L *leaf) -> N * {
+  return reinterpret_cast<N *>(reinterpret_cast<uintptr_t>(leaf) | 1);
+}
+
+}  // namespace
+
+/*
+ * Node4 and Node16 keep their key bytes sorted, with each child at the position of its key byte.
+ */
+template <uint16_t CAPACITY>
+struct AdaptiveRadixTree::SortedNode : public Node {
+  SortedNode(NodeType type, const uint8_t *prefix, uint32_t prefix_len) : Node(type, prefix, prefix_len) {}
+
+  auto IsFull() const -> bool { return count_ == CAPACITY; }
+
+  void Insert(uint8_t key, Node *child) {
+    uint16_t pos = 0;
+    while (pos < count_ && keys_[pos] < key) {
+      pos++;
+    }
+    for (uint16_t i = count_; i > pos; i--) {
+      keys_[i] = keys_[i - 1];
+      children_[i].store(children_[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    keys_[pos] = key;
+    children_[pos].store(child, std::memory_order_relaxed);
+    count_++;
+  }
+
+  /** @return the position of `key`, or -1. Readers may see a count that is being changed, so it is clamped. */
+  auto Find(uint8_t key) const -> int {
+    uint16_t count = std::min(count_, CAPACITY);
+#ifdef __SSE2__
+    if constexpr (CAPACITY == 16) {
+      // compare all 16 key bytes at once and keep the matches below count
+      __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(key)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys_)));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)) & ((1U << count) - 1);
+      return mask == 0 ? -1 : __builtin_ctz(mask);
+    }
+#endif
+    for (uint16_t i = 0; i < count; i++) {
+      if (keys_[i] == key) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  auto GetChild(uint8_t key) const -> Node * {
+    int pos = Find(key);
+    return pos < 0 ? nullptr : children_[pos].load(std::memory_order_relaxed);
+  }
+
+  void Change(uint8_t key, Node *child) { children_[Find(key)].store(child, std::memory_order_relaxed); }
+
+  void Remove(uint8_t key) {
+    int pos = Find(key);
+    if (pos < 0) {
+      return;
+    }
+    for (uint16_t i = pos; i + 1 < count_; i++) {
+      keys_[i] = keys_[i + 1];
+      children_[i].store(children_[i + 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    count_--;
+  }
+
+  template <typename N>
+  void CopyTo(N *other) const {
+    for (uint16_t i = 0; i < count_; i++) {
+      other->Insert(keys_[i], children_[i].load(std::memory_order_relaxed));
+    }
+  }
+
+  uint8_t keys_[CAPACITY]{};
+  std::atomic<Node *> children_[CAPACITY]{};
+};
+
+struct AdaptiveRadixTree::Node4 : public SortedNode<4> {
+  Node4(const uint8_t *prefix, uint32_t prefix_len) : SortedNode(NodeType::NODE4, prefix, prefix_len) {}
+  /** A Node4 is never shrunk, it is merged into its parent once it is down to one child. */
+  auto IsUnderfull() const -> bool { return false; }
+};
+
+struct AdaptiveRadixTree::Node16 : public SortedNode<16> {
+  Node16(const uint8_t *prefix, uint32_t prefix_len) : SortedNode(NodeType::NODE16, prefix, prefix_len) {}
+  auto IsUnderfull() const -> bool { return count_ == 3; }
+};
+
+/*
+ * Node48 maps each key byte to one of 48 child slots.
+ */
+struct AdaptiveRadixTree::Node48 : public Node {
+  static constexpr uint16_t CAPACITY = 48;
+  static constexpr uint8_t EMPTY = 48;
+
+  Node48(const uint8_t *prefix, uint32_t prefix_len) : Node(NodeType::NODE48, prefix, prefix_len) {
+    std::memset(child_index_, EMPTY, sizeof(child_index_));
+  }
+
+  auto IsFull() const -> bool { return count_ == CAPACITY; }
+  auto IsUnderfull() const -> bool { return count_ == 12; }
+
+  void Insert(uint8_t key, Node *child) {
+    uint8_t pos = count_;
+    if (children_[pos].load(std::memory_order_relaxed) != nullptr) {
+      // slot count_ is taken, so Remove freed one of the slots below it
+      pos = 0;
+      while (children_[pos].load(std::memory_order_relaxed) != nullptr) {
+        pos++;
+      }
+    }
+    children_[pos].store(child, std::memory_order_relaxed);
+    child_index_[key] = pos;
+    count_++;
+  }
+
+  auto GetChild(uint8_t key) const -> Node * {
+    uint8_t pos = child_index_[key];
+    return pos < CAPACITY ? children_[pos].load(std::memory_order_relaxed) : nullptr;
+  }
+
+  void Change(uint8_t key, Node *child) { children_[child_index_[key]].store(child, std::memory_order_relaxed); }
+
+  void Remove(uint8_t key) {
+    children_[child_index_[key]].store(nullptr, std::memory_order_relaxed);
+    child_index_[key] = EMPTY;
+    count_--;
+  }
+
+  template <typename N>
+  void CopyTo(N *other) const {
+    for (int key = 0; key < 256; key++) {
+      if (child_index_[key] != EMPTY) {
+        other->Insert(key, children_[child_index_[key]].load(std::memory_order_relaxed));
+      }
+    }
+  }
+
+  uint8_t child_index_[256];
+  std::atomic<Node *> children_[CAPACITY]{};
+};
+
+struct AdaptiveRadixTree::Node256 : public Node {
+  Node256(const uint8_t *prefix, uint32_t prefix_len) : Node(NodeType::NODE256, prefix, prefix_len) {}
+
+  auto IsFull() const -> bool { return false; }
+  auto IsUnderfull() const -> bool { return count_ == 37; }
+
+  void Insert(uint8_t key, Node *child) {
+    children_[key].store(child, std::memory_order_relaxed);
+    count_++;
+  }
+
+  void Remove(uint8_t key) {
+    children_[key].store(nullptr, std::memory_order_relaxed);
+    count_--;
+  }
+
+  template <typename N>
+  void CopyTo(N *other) const {
+    for (int key = 0; key < 256; key++) {
+      if (Node *child = children_[key].load(std::memory_order_relaxed); child != nullptr) {
+        other->Insert(key, child);
+      }
+    }
+  }
+
+  std::atomic<Node *> children_[256]{};
+};
+
+AdaptiveRadixTree::AdaptiveRadixTree() : root_(new Node256(nullptr, 0)) {}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() { DestroySubtree(root_); }
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+
+auto AdaptiveRadixTree::Lookup(const ArtKey &key, RID *value) const -> bool {
+  EpochManager::Guard guard(&epoch_manager_);
+  while (true) {
+    bool restart = false;
+    bool found = LookupOptimistic(key, value, &restart);
+    if (!restart) {
+      return found;
+    }
+  }
+}
+
+auto AdaptiveRadixTree::LookupOptimistic(const ArtKey &key, RID *value, bool *restart) const -> bool {
+  const Node *node = root_;
+  uint64_t version = node->ReadLockOrRestart(restart);
+  if (*restart) {
+    return false;
+  }
+
+  uint32_t level = 0;
+  while (true) {
+    if (!CheckPrefix(node, key, &level) || level >= key.Size()) {
+      node->CheckOrRestart(version, restart);
+      return false;
+    }
+    Node *child = GetChild(node, key[level]);
+    node->CheckOrRestart(version, restart);
+    if (*restart || child == nullptr) {
+      return false;
+    }
+    if (IsLeaf(child)) {
+      // leaves never change, and the epoch guard keeps this one alive even if it was removed by now
+      const Leaf *leaf = AsLeaf<Leaf>(child);
+      if (leaf->key_ == key) {
+        *value = leaf->value_;
+        return true;
+      }
+      return false;
+    }
+
+    level++;
+    uint64_t child_version = child->ReadLockOrRestart(restart);
+    node->CheckOrRestart(version, restart);
+    if (*restart) {
+      return false;
+    }
+    node = child;
+    version = child_version;
+  }
+}
+
+/*****************************************************************************
+ * RANGE SCAN
+ *****************************************************************************/
+
+void AdaptiveRadixTree::ScanRange(const std::optional<ArtKey> &low, bool low_inclusive,
+                                  const std::optional<ArtKey> &high, bool high_inclusive,
+                                  std::vector<RID> *result) const {
+  EpochManager::Guard guard(&epoch_manager_);
+  const ScanBounds bounds{low, low_inclusive, high, high_inclusive};
+  size_t start = result->size();
+  while (true) {
+    bool restart = false;
+    ScanOptimistic(root_, 0, low.has_value(), high.has_value(), bounds, result, &restart);
+    if (!restart) {
+      return;
+    }
+    result->resize(start);
+  }
+}
+
+void AdaptiveRadixTree::ScanOptimistic(const Node *node, uint32_t level, bool low_tight, bool high_tight,
+                                       const ScanBounds &bounds, std::vector<RID> *result, bool *restart) const {
+  uint64_t version = node->ReadLockOrRestart(restart);
+  if (*restart) {
+    return;
+  }
+
+  /*
+   * While the path equals a bound, the next byte decides: below the low bound (or above the high bound) the whole
+   * subtree is out of range, above it (or below) every key in the subtree is within that bound. A bound that is a
+   * prefix of the path is smaller than every key below.
+   */
+  enum class Side { BELOW, EQUAL, ABOVE };
+  auto compare = [&](const std::optional<ArtKey> &bound, uint32_t pos, uint8_t byte) {
+    if (pos >= bound->Size() || byte > (*bound)[pos]) {
+      return Side::ABOVE;
+    }
+    return byte < (*bound)[pos] ? Side::BELOW : Side::EQUAL;
+  };
+
+  uint32_t stored = std::min(node->prefix_len_, MAX_STORED_PREFIX);
+  for (uint32_t i = 0; i < stored && (low_tight || high_tight); i++) {
+    Side low_side = low_tight ? compare(bounds.low_, level + i, node->prefix_[i]) : Side::ABOVE;
+    Side high_side = high_tight ? compare(bounds.high_, level + i, node->prefix_[i]) : Side::BELOW;
+    if (low_side == Side::BELOW || high_side == Side::ABOVE) {
+      node->CheckOrRestart(version, restart);
+      return;
+    }
+    low_tight = low_side == Side::EQUAL;
+    high_tight = high_side == Side::EQUAL;
+  }
+  if (node->prefix_len_ > MAX_STORED_PREFIX) {
+    // the rest of the prefix is not stored, stop pruning and let the leaves be checked against the bounds
+    low_tight = false;
+    high_tight = false;
+  }
+  level += node->prefix_len_;
+
+  // Copy the children within the bounds in key order, then validate the copy before descending.
+  struct Visit {
+    Node *child_;
+    bool low_tight_;
+    bool high_tight_;
+  };
+  std::vector<Visit> visits;
+  auto visit = [&](uint8_t byte, Node *child) {
+    if (child == nullptr) {
+      return;
+    }
+    Side low_side = low_tight ? compare(bounds.low_, level, byte) : Side::ABOVE;
+    Side high_side = high_tight ? compare(bounds.high_, level, byte) : Side::BELOW;
+    if (low_side != Side::BELOW && high_side != Side::ABOVE) {
+      visits.push_back({child, low_side == Side::EQUAL, high_side == Side::EQUAL});
+    }
+  };
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      const auto *node4 = static_cast<const Node4 *>(node);
+      for (uint16_t i = 0; i < std::min<uint16_t>(node4->count_, 4); i++) {
+        visit(node4->keys_[i], node4->children_[i].load(std::memory_order_relaxed));
+      }
+      break;
+    }
+    case NodeType::NODE16: {
+      const auto *node16 = static_cast<const Node16 *>(node);
+      for (uint16_t i = 0; i < std::min<uint16_t>(node16->count_, 16); i++) {
+        visit(node16->keys_[i], node16->children_[i].load(std::memory_order_relaxed));
+      }
+      break;
+    }
+    case NodeType::NODE48:
+      for (int byte = 0; byte < 256; byte++) {
+        visit(byte, static_cast<const Node48 *>(node)->GetChild(byte));
+      }
+      break;
+    case NodeType::NODE256:
+      for (int byte = 0; byte < 256; byte++) {
+        visit(byte, static_cast<const Node256 *>(node)->children_[byte].load(std::memory_order_relaxed));
+      }
+      break;
+  }
+  node->CheckOrRestart(version, restart);
+  if (*restart) {
+    return;
+  }
+
+  for (const auto &[child, child_low_tight, child_high_tight] : visits) {
+    if (IsLeaf(child)) {
+      const Leaf *leaf = AsLeaf<Leaf>(child);
+      if (bounds.Contains(leaf->key_)) {
+        result->push_back(leaf->value_);
+      }
+      continue;
+    }
+    ScanOptimistic(child, level + 1, child_low_tight, child_high_tight, bounds, result, restart);
+    if (*restart) {
+      return;
+    }
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+
+auto AdaptiveRadixTree::Insert(const ArtKey &key, RID value) -> bool {
+  EpochManager::Guard guard(&epoch_manager_);
+  while (true) {
+    bool restart = false;
+    bool inserted = InsertOptimistic(key, value, &restart);
+    if (!restart) {
+      return inserted;
+    }
+  }
+}
+
+auto AdaptiveRadixTree::InsertOptimistic(const ArtKey &key, RID value, bool *restart) -> bool {
+  Node *node = nullptr;
+  Node *next_node = root_;
+  Node *parent = nullptr;
+  uint8_t parent_key = 0;
+  uint8_t node_key = 0;
+  uint64_t parent_version = 0;
+  uint32_t level = 0;
+
+  while (true) {
+    parent = node;
+    parent_key = node_key;
+    node = next_node;
+    uint64_t version = node->ReadLockOrRestart(restart);
+    if (*restart) {
+      return false;
+    }
+
+    uint32_t next_level = level;
+    uint8_t non_matching_key;
+    std::string remaining_prefix;
+    bool prefix_matches =
+        CheckPrefixPessimistic(node, key, &next_level, &non_matching_key, &remaining_prefix, restart);
+    if (*restart) {
+      return false;
+    }
+    if (!prefix_matches) {
+      // The key leaves the compressed prefix at next_level: put a Node4 above this node holding the common part.
+      parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+      node->UpgradeToWriteLockOrRestart(&version, restart);
+      if (*restart) {
+        parent->WriteUnlock();
+        return false;
+      }
+      auto *new_node = new Node4(node->prefix_, next_level - level);
+      new_node->Insert(key[next_level], LeafAsNode<Node>(new Leaf(key, value)));
+      new_node->Insert(non_matching_key, node);
+      Change(parent, parent_key, new_node);
+      parent->WriteUnlock();
+
+      node->SetPrefix(reinterpret_cast<const uint8_t *>(remaining_prefix.data()),
+                      node->prefix_len_ - (next_level - level + 1));
+      node->WriteUnlock();
+      return true;
+    }
+
+    level = next_level;
+    BUSTUB_ASSERT(level < key.Size(), "a key must not be a prefix of another key");
+    node_key = key[level];
+    next_node = GetChild(node, node_key);
+    node->CheckOrRestart(version, restart);
+    if (*restart) {
+      return false;
+    }
+
+    if (next_node == nullptr) {
+      InsertAndUnlock(node, version, parent, parent_version, parent_key, node_key,
+                      LeafAsNode<Node>(new Leaf(key, value)), restart);
+      return true;
+    }
+
+    if (parent != nullptr) {
+      parent->CheckOrRestart(parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+    }
+
+    if (IsLeaf(next_node)) {
+      const Leaf *existing = AsLeaf<Leaf>(next_node);
+      if (existing->key_ == key) {
+        node->CheckOrRestart(version, restart);
+        return false;
+      }
+      // Both keys share the bytes after this level up to some point, push them down into a new Node4.
+      node->UpgradeToWriteLockOrRestart(&version, restart);
+      if (*restart) {
+        return false;
+      }
+      uint32_t prefix_len = 0;
+      while (existing->key_[level + 1 + prefix_len] == key[level + 1 + prefix_len]) {
+        prefix_len++;
+        BUSTUB_ASSERT(level + 1 + prefix_len < key.Size(), "a key must not be a prefix of another key");
+      }
+      std::string prefix;
+      for (uint32_t i = 0; i < std::min(prefix_len, MAX_STORED_PREFIX); i++) {
+        prefix.push_back(static_cast<char>(key[level + 1 + i]));
+      }
+      auto *new_node = new Node4(reinterpret_cast<const uint8_t *>(prefix.data()), prefix_len);
+      new_node->Insert(key[level + 1 + prefix_len], LeafAsNode<Node>(new Leaf(key, value)));
+      new_node->Insert(existing->key_[level + 1 + prefix_len], next_node);
+      Change(node, node_key, new_node);
+      node->WriteUnlock();
+      return true;
+    }
+
+    level++;
+    parent_version = version;
+  }
+}
+
+void AdaptiveRadixTree::InsertAndUnlock(Node *node, uint64_t version, Node *parent, uint64_t parent_version,
+                                        uint8_t parent_key, uint8_t key, Node *child, bool *restart) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      InsertGrow<Node4, Node16>(static_cast<Node4 *>(node), version, parent, parent_version, parent_key, key, child,
+                                restart);
+      break;
+    case NodeType::NODE16:
+      InsertGrow<Node16, Node48>(static_cast<Node16 *>(node), version, parent, parent_version, parent_key, key,
+                                 child, restart);
+      break;
+    case NodeType::NODE48:
+      InsertGrow<Node48, Node256>(static_cast<Node48 *>(node), version, parent, parent_version, parent_key, key,
+                                  child, restart);
+      break;
+    case NodeType::NODE256:
+      InsertGrow<Node256, Node256>(static_cast<Node256 *>(node), version, parent, parent_version, parent_key, key,
+                                   child, restart);
+      break;
+  }
+  if (*restart) {
+    DeleteLeaf(AsLeaf<Leaf>(child));
+  }
+}
+
+template <typename CurNode, typename BiggerNode>
+void AdaptiveRadixTree::InsertGrow(CurNode *node, uint64_t version, Node *parent, uint64_t parent_version,
+                                   uint8_t parent_key, uint8_t key, Node *child, bool *restart) {
+  if (!node->IsFull()) {
+    if (parent != nullptr) {
+      parent->CheckOrRestart(parent_version, restart);
+      if (*restart) {
+        return;
+      }
+    }
+    node->UpgradeToWriteLockOrRestart(&version, restart);
+    if (*restart) {
+      return;
+    }
+    node->Insert(key, child);
+    node->WriteUnlock();
+    return;
+  }
+
+  // The node is full, replace it with a bigger copy. The root is a Node256 and never full, so there is a parent.
+  parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+  if (*restart) {
+    return;
+  }
+  node->UpgradeToWriteLockOrRestart(&version, restart);
+  if (*restart) {
+    parent->WriteUnlock();
+    return;
+  }
+  auto *bigger = new BiggerNode(node->prefix_, node->prefix_len_);
+  node->CopyTo(bigger);
+  bigger->Insert(key, child);
+  Change(parent, parent_key, bigger);
+  node->WriteUnlockObsolete();
+  epoch_manager_.Retire(node, DeleteNode);
+  parent->WriteUnlock();
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+
+auto AdaptiveRadixTree::Remove(const ArtKey &key, std::optional<RID> value) -> bool {
+  EpochManager::Guard guard(&epoch_manager_);
+  while (true) {
+    bool restart = false;
+    bool removed = RemoveOptimistic(key, value, &restart);
+    if (!restart) {
+      return removed;
+    }
+  }
+}
+
+auto AdaptiveRadixTree::RemoveOptimistic(const ArtKey &key, const std::optional<RID> &value, bool *restart)
+    -> bool {
+  Node *node = nullptr;
+  Node *next_node = root_;
+  Node *parent = nullptr;
+  uint8_t parent_key = 0;
+  uint8_t node_key = 0;
+  uint64_t parent_version = 0;
+  uint32_t level = 0;
+
+  while (true) {
+    parent = node;
+    parent_key = node_key;
+    node = next_node;
+    uint64_t version = node->ReadLockOrRestart(restart);
+    if (*restart) {
+      return false;
+    }
+
+    if (!CheckPrefix(node, key, &level) || level >= key.Size()) {
+      node->CheckOrRestart(version, restart);
+      return false;
+    }
+    node_key = key[level];
+    next_node = GetChild(node, node_key);
+    node->CheckOrRestart(version, restart);
+    if (*restart || next_node == nullptr) {
+      return false;
+    }
+
+    if (!IsLeaf(next_node)) {
+      level++;
+      parent_version = version;
+      continue;
+    }
+
+    // A leaf never changes, and the node is checked again once it is locked, so the leaf is still the one removed.
+    Leaf *leaf = AsLeaf<Leaf>(next_node);
+    if (!(leaf->key_ == key) || (value.has_value() && !(leaf->value_ == *value))) {
+      return false;
+    }
+
+    if (node->count_ == 2 && parent != nullptr) {
+      // Only one child is left after the removal, pull it up into the parent.
+      parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+      node->UpgradeToWriteLockOrRestart(&version, restart);
+      if (*restart) {
+        parent->WriteUnlock();
+        return false;
+      }
+      BUSTUB_ASSERT(node->type_ == NodeType::NODE4, "only a Node4 can be down to two children");
+      auto *node4 = static_cast<Node4 *>(node);
+      int second = node4->keys_[0] == node_key ? 1 : 0;
+      uint8_t second_key = node4->keys_[second];
+      Node *second_node = node4->children_[second].load(std::memory_order_relaxed);
+      if (IsLeaf(second_node)) {
+        Change(parent, parent_key, second_node);
+        parent->WriteUnlock();
+      } else {
+        second_node->WriteLockOrRestart(restart);
+        if (*restart) {
+          node->WriteUnlock();
+          parent->WriteUnlock();
+          return false;
+        }
+        Change(parent, parent_key, second_node);
+        parent->WriteUnlock();
+        second_node->AddPrefixBefore(node, second_key);
+        second_node->WriteUnlock();
+      }
+      node->WriteUnlockObsolete();
+      epoch_manager_.Retire(node, DeleteNode);
+    } else {
+      RemoveAndUnlock(node, version, parent, parent_version, parent_key, node_key, restart);
+      if (*restart) {
+        return false;
+      }
+    }
+    epoch_manager_.Retire(leaf, DeleteLeaf);
+    return true;
+  }
+}
+
+void AdaptiveRadixTree::RemoveAndUnlock(Node *node, uint64_t version, Node *parent, uint64_t parent_version,
+                                        uint8_t parent_key, uint8_t key, bool *restart) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      RemoveShrink<Node4, Node4>(static_cast<Node4 *>(node), version, parent, parent_version, parent_key, key,
+                                 restart);
+      break;
+    case NodeType::NODE16:
+      RemoveShrink<Node16, Node4>(static_cast<Node16 *>(node), version, parent, parent_version, parent_key, key,
+                                  restart);
+      break;
+    case NodeType::NODE48:
+      RemoveShrink<Node48, Node16>(static_cast<Node48 *>(node), version, parent, parent_version, parent_key, key,
+                                   restart);
+      break;
+    case NodeType::NODE256:
+      RemoveShrink<Node256, Node48>(static_cast<Node256 *>(node), version, parent, parent_version, parent_key, key,
+                                    restart);
+      break;
+  }
+}
+
+template <typename CurNode, typename SmallerNode>
+void AdaptiveRadixTree::RemoveShrink(CurNode *node, uint64_t version, Node *parent, uint64_t parent_version,
+                                     uint8_t parent_key, uint8_t key, bool *restart) {
+  if (!node->IsUnderfull() || parent == nullptr) {
+    if (parent != nullptr) {
+      parent->CheckOrRestart(parent_version, restart);
+      if (*restart) {
+        return;
+      }
+    }
+    node->UpgradeToWriteLockOrRestart(&version, restart);
+    if (*restart) {
+      return;
+    }
+    node->Remove(key);
+    node->WriteUnlock();
+    return;
+  }
+
+  // The node is underfull, replace it with a smaller copy.
+  parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+  if (*restart) {
+    return;
+  }
+  node->UpgradeToWriteLockOrRestart(&version, restart);
+  if (*restart) {
+    parent->WriteUnlock();
+    return;
+  }
+  auto *smaller = new SmallerNode(node->prefix_, node->prefix_len_);
+  node->CopyTo(smaller);
+  smaller->Remove(key);
+  Change(parent, parent_key, smaller);
+  node->WriteUnlockObsolete();
+  epoch_manager_.Retire(node, DeleteNode);
+  parent->WriteUnlock();
+}
+
+/*****************************************************************************
+ * NODE HELPERS
+ *****************************************************************************/
+
+auto AdaptiveRadixTree::GetChild(const Node *node, uint8_t key) -> Node * {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return static_cast<const Node4 *>(node)->GetChild(key);
+    case NodeType::NODE16:
+      return static_cast<const Node16 *>(node)->GetChild(key);
+    case NodeType::NODE48:
+      return static_cast<const Node48 *>(node)->GetChild(key);
+    case NodeType::NODE256:
+      return static_cast<const Node256 *>(node)->children_[key].load(std::memory_order_relaxed);
+  }
+  return nullptr;
+}
+
+void AdaptiveRadixTree::Change(Node *node, uint8_t key, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      static_cast<Node4 *>(node)->Change(key, child);
+      break;
+    case NodeType::NODE16:
+      static_cast<Node16 *>(node)->Change(key, child);
+      break;
+    case NodeType::NODE48:
+      static_cast<Node48 *>(node)->Change(key, child);
+      break;
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[key].store(child, std::memory_order_relaxed);
+      break;
+  }
+}
+
+auto AdaptiveRadixTree::AnyLeaf(const Node *node, bool *restart) -> const Leaf * {
+  while (!IsLeaf(node)) {
+    const Node *child = nullptr;
+    switch (node->type_) {
+      case NodeType::NODE4:
+        child = static_cast<const Node4 *>(node)->children_[0].load(std::memory_order_relaxed);
+        break;
+      case NodeType::NODE16:
+        child = static_cast<const Node16 *>(node)->children_[0].load(std::memory_order_relaxed);
+        break;
+      case NodeType::NODE48:
+        for (int i = 0; i < Node48::CAPACITY && child == nullptr; i++) {
+          child = static_cast<const Node48 *>(node)->children_[i].load(std::memory_order_relaxed);
+        }
+        break;
+      case NodeType::NODE256:
+        for (int i = 0; i < 256 && child == nullptr; i++) {
+          child = static_cast<const Node256 *>(node)->children_[i].load(std::memory_order_relaxed);
+        }
+        break;
+    }
+    if (child == nullptr) {
+      // the node was emptied concurrently
+      *restart = true;
+      return nullptr;
+    }
+    node = child;
+  }
+  return AsLeaf<Leaf>(node);
+}
+
+auto AdaptiveRadixTree::CheckPrefix(const Node *node, const ArtKey &key, uint32_t *level) -> bool {
+  uint32_t prefix_len = node->prefix_len_;
+  if (prefix_len == 0) {
+    return true;
+  }
+  if (*level + prefix_len >= key.Size()) {
+    return false;
+  }
+  // Bytes beyond the stored ones are not checked here, the full key is compared at the leaf.
+  for (uint32_t i = 0; i < std::min(prefix_len, MAX_STORED_PREFIX); i++) {
+    if (node->prefix_[i] != key[*level + i]) {
+      return false;
+    }
+  }
+  *level += prefix_len;
+  return true;
+}
+
+auto AdaptiveRadixTree::CheckPrefixPessimistic(const Node *node, const ArtKey &key, uint32_t *level,
+                                               uint8_t *non_matching_key, std::string *remaining_prefix,
+                                               bool *restart) -> bool {
+  uint32_t prefix_len = node->prefix_len_;
+  if (prefix_len == 0) {
+    return true;
+  }
+  uint32_t start = *level;
+  const Leaf *any_leaf = nullptr;
+  for (uint32_t i = 0; i < prefix_len; i++) {
+    if (i == MAX_STORED_PREFIX) {
+      any_leaf = AnyLeaf(node, restart);
+      if (*restart) {
+        return false;
+      }
+    }
+    uint8_t current = i < MAX_STORED_PREFIX ? node->prefix_[i] : any_leaf->key_[*level];
+    if (*level >= key.Size() || current != key[*level]) {
+      *non_matching_key = current;
+      // What is left of the prefix after the mismatching byte stays with the node.
+      if (prefix_len > MAX_STORED_PREFIX && any_leaf == nullptr) {
+        any_leaf = AnyLeaf(node, restart);
+        if (*restart) {
+          return false;
+        }
+      }
+      for (uint32_t j = i + 1; j < prefix_len && remaining_prefix->size() < MAX_STORED_PREFIX; j++) {
+        remaining_prefix->push_back(
+            static_cast<char>(any_leaf != nullptr ? any_leaf->key_[start + j] : node->prefix_[j]));
+      }
+      return false;
+    }
+    (*level)++;
+  }
+  return true;
+}
+
+void AdaptiveRadixTree::DeleteNode(void *node) {
+  auto *n = static_cast<Node *>(node);
+  switch (n->type_) {
+    case NodeType::NODE4:
+      delete static_cast<Node4 *>(n);
+      break;
+    case NodeType::NODE16:
+      delete static_cast<Node16 *>(n);
+      break;
+    case NodeType::NODE48:
+      delete static_cast<Node48 *>(n);
+      break;
+    case NodeType::NODE256:
+      delete static_cast<Node256 *>(n);
+      break;
+  }
+}
+
+void AdaptiveRadixTree::DeleteLeaf(void *leaf) { delete static_cast<Leaf *>(leaf); }
+
+void AdaptiveRadixTree::DestroySubtree(Node *node) {
+  if (IsLeaf(node)) {
+    DeleteLeaf(AsLeaf<Leaf>(node));
+    return;
+  }
+  auto visit = [](std::atomic<Node *> &child) {
+    if (Node *c = child.load(std::memory_order_relaxed); c != nullptr) {
+      DestroySubtree(c);
+    }
+  };
+  switch (node->type_) {
+    case NodeType::NODE4:
+      std::for_each(std::begin(static_cast<Node4 *>(node)->children_),
+                    std::begin(static_cast<Node4 *>(node)->children_) + node->count_, visit);
+      break;
+    case NodeType::NODE16:
+      std::for_each(std::begin(static_cast<Node16 *>(node)->children_),
+                    std::begin(static_cast<Node16 *>(node)->children_) + node->count_, visit);
+      break;
+    case NodeType::NODE48:
+      std::for_each(std::begin(static_cast<Node48 *>(node)->children_),
+                    std::end(static_cast<Node48 *>(node)->children_), visit);
+      break;
+    case NodeType::NODE256:
+      std::for_each(std::begin(static_cast<Node256 *>(node)->children_),
+                    std::end(static_cast<Node256 *>(node)->children_), visit);
+      break;
+  }
+  DeleteNode(node);
+}
+
+}  // namespace bustub
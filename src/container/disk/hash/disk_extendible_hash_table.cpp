@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -24,9 +27,40 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn, bool unique,
+                                         uint32_t header_max_depth, uint32_t directory_max_depth)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      unique_(unique),
+      directory_max_depth_(directory_max_depth),
+      hash_fn_(std::move(hash_fn)) {
+  assert((1U << directory_max_depth) <= DIRECTORY_ARRAY_SIZE);
+  // an empty table is a header of global depth 0 pointing at a single directory of global depth 0, which points at
+  // a single empty bucket
+  Page *header = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (header == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the header of hash table " + name);
+  }
+  page_id_t directory_page_id;
+  Page *dir = buffer_pool_manager_->NewPage(&directory_page_id);
+  if (dir == nullptr) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the directory of hash table " + name);
+  }
+  page_id_t bucket_page_id;
+  if (buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the first bucket of hash table " + name);
+  }
+  HeaderOf(header)->Init(header_page_id_, directory_page_id, header_max_depth);
+  auto *dir_page = DirectoryOf(dir);
+  dir_page->SetPageId(directory_page_id);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +80,47 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchHeaderPage() -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch hash table header page");
+  }
+  return page;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchDirectoryPage(page_id_t directory_page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY,
+                    "cannot fetch hash table directory page " + std::to_string(directory_page_id));
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchDirectoryPageOf(const KeyType &key, Page *header_page) -> Page * {
+  auto *header = HeaderOf(header_page);
+  return FetchDirectoryPage(header->GetDirectoryPageId(header->HashToDirectoryIndex(Hash(key))));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY,
+                    "cannot fetch hash table bucket page " + std::to_string(bucket_page_id));
+  }
+  return page;
 }
 
 /*****************************************************************************
@@ -69,7 +128,20 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  Page *dir = FetchDirectoryPageOf(key, header);
+  dir->RLatch();
+  Page *page = FetchBucketPage(KeyToPageId(key, DirectoryOf(dir)));
+  page->RLatch();
+  bool found = BucketOf(page)->GetValue(key, comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  dir->RUnlatch();
+  buffer_pool_manager_->UnpinPage(dir->GetPageId(), false);
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +149,213 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  Page *dir = FetchDirectoryPageOf(key, header);
+  dir->RLatch();
+  Page *page = FetchBucketPage(KeyToPageId(key, DirectoryOf(dir)));
+  page->WLatch();
+  auto inserted = InsertIntoBucket(BucketOf(page), key, value);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted.value_or(false));
+  dir->RUnlatch();
+  buffer_pool_manager_->UnpinPage(dir->GetPageId(), false);
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (inserted.has_value()) {
+    return *inserted;
+  }
+  return SplitInsert(transaction, key, value);
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::InsertIntoBucket(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value)
+    -> std::optional<bool> {
+  if (unique_ || bucket->IsFull()) {
+    std::vector<ValueType> values;
+    bucket->GetValue(key, comparator_, &values);
+    if (unique_ && !values.empty()) {
+      return false;
+    }
+    if (std::find(values.begin(), values.end(), value) != values.end()) {
+      return false;
+    }
+    if (bucket->IsFull()) {
+      return std::nullopt;
+    }
+  }
+  return bucket->Insert(key, value, comparator_);
+}
+
+/*
+ * Another insert may have split the bucket between releasing the read latch
+ * and taking the write latch, so the bucket is looked up again, and split as
+ * often as it takes for the key to find room. Once its directory cannot grow
+ * any more, the directory itself is split and the insert starts over.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  while (true) {
+    Page *header = FetchHeaderPage();
+    header->RLatch();
+    Page *dir = FetchDirectoryPageOf(key, header);
+    dir->WLatch();
+    auto *dir_page = DirectoryOf(dir);
+    bool dir_dirty = false;
+    std::optional<bool> inserted;
+    while (true) {
+      uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+      Page *page = FetchBucketPage(dir_page->GetBucketPageId(bucket_idx));
+      inserted = InsertIntoBucket(BucketOf(page), key, value);
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted.value_or(false));
+      if (inserted.has_value() || !SplitBucket(dir_page, bucket_idx)) {
+        break;
+      }
+      dir_dirty = true;
+    }
+    dir->WUnlatch();
+    buffer_pool_manager_->UnpinPage(dir->GetPageId(), dir_dirty);
+    header->RUnlatch();
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    if (inserted.has_value()) {
+      return *inserted;
+    }
+    SplitDirectory(key);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::SplitBucket(HashTableDirectoryPage *dir_page, uint32_t bucket_idx) -> bool {
+  if (dir_page->GetLocalDepth(bucket_idx) == dir_page->GetGlobalDepth()) {
+    if (dir_page->GetGlobalDepth() >= directory_max_depth_) {
+      return false;
+    }
+    dir_page->IncrGlobalDepth();
+  }
+
+  page_id_t old_page_id = dir_page->GetBucketPageId(bucket_idx);
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate hash table bucket page");
+  }
+  Page *old_page = FetchBucketPage(old_page_id);
+
+  // The slots of the old bucket agree on the hash bits below its local depth. The next bit decides which of them,
+  // and which of its keys, move to the new bucket.
+  uint32_t split_bit = 1U << dir_page->GetLocalDepth(bucket_idx);
+  for (uint32_t i = 0; i < dir_page->Size(); i++) {
+    if (dir_page->GetBucketPageId(i) == old_page_id) {
+      dir_page->IncrLocalDepth(i);
+      if ((i & split_bit) != 0) {
+        dir_page->SetBucketPageId(i, new_page_id);
+      }
+    }
+  }
+  MoveBucketPairs(BucketOf(old_page), BucketOf(new_page), split_bit);
+  buffer_pool_manager_->UnpinPage(old_page_id, true);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MoveBucketPairs(HASH_TABLE_BUCKET_TYPE *from, HASH_TABLE_BUCKET_TYPE *to, uint32_t hash_bit) {
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && from->IsOccupied(i); i++) {
+    if (from->IsReadable(i) && (Hash(from->KeyAt(i)) & hash_bit) != 0) {
+      to->Insert(from->KeyAt(i), from->ValueAt(i), comparator_);
+      from->RemoveAt(i);
+    }
+  }
+}
+
+/*
+ * The header is write latched, which keeps every other thread out of the
+ * whole table, so the pages below it are used without latches.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::SplitDirectory(const KeyType &key) {
+  Page *header = FetchHeaderPage();
+  header->WLatch();
+  auto *header_page = HeaderOf(header);
+  uint32_t hash = Hash(key);
+  uint32_t directory_idx = header_page->HashToDirectoryIndex(hash);
+  page_id_t old_dir_id = header_page->GetDirectoryPageId(directory_idx);
+  Page *old_dir = FetchDirectoryPage(old_dir_id);
+  auto *old_dir_page = DirectoryOf(old_dir);
+
+  // another insert may have split the directory, or a remove may have emptied the bucket, in the meantime
+  uint32_t bucket_idx = KeyToDirectoryIndex(key, old_dir_page);
+  bool split = old_dir_page->GetLocalDepth(bucket_idx) >= directory_max_depth_;
+  if (split) {
+    Page *page = FetchBucketPage(old_dir_page->GetBucketPageId(bucket_idx));
+    split = BucketOf(page)->IsFull();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  if (split && header_page->GetLocalDepth(directory_idx) == header_page->GetGlobalDepth()) {
+    if (header_page->GetGlobalDepth() >= header_page->GetMaxDepth()) {
+      buffer_pool_manager_->UnpinPage(old_dir_id, false);
+      header->WUnlatch();
+      buffer_pool_manager_->UnpinPage(header_page_id_, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "hash table directory is full");
+    }
+    header_page->IncrGlobalDepth();
+  }
+  if (!split) {
+    buffer_pool_manager_->UnpinPage(old_dir_id, false);
+    header->WUnlatch();
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return;
+  }
+
+  page_id_t new_dir_id;
+  Page *new_dir = buffer_pool_manager_->NewPage(&new_dir_id);
+  if (new_dir == nullptr) {
+    buffer_pool_manager_->UnpinPage(old_dir_id, false);
+    header->WUnlatch();
+    buffer_pool_manager_->UnpinPage(header_page_id_, true);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate hash table directory page");
+  }
+  std::memcpy(new_dir->GetData(), old_dir->GetData(), BUSTUB_PAGE_SIZE);
+  auto *new_dir_page = DirectoryOf(new_dir);
+  new_dir_page->SetPageId(new_dir_id);
+
+  // The keys of the old directory agree on the top bits of their hash up to its local depth. The next bit decides
+  // which of them move to the new directory, whichever bucket they are in.
+  uint32_t local_depth = header_page->GetLocalDepth(directory_idx);
+  uint32_t split_bit = 1U << (31 - local_depth);
+  std::unordered_map<page_id_t, page_id_t> images;
+  for (uint32_t i = 0; i < old_dir_page->Size(); i++) {
+    page_id_t old_page_id = old_dir_page->GetBucketPageId(i);
+    auto image = images.find(old_page_id);
+    if (image == images.end()) {
+      page_id_t new_page_id;
+      Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+      if (new_page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate hash table bucket page");
+      }
+      Page *old_page = FetchBucketPage(old_page_id);
+      MoveBucketPairs(BucketOf(old_page), BucketOf(new_page), split_bit);
+      buffer_pool_manager_->UnpinPage(old_page_id, true);
+      buffer_pool_manager_->UnpinPage(new_page_id, true);
+      image = images.emplace(old_page_id, new_page_id).first;
+    }
+    new_dir_page->SetBucketPageId(i, image->second);
+  }
+
+  // header slot bits below the global depth are hash bits below the top, so that bit sits this far from the bottom
+  uint32_t slot_shift = header_page->GetGlobalDepth() - 1 - local_depth;
+  for (uint32_t i = 0; i < header_page->Size(); i++) {
+    if (header_page->GetDirectoryPageId(i) == old_dir_id) {
+      header_page->IncrLocalDepth(i);
+      if (((i >> slot_shift) & 1) != 0) {
+        header_page->SetDirectoryPageId(i, new_dir_id);
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(new_dir_id, true);
+  buffer_pool_manager_->UnpinPage(old_dir_id, false);
+  header->WUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*****************************************************************************
@@ -90,38 +363,152 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  Page *dir = FetchDirectoryPageOf(key, header);
+  dir->RLatch();
+  Page *page = FetchBucketPage(KeyToPageId(key, DirectoryOf(dir)));
+  page->WLatch();
+  auto *bucket = BucketOf(page);
+  bool removed = bucket->Remove(key, value, comparator_);
+  bool empty = bucket->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+  dir->RUnlatch();
+  buffer_pool_manager_->UnpinPage(dir->GetPageId(), false);
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
+/*
+ * The bucket is looked up again under the write latch, an insert may have
+ * filled it, or another merge may have changed its depth, in the meantime.
+ * Merging goes on with the merged bucket and its new split image for as long
+ * as one of the two is empty, so a bucket that emptied while its image was
+ * split deeper still gets merged once the image is merged back.
+ *
+ * Merges stay within the directory page of the key. A split directory page is
+ * never merged back, it shrinks to a single bucket at worst.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  Page *dir = FetchDirectoryPageOf(key, header);
+  dir->WLatch();
+  auto *dir_page = DirectoryOf(dir);
+  uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+  bool dir_dirty = false;
+  while (true) {
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    if (!IsBucketEmpty(page_id)) {
+      if (!IsBucketEmpty(image_page_id)) {
+        break;
+      }
+      std::swap(page_id, image_page_id);
+    }
+
+    // the empty bucket is dropped, its slots point at the other one from now on
+    for (uint32_t i = 0; i < dir_page->Size(); i++) {
+      page_id_t slot_page_id = dir_page->GetBucketPageId(i);
+      if (slot_page_id == page_id || slot_page_id == image_page_id) {
+        dir_page->SetBucketPageId(i, image_page_id);
+        dir_page->DecrLocalDepth(i);
+      }
+    }
+    buffer_pool_manager_->DeletePage(page_id);
+    dir_dirty = true;
+  }
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+  }
+  dir->WUnlatch();
+  buffer_pool_manager_->UnpinPage(dir->GetPageId(), dir_dirty);
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsBucketEmpty(page_id_t bucket_page_id) -> bool {
+  Page *page = FetchBucketPage(bucket_page_id);
+  bool empty = BucketOf(page)->IsEmpty();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  return empty;
+}
 
 /*****************************************************************************
- * GETGLOBALDEPTH - DO NOT TOUCH
+ * GETGLOBALDEPTH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
-  table_latch_.RUnlock();
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  auto *header_page = HeaderOf(header);
+  uint32_t global_depth = 0;
+  // the slots of a directory are next to each other
+  page_id_t last_dir_id = INVALID_PAGE_ID;
+  for (uint32_t i = 0; i < header_page->Size(); i++) {
+    if (header_page->GetDirectoryPageId(i) == last_dir_id) {
+      continue;
+    }
+    last_dir_id = header_page->GetDirectoryPageId(i);
+    Page *dir = FetchDirectoryPage(last_dir_id);
+    dir->RLatch();
+    global_depth = std::max(global_depth, DirectoryOf(dir)->GetGlobalDepth());
+    dir->RUnlatch();
+    buffer_pool_manager_->UnpinPage(dir->GetPageId(), false);
+  }
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return global_depth;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetHeaderGlobalDepth() -> uint32_t {
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  uint32_t global_depth = HeaderOf(header)->GetGlobalDepth();
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   return global_depth;
 }
 
 /*****************************************************************************
- * VERIFY INTEGRITY - DO NOT TOUCH
+ * VERIFY INTEGRITY
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
-  table_latch_.RUnlock();
+  Page *header = FetchHeaderPage();
+  header->RLatch();
+  auto *header_page = HeaderOf(header);
+  header_page->VerifyIntegrity();
+  page_id_t last_dir_id = INVALID_PAGE_ID;
+  for (uint32_t i = 0; i < header_page->Size(); i++) {
+    if (header_page->GetDirectoryPageId(i) == last_dir_id) {
+      continue;
+    }
+    last_dir_id = header_page->GetDirectoryPageId(i);
+    Page *dir = FetchDirectoryPage(last_dir_id);
+    dir->RLatch();
+    DirectoryOf(dir)->VerifyIntegrity();
+    dir->RUnlatch();
+    buffer_pool_manager_->UnpinPage(dir->GetPageId(), false);
+  }
+  header->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
 }
 
 /*****************************************************************************
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,46 +25,356 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+LINEAR_PROBE_HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+                                      HashFunction<KeyType> hash_fn, bool unique)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      unique_(unique),
+      hash_fn_(std::move(hash_fn)) {
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the header of hash table " + name);
+  }
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header_page->SetPageId(header_page_id_);
+  header_page->SetOldHeaderPageId(INVALID_PAGE_ID);
+  size_t num_blocks = std::max<size_t>(1, (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE);
+  CreateNewBlockPages(header_page, std::min(num_blocks, HashTableHeaderPage::MaxNumBlocks()));
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage * {
+  Page *page = buffer_pool_manager_->FetchPage(header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch hash table header page");
+  }
+  return reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE * {
+  Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY,
+                    "cannot fetch hash table block page " + std::to_string(block_page_id));
+  }
+  return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    header_page->AddBlockPageId(INVALID_PAGE_ID);
+  }
+  header_page->SetSize(header_page->NumBlocks() * BLOCK_ARRAY_SIZE);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+void LINEAR_PROBE_HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header_page, size_t skip_blocks, const KeyType &key,
+                                         Visitor &&visit) {
+  size_t size = header_page->GetSize();
+  size_t num_blocks = header_page->NumBlocks();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  for (size_t probed = 0; probed < size;) {
+    size_t block_ind = slot / BLOCK_ARRAY_SIZE;
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    size_t next_slot = (block_ind + 1) % num_blocks * BLOCK_ARRAY_SIZE;
+    if (block_ind < skip_blocks) {
+      probed += BLOCK_ARRAY_SIZE - offset;
+      slot = next_slot;
+      continue;
+    }
+    page_id_t block_page_id = header_page->GetBlockPageId(block_ind);
+    if (block_page_id == INVALID_PAGE_ID) {
+      visit(nullptr, slot);
+      return;
+    }
+    auto *block = GetBlockPage(block_page_id);
+    bool stop = false;
+    for (; offset < BLOCK_ARRAY_SIZE && probed < size && !stop; offset++, probed++) {
+      stop = visit(block, block_ind * BLOCK_ARRAY_SIZE + offset) || !block->IsOccupied(offset);
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    if (stop) {
+      return;
+    }
+    slot = next_slot;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Contains(HashTableHeaderPage *header_page, size_t skip_blocks, const KeyType &key,
+                                            const ValueType *value) -> bool {
+  bool found = false;
+  Probe(header_page, skip_blocks, key, [&](HASH_TABLE_BLOCK_TYPE *block, size_t slot) {
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    found = block != nullptr && block->IsReadable(offset) && comparator_(key, block->KeyAt(offset)) == 0 &&
+            (value == nullptr || block->ValueAt(offset) == *value);
+    return found;
+  });
+  return found;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                            std::vector<ValueType> *result) -> bool {
+  table_latch_.RLock();
+  bool found = GetValueLatchFree(transaction, key, result);
+  table_latch_.RUnlock();
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetValueLatchFree(Transaction *transaction, const KeyType &key,
+                                                     std::vector<ValueType> *result) -> bool {
+  bool found = false;
+  auto collect = [&](HASH_TABLE_BLOCK_TYPE *block, size_t slot) {
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    if (block != nullptr && block->IsReadable(offset) && comparator_(key, block->KeyAt(offset)) == 0) {
+      result->push_back(block->ValueAt(offset));
+      found = true;
+    }
+    return false;
+  };
+  HashTableHeaderPage *header_page = GetHeaderPage(header_page_id_);
+  Probe(header_page, 0, key, collect);
+  // the pairs that were not moved yet are still in the old table
+  page_id_t old_header_page_id = header_page->GetOldHeaderPageId();
+  if (old_header_page_id != INVALID_PAGE_ID) {
+    Probe(GetHeaderPage(old_header_page_id), header_page->GetMigratedBlocks(), key, collect);
+    buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return found;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value)
+    -> bool {
+  table_latch_.WLock();
+  HashTableHeaderPage *header_page = GetHeaderPage(header_page_id_);
+  MigrateBlocks(header_page, MIGRATE_BLOCKS_PER_WRITE);
+
+  const ValueType *match = unique_ ? nullptr : &value;
+  bool exists = Contains(header_page, 0, key, match);
+  page_id_t old_header_page_id = header_page->GetOldHeaderPageId();
+  if (!exists && old_header_page_id != INVALID_PAGE_ID) {
+    exists = Contains(GetHeaderPage(old_header_page_id), header_page->GetMigratedBlocks(), key, match);
+    buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  }
+  if (!exists) {
+    if (static_cast<double>(header_page->GetNumOccupied() + 1) > MAX_LOAD_FACTOR * header_page->GetSize()) {
+      try {
+        auto *new_header_page = StartResize(header_page, 2 * header_page->GetSize());
+        buffer_pool_manager_->UnpinPage(header_page->GetPageId(), true);
+        header_page = new_header_page;
+      } catch (Exception &e) {
+        buffer_pool_manager_->UnpinPage(header_page_id_, true);
+        table_latch_.WUnlock();
+        throw;
+      }
+    }
+    ResizeInsert(header_page, key, value);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  table_latch_.WUnlock();
+  return !exists;
+}
+
+/*
+ * Tombstones are never taken again, so the pair goes into the first slot of
+ * its probe sequence that was never occupied.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key,
+                                                const ValueType &value) {
+  std::optional<size_t> free_slot;
+  bool allocate = false;
+  Probe(header_page, 0, key, [&](HASH_TABLE_BLOCK_TYPE *block, size_t slot) {
+    if (block == nullptr || !block->IsOccupied(slot % BLOCK_ARRAY_SIZE)) {
+      free_slot = slot;
+      allocate = block == nullptr;
+    }
+    return free_slot.has_value();
+  });
+  if (!free_slot.has_value()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "hash table is full");
+  }
+
+  size_t block_ind = *free_slot / BLOCK_ARRAY_SIZE;
+  page_id_t block_page_id = header_page->GetBlockPageId(block_ind);
+  HASH_TABLE_BLOCK_TYPE *block;
+  if (allocate) {
+    Page *page = buffer_pool_manager_->NewPage(&block_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate hash table block page");
+    }
+    header_page->SetBlockPageId(block_ind, block_page_id);
+    block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+  } else {
+    block = GetBlockPage(block_page_id);
+  }
+  block->Insert(*free_slot % BLOCK_ARRAY_SIZE, key, value);
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+  header_page->SetNumOccupied(header_page->GetNumOccupied() + 1);
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value)
+    -> bool {
+  table_latch_.WLock();
+  HashTableHeaderPage *header_page = GetHeaderPage(header_page_id_);
+  MigrateBlocks(header_page, MIGRATE_BLOCKS_PER_WRITE);
+
+  bool removed = RemoveFrom(header_page, 0, key, value);
+  page_id_t old_header_page_id = header_page->GetOldHeaderPageId();
+  if (!removed && old_header_page_id != INVALID_PAGE_ID) {
+    auto *old_header_page = GetHeaderPage(old_header_page_id);
+    removed = RemoveFrom(old_header_page, header_page->GetMigratedBlocks(), key, value);
+    buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  table_latch_.WUnlock();
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::RemoveFrom(HashTableHeaderPage *header_page, size_t skip_blocks, const KeyType &key,
+                                              const ValueType &value) -> bool {
+  std::optional<size_t> pair_slot;
+  Probe(header_page, skip_blocks, key, [&](HASH_TABLE_BLOCK_TYPE *block, size_t slot) {
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    if (block != nullptr && block->IsReadable(offset) && comparator_(key, block->KeyAt(offset)) == 0 &&
+        block->ValueAt(offset) == value) {
+      pair_slot = slot;
+    }
+    return pair_slot.has_value();
+  });
+  if (!pair_slot.has_value()) {
+    return false;
+  }
+  page_id_t block_page_id = header_page->GetBlockPageId(*pair_slot / BLOCK_ARRAY_SIZE);
+  GetBlockPage(block_page_id)->Remove(*pair_slot % BLOCK_ARRAY_SIZE);
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+  return true;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void LINEAR_PROBE_HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  HashTableHeaderPage *header_page = GetHeaderPage(header_page_id_);
+  try {
+    auto *new_header_page = StartResize(header_page, 2 * initial_size);
+    buffer_pool_manager_->UnpinPage(header_page->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(new_header_page->GetPageId(), true);
+  } catch (Exception &e) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, true);
+    table_latch_.WUnlock();
+    throw;
+  }
+  table_latch_.WUnlock();
+}
+
+/*
+ * Only the header of the new table is written here, its blocks are allocated
+ * as pairs land in them, and the pairs of the old table are moved over by the
+ * inserts and removes that follow.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::StartResize(HashTableHeaderPage *header_page, size_t num_slots)
+    -> HashTableHeaderPage * {
+  MigrateBlocks(header_page, header_page->NumBlocks());
+  size_t num_blocks = (num_slots + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE;
+  if (num_blocks > HashTableHeaderPage::MaxNumBlocks()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "hash table is full");
+  }
+  page_id_t new_header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&new_header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate hash table header page");
+  }
+  auto *new_header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  new_header_page->SetPageId(new_header_page_id);
+  new_header_page->SetOldHeaderPageId(header_page_id_);
+  CreateNewBlockPages(new_header_page, std::max(num_blocks, header_page->NumBlocks()));
+  header_page_id_ = new_header_page_id;
+  return new_header_page;
+}
+
+/*
+ * Blocks are moved front to back. Pairs that were probed past the end of a
+ * moved block stay where they are until their own block is moved, and are
+ * still found, since probes of the old table step over the moved blocks.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::MigrateBlocks(HashTableHeaderPage *header_page, size_t num_blocks) {
+  page_id_t old_header_page_id = header_page->GetOldHeaderPageId();
+  if (old_header_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto *old_header_page = GetHeaderPage(old_header_page_id);
+  for (size_t i = 0; i < num_blocks && header_page->GetMigratedBlocks() < old_header_page->NumBlocks(); i++) {
+    size_t block_ind = header_page->GetMigratedBlocks();
+    page_id_t block_page_id = old_header_page->GetBlockPageId(block_ind);
+    if (block_page_id != INVALID_PAGE_ID) {
+      auto *block = GetBlockPage(block_page_id);
+      // tombstones are left behind
+      for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+        if (block->IsReadable(offset)) {
+          ResizeInsert(header_page, block->KeyAt(offset), block->ValueAt(offset));
+        }
+      }
+      buffer_pool_manager_->UnpinPage(block_page_id, false);
+      buffer_pool_manager_->DeletePage(block_page_id);
+    }
+    header_page->SetMigratedBlocks(block_ind + 1);
+  }
+  bool done = header_page->GetMigratedBlocks() == old_header_page->NumBlocks();
+  buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  if (done) {
+    buffer_pool_manager_->DeletePage(old_header_page_id);
+    header_page->SetOldHeaderPageId(INVALID_PAGE_ID);
+    header_page->SetMigratedBlocks(0);
+  }
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetSize() -> size_t {
+  table_latch_.RLock();
+  size_t size = GetHeaderPage(header_page_id_)->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::IsResizing() -> bool {
+  table_latch_.RLock();
+  bool resizing = GetHeaderPage(header_page_id_)->GetOldHeaderPageId() != INVALID_PAGE_ID;
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return resizing;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -10,10 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include <cassert>
-#include <cstdlib>
+#include <algorithm>
 #include <functional>
 #include <list>
+#include <mutex>  // NOLINT
 #include <utility>
 
 #include "container/hash/extendible_hash_table.h"
@@ -22,20 +22,20 @@
 namespace bustub {
 
 template <typename K, typename V>
-ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size): global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {
-      std::shared_ptr new_bucket(new Bucket(bucket_size));
-      dir_.push_back(new_bucket);
-    }
+ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
+    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {
+  dir_.push_back(std::make_shared<Bucket>(bucket_size));
+}
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
+auto ExtendibleHashTable<K, V>::IndexOf(const K &key) const -> size_t {
   int mask = (1 << global_depth_) - 1;
   return std::hash<K>()(key) & mask;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock lock(latch_);
   return GetGlobalDepthInternal();
 }
 
@@ -46,7 +46,7 @@ auto ExtendibleHashTable<K, V>::GetGlobalDepthInternal() const -> int {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock lock(latch_);
   return GetLocalDepthInternal(dir_index);
 }
 
@@ -57,7 +57,7 @@ auto ExtendibleHashTable<K, V>::GetLocalDepthInternal(int dir_index) const -> in
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock lock(latch_);
   return GetNumBucketsInternal();
 }
 
@@ -67,148 +67,126 @@ auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
 }
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetBucketsSize() const -> int{
-  return GetBucketsSizeInternal();
-}
-
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetBucketsSizeInternal() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return bucket_size_;
+auto ExtendibleHashTable<K, V>::GetBucketsSize() const -> int {
+  return static_cast<int>(bucket_size_);
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if( GetNumBucketsInternal() == 0 ){ //hashtable is empty, perhaps it's not gonna happen
-    return false;
-  }
-
-  size_t hash_val = IndexOf(key);  
-  std::shared_ptr<Bucket> cur = dir_[hash_val];
-  return cur->Find(key,value);
+  std::shared_lock lock(latch_);
+  const auto &bucket = dir_[IndexOf(key)];
+  std::shared_lock bucket_lock(bucket->GetLatch());
+  return bucket->Find(key, value);
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if( GetNumBucketsInternal() == 0 ){ //hashtable is empty, perhaps it's not gonna happen
-    return false;
-  }
-
-  size_t hash_val = IndexOf(key);
-  std::shared_ptr<Bucket> cur = dir_[hash_val];
-  if( cur->Find(key, value) ){
-    return cur->remove(key, value);
-  }
-
-  return false;
-  // UNREACHABLE("not implemented");
+  std::shared_lock lock(latch_);
+  const auto &bucket = dir_[IndexOf(key)];
+  std::scoped_lock bucket_lock(bucket->GetLatch());
+  return bucket->Remove(key);
 }
 
 template <typename K, typename V>
 void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
-  std::scoped_lock<std::mutex> lock(latch_);
-  size_t hash_val = IndexOf(key);
-  const Bucket* cur = dir_[hash_val]->get();
-  if( !cur->Insert(key,value) ) {  //try to insert
-    if( cur->IsFull() ){
-      if( cur->GetDepth < GetGlobalDepthInternal() ){ //split on busket level
-        cur->IncrementDepth();
-        std::shared_ptr<Bucket> new_busket = new Bucket( GetBucketsSizeInternal(), cur->GetDepth());
-        std::shared_ptr<Bucket> replaced_busket = new Bucket( GetBucketsSizeInternal(), cur->GetDepth());
-        dir_[hash_val] = new_busket;
-
-        if( (hash_val) % 2 ){
-          dir_[hash_val+1] = replaced_busket;
-        } else {
-          dir_[hash_val-1] = replaced_busket;
-        }
-
-        RedistributeBucket(cur);
-        dir_[hash_val]->Insert(key,value);
-      } else { //split on table level
-        global_depth_++;
-        cur->IncrementDepth();
-        std::vector<std::shared_ptr<Bucket>> new_dir_;
-        size_t old_hash_val = hash_val;
-        for( int i = 0; i < pow(2,GetGlobalDepthInternal);i+=2 ) {
-          if( i/2 == old_hash_val ){
-            std::shared_ptr<Bucket> new_busket = new Bucket( GetBucketsSizeInternal(), cur->GetDepth());
-            std::shared_ptr<Bucket> replaced_busket = new Bucket( GetBucketsSizeInternal(), cur->GetDepth());
-            new_dir_.push_back(new_busket);
-            new_dir_.push_back(replaced_busket);
-            RedistributeBucket(cur);
-            hash_val = IndexOf(key);
-            new_dir_[hash_val]->Insert(key,value);
-          }
-          new_dir_.push_back(dir_[i/2]);
-          new_dir_.push_back(dir_[i/2]);
-        }
+  {
+    std::shared_lock lock(latch_);
+    const auto &bucket = dir_[IndexOf(key)];
+    std::scoped_lock bucket_lock(bucket->GetLatch());
+    if (bucket->Insert(key, value)) {
+      return;
+    }
+  }
+
+  // The bucket is full. Nobody else can look at any bucket while the directory is latched exclusively, so the
+  // buckets need no latches of their own here. Another insert may have split the bucket in between, hence the loop.
+  std::scoped_lock lock(latch_);
+  while (true) {
+    auto bucket = dir_[IndexOf(key)];
+    if (bucket->Insert(key, value)) {
+      return;
+    }
+    if (bucket->GetDepth() == global_depth_) {
+      size_t dir_size = dir_.size();
+      dir_.reserve(2 * dir_size);
+      for (size_t i = 0; i < dir_size; i++) {
+        dir_.push_back(dir_[i]);
       }
-      num_buckets_++;  //change the num of buckets;
-    }   
+      global_depth_++;
+    }
+    RedistributeBucket(bucket);
   }
-  // UNREACHABLE("not implemented");
 }
 
 template <typename K, typename V>
-auto RedistributeBucket(std::shared_ptr<ExtendibleHashTable<K, V>::Bucket> bucket) -> void{
-  for( auto i:bucket->GetItems()){ 
-    size_t hash_val = IndexOf(key);
-    dir_[hash_val]->Insert(key,value);
+auto ExtendibleHashTable<K, V>::RedistributeBucket(const std::shared_ptr<Bucket> &bucket) -> void {
+  size_t high_bit = static_cast<size_t>(1) << bucket->GetDepth();
+  bucket->IncrementDepth();
+  auto image = std::make_shared<Bucket>(bucket_size_, bucket->GetDepth());
+  num_buckets_++;
+
+  auto &items = bucket->GetItems();
+  auto split = std::partition(items.begin(), items.end(),
+                              [&](const auto &item) { return (std::hash<K>()(item.first) & high_bit) == 0; });
+  for (auto it = split; it != items.end(); ++it) {
+    image->GetItems().push_back(std::move(*it));
+  }
+  items.erase(split, items.end());
+
+  for (size_t i = 0; i < dir_.size(); i++) {
+    if (dir_[i] == bucket && (i & high_bit) != 0) {
+      dir_[i] = image;
+    }
   }
-  return;
 }
 
 //===--------------------------------------------------------------------===//
 // Bucket
 //===--------------------------------------------------------------------===//
 template <typename K, typename V>
-ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(array_size), depth_(depth) {}
+ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(array_size), depth_(depth) {
+  items_.reserve(array_size);
+}
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
-  for( auto i : list_ ){
-    if( i.first == key ){
-      value = i.second;
+auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) const -> bool {
+  for (const auto &[item_key, item_value] : items_) {
+    if (item_key == key) {
+      value = item_value;
       return true;
     }
   }
-  return false
+  return false;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
-  for( std::list<std::pair<K, V>>::iterator iter = list_.begin(); iter != list_.end(); )
-  {
-    if( iter->first == key ){
-      list_.erase(iter);
+  for (auto &item : items_) {
+    if (item.first == key) {
+      // the order of a bucket does not matter, so fill the hole with the last pair
+      if (&item != &items_.back()) {
+        item = std::move(items_.back());
+      }
+      items_.pop_back();
       return true;
     }
-      else
-        iter++;
   }
   return false;
-  // UNREACHABLE("not implemented");
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
-  if( IsFull() ){
-    reutrn false;
-  }
-
-  for( auto& i : list_ ){
-    if( i.first == key ){
-      i.second = value;
+  for (auto &item : items_) {
+    if (item.first == key) {
+      item.second = value;
       return true;
     }
   }
-
-  list_.emplace(list_.end(),std::move(std::pair<K,V>{key,value}));
+  if (IsFull()) {
+    return false;
+  }
+  items_.emplace_back(key, value);
   return true;
-
 }
 
 template class ExtendibleHashTable<page_id_t, Page *>;
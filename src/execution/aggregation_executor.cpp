@@ -9,42 +9,386 @@
 // Copyright (c) 2015-2021, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "common/exception.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/parallel_pipeline.h"
+#include "type/limits.h"
 
 namespace bustub {
 
+namespace {
+
+/** Which field of an AggregateSlot holds the sum, minimum or maximum of an input type */
+enum class SlotType { Integer, Decimal, Value };
+
+auto SlotTypeOf(TypeId type) -> SlotType {
+  switch (type) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+      return SlotType::Integer;
+    case TypeId::DECIMAL:
+      return SlotType::Decimal;
+    default:
+      return SlotType::Value;
+  }
+}
+
+/** @return The sum of two integers, which throws as Value::Add() does if it overflows */
+auto AddChecked(int64_t sum, int64_t value) -> int64_t {
+  if ((value > 0 && sum > BUSTUB_INT64_MAX - value) || (value < 0 && sum < BUSTUB_INT64_MIN - value)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return sum + value;
+}
+
+/** @return An integer as a Value of an integer type, which throws if the type cannot hold it */
+auto MakeIntegerValue(TypeId type, int64_t value) -> Value {
+  auto check = [&](int64_t min, int64_t max) {
+    if (value < min || value > max) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+    }
+  };
+  switch (type) {
+    case TypeId::TINYINT:
+      check(BUSTUB_INT8_MIN, BUSTUB_INT8_MAX);
+      return {type, static_cast<int8_t>(value)};
+    case TypeId::SMALLINT:
+      check(BUSTUB_INT16_MIN, BUSTUB_INT16_MAX);
+      return {type, static_cast<int16_t>(value)};
+    case TypeId::INTEGER:
+      check(BUSTUB_INT32_MIN, BUSTUB_INT32_MAX);
+      return {type, static_cast<int32_t>(value)};
+    default:
+      return {type, value};
+  }
+}
+
+/** Combine every non-null value of a typed column into the slot of its row. */
+template <typename T, typename Combine>
+void CombineTyped(uint32_t agg_idx, const ColumnVector &input, const std::vector<AggregateState *> &states,
+                  Combine &&combine) {
+  const T *data = input.Data<T>();
+  if (input.HasNoNulls()) {
+    for (size_t row = 0; row < states.size(); row++) {
+      combine(&(*states[row])[agg_idx], data[row]);
+    }
+    return;
+  }
+  for (size_t row = 0; row < states.size(); row++) {
+    if (!input.IsNull(row)) {
+      combine(&(*states[row])[agg_idx], data[row]);
+    }
+  }
+}
+
+/**
+ * Combine a column of numbers into the slots of their rows, one loop per aggregation type.
+ * @tparam T The C++ type of the column
+ * @tparam S The C++ type of the field of the slot, int64_t or double
+ */
+template <typename T, typename S>
+void CombineNumbers(AggregationType agg_type, uint32_t agg_idx, const ColumnVector &input,
+                    const std::vector<AggregateState *> &states, S AggregateSlot::*field) {
+  switch (agg_type) {
+    case AggregationType::SumAggregate:
+      CombineTyped<T>(agg_idx, input, states, [field](AggregateSlot *slot, T value) {
+        if constexpr (std::is_integral_v<S>) {
+          slot->*field = AddChecked(slot->*field, value);
+        } else {
+          slot->*field += value;
+        }
+        slot->null_ = false;
+      });
+      break;
+    case AggregationType::MinAggregate:
+      CombineTyped<T>(agg_idx, input, states, [field](AggregateSlot *slot, T value) {
+        if (slot->null_ || value < slot->*field) {
+          slot->*field = value;
+          slot->null_ = false;
+        }
+      });
+      break;
+    case AggregationType::MaxAggregate:
+      CombineTyped<T>(agg_idx, input, states, [field](AggregateSlot *slot, T value) {
+        if (slot->null_ || value > slot->*field) {
+          slot->*field = value;
+          slot->null_ = false;
+        }
+      });
+      break;
+    default:
+      UNREACHABLE("counts are not combined by value");
+  }
+}
+
+/** Combine a SUM, MIN or MAX of a Value into a slot of SlotType::Value. */
+void CombineValue(AggregationType agg_type, AggregateSlot *slot, const Value &in) {
+  if (in.IsNull()) {
+    return;
+  }
+  switch (agg_type) {
+    case AggregationType::SumAggregate:
+      slot->value_ = slot->null_ ? in : slot->value_.Add(in);
+      break;
+    case AggregationType::MinAggregate:
+      if (slot->null_ || in.CompareLessThan(slot->value_) == CmpBool::CmpTrue) {
+        slot->value_ = in;
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (slot->null_ || in.CompareGreaterThan(slot->value_) == CmpBool::CmpTrue) {
+        slot->value_ = in;
+      }
+      break;
+    default:
+      UNREACHABLE("counts are not combined by value");
+  }
+  slot->null_ = false;
+}
+
+}  // namespace
+
+void SimpleAggregationHashTable::CombineAggregateColumn(uint32_t agg_idx, const ColumnVector &input,
+                                                        const std::vector<AggregateState *> &states) {
+  auto agg_type = agg_types_[agg_idx];
+  if (agg_type == AggregationType::CountStarAggregate) {
+    for (auto *state : states) {
+      (*state)[agg_idx].integer_++;
+    }
+    return;
+  }
+  // The other aggregates skip nulls, and stay null until they see something else.
+  if (agg_type == AggregationType::CountAggregate) {
+    for (size_t row = 0; row < states.size(); row++) {
+      if (!input.IsNull(row)) {
+        auto &slot = (*states[row])[agg_idx];
+        slot.integer_++;
+        slot.null_ = false;
+      }
+    }
+    return;
+  }
+  switch (input.GetType()) {
+    case TypeId::TINYINT:
+      CombineNumbers<int8_t>(agg_type, agg_idx, input, states, &AggregateSlot::integer_);
+      break;
+    case TypeId::SMALLINT:
+      CombineNumbers<int16_t>(agg_type, agg_idx, input, states, &AggregateSlot::integer_);
+      break;
+    case TypeId::INTEGER:
+      CombineNumbers<int32_t>(agg_type, agg_idx, input, states, &AggregateSlot::integer_);
+      break;
+    case TypeId::BIGINT:
+      CombineNumbers<int64_t>(agg_type, agg_idx, input, states, &AggregateSlot::integer_);
+      break;
+    case TypeId::DECIMAL:
+      CombineNumbers<double>(agg_type, agg_idx, input, states, &AggregateSlot::decimal_);
+      break;
+    default:
+      for (size_t row = 0; row < states.size(); row++) {
+        CombineValue(agg_type, &(*states[row])[agg_idx], input.GetValue(row));
+      }
+      break;
+  }
+}
+
+void SimpleAggregationHashTable::InsertMerge(const AggregateKey &agg_key, const AggregateState &partial) {
+  ht_.Upsert(
+      agg_key, [&]() { return GenerateInitialAggregateState(); },
+      [&](AggregateState &state) {
+        for (uint32_t i = 0; i < agg_types_.size(); i++) {
+          auto &slot = state[i];
+          const auto &in = partial[i];
+          if (in.null_) {
+            continue;
+          }
+          auto agg_type = agg_types_[i];
+          if (agg_type == AggregationType::CountStarAggregate || agg_type == AggregationType::CountAggregate) {
+            // Partial counts add up.
+            slot.integer_ += in.integer_;
+            slot.null_ = false;
+            continue;
+          }
+          switch (SlotTypeOf(agg_exprs_[i]->GetReturnType())) {
+            case SlotType::Integer:
+              if (slot.null_ || agg_type == AggregationType::SumAggregate) {
+                slot.integer_ = slot.null_ ? in.integer_ : AddChecked(slot.integer_, in.integer_);
+              } else if (agg_type == AggregationType::MinAggregate) {
+                slot.integer_ = std::min(slot.integer_, in.integer_);
+              } else {
+                slot.integer_ = std::max(slot.integer_, in.integer_);
+              }
+              slot.null_ = false;
+              break;
+            case SlotType::Decimal:
+              if (slot.null_ || agg_type == AggregationType::SumAggregate) {
+                slot.decimal_ = slot.null_ ? in.decimal_ : slot.decimal_ + in.decimal_;
+              } else if (agg_type == AggregationType::MinAggregate) {
+                slot.decimal_ = std::min(slot.decimal_, in.decimal_);
+              } else {
+                slot.decimal_ = std::max(slot.decimal_, in.decimal_);
+              }
+              slot.null_ = false;
+              break;
+            case SlotType::Value:
+              CombineValue(agg_type, &slot, in.value_);
+              break;
+          }
+        }
+      });
+}
+
+void SimpleAggregationHashTable::FinalizeAggregateState(const AggregateState &state, std::vector<Value> *values) const {
+  for (uint32_t i = 0; i < agg_types_.size(); i++) {
+    const auto &slot = state[i];
+    if (slot.null_) {
+      values->emplace_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+      continue;
+    }
+    if (agg_types_[i] == AggregationType::CountStarAggregate || agg_types_[i] == AggregationType::CountAggregate) {
+      values->emplace_back(MakeIntegerValue(TypeId::INTEGER, slot.integer_));
+      continue;
+    }
+    // Like Value::Add(), the sum of a type has the same type.
+    auto type = agg_exprs_[i]->GetReturnType();
+    switch (SlotTypeOf(type)) {
+      case SlotType::Integer:
+        values->emplace_back(MakeIntegerValue(type, slot.integer_));
+        break;
+      case SlotType::Decimal:
+        values->emplace_back(ValueFactory::GetDecimalValue(slot.decimal_));
+        break;
+      case SlotType::Value:
+        values->emplace_back(slot.value_);
+        break;
+    }
+  }
+}
+
 AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                                          std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx),plan_(plan),child_(std::move(child)),aht_(plan->group_bys_,plan->agg_types_),aht_iterator_(aht_.Begin()) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregates(), plan->GetAggregateTypes(),
+           exec_ctx->GetMaxParallelWorkers() > 1 ? PARALLEL_HASH_PARTITIONS : 1),
+      aht_iterator_(aht_.Begin()) {}
 
 void AggregationExecutor::Init() {
+  aht_.Clear();
+  if (!ParallelAggregate()) {
     child_->Init();
-    Tuple cur_tuple{};
-    RID rid{};
-    if( plan_->aggregates_.size() != 0){
-        while (child_->Next(&cur_tuple,&rid)) {
-        aht_.InsertCombine(MakeAggregateKey(&cur_tuple), MakeAggregateValue(&cur_tuple));
-        }
-        aht_iterator_ = aht_.Begin();
+    TupleBatch batch;
+    BatchScratch scratch;
+    while (child_->NextBatch(&batch)) {
+      AggregateBatch(batch.GetTuples(), &aht_, &scratch);
+    }
+  }
+  aht_iterator_ = aht_.Begin();
+  empty_output_done_ = false;
+}
+
+auto AggregationExecutor::ParallelAggregate() -> bool {
+  auto pipeline = ParallelPipeline::Create(exec_ctx_, plan_->GetChildPlan().get());
+  if (pipeline == nullptr) {
+    return false;
+  }
+  // Every worker aggregates its own tuples into a local table with the partitions of the shared one, without latches.
+  std::vector<std::unique_ptr<SimpleAggregationHashTable>> locals(pipeline->NumWorkers());
+  pipeline->Run([&](size_t worker, AbstractExecutor *child) {
+    locals[worker] = std::make_unique<SimpleAggregationHashTable>(plan_->GetAggregates(), plan_->GetAggregateTypes(),
+                                                                  aht_.NumPartitions());
+    TupleBatch batch;
+    BatchScratch scratch;
+    while (child->NextBatch(&batch)) {
+      AggregateBatch(batch.GetTuples(), locals[worker].get(), &scratch);
+    }
+  });
+  // A group is in the same partition of every table, so every partition of the shared table is merged by one worker.
+  ParallelFor(aht_.NumPartitions(), [&](size_t partition) {
+    for (const auto &local : locals) {
+      for (auto iter = local->Begin(partition); iter != local->End(partition); ++iter) {
+        aht_.InsertMerge(iter.Key(), iter.Val());
+      }
+    }
+  });
+  return true;
+}
+
+void AggregationExecutor::AggregateBatch(const std::vector<Tuple> &tuples, SimpleAggregationHashTable *table,
+                                         BatchScratch *scratch) const {
+  if (tuples.empty()) {
+    return;
+  }
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  scratch->chunk_.Load(tuples, &child_->GetOutputSchema());
+  scratch->states_.resize(tuples.size());
+  if (group_bys.empty()) {
+    // Without groups, every row goes to the single group of the empty key.
+    std::fill(scratch->states_.begin(), scratch->states_.end(), table->FindOrInsert(scratch->key_));
+  } else {
+    scratch->group_bys_.resize(group_bys.size());
+    for (size_t g = 0; g < group_bys.size(); g++) {
+      group_bys[g]->EvaluateChunk(scratch->chunk_, &scratch->group_bys_[g]);
+    }
+    scratch->key_.group_bys_.resize(group_bys.size());
+    for (size_t row = 0; row < tuples.size(); row++) {
+      for (size_t g = 0; g < group_bys.size(); g++) {
+        scratch->key_.group_bys_[g] = scratch->group_bys_[g].GetValue(row);
+      }
+      scratch->states_[row] = table->FindOrInsert(scratch->key_);
     }
+  }
+  scratch->aggregates_.resize(aggregates.size());
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    if (plan_->GetAggregateTypes()[i] != AggregationType::CountStarAggregate) {
+      aggregates[i]->EvaluateChunk(scratch->chunk_, &scratch->aggregates_[i]);
+    }
+    table->CombineAggregateColumn(i, scratch->aggregates_[i], scratch->states_);
+  }
 }
 
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { 
-    std::vector<Value> values;
-    const Schema output_schema = GetOutputSchema();
+void AggregationExecutor::ParallelFor(size_t num_tasks, const std::function<void(size_t)> &task) {
+  auto num_workers = std::min(exec_ctx_->GetMaxParallelWorkers(), num_tasks);
+  if (num_workers <= 1) {
+    for (size_t i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next{0};
+  exec_ctx_->GetWorkerPool()->Run(num_workers, [&](size_t worker) {
+    for (size_t i = next++; i < num_tasks; i = next++) {
+      task(i);
+    }
+  });
+}
 
-    if( plan_->aggregates_.size() != 0 ){
-        if( aht_iterator_ != aht_.End() ){
-            values = aht_iterator_.Val().aggregates_;
-            *tuple = Tuple(values, &GetOutputSchema()); //it's ok
-            aht_iterator_++;
-        }
-    } else {
-        return child_->Next(tuple, rid);
-    } 
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  std::vector<Value> values;
+  if (aht_iterator_ == aht_.End()) {
+    // An aggregation without groups still has one row when there is no input at all.
+    if (aht_.Size() != 0 || !plan_->GetGroupBys().empty() || empty_output_done_) {
+      return false;
+    }
+    empty_output_done_ = true;
+    aht_.FinalizeAggregateState(aht_.GenerateInitialAggregateState(), &values);
+  } else {
+    values = aht_iterator_.Key().group_bys_;
+    aht_.FinalizeAggregateState(aht_iterator_.Val(), &values);
+    ++aht_iterator_;
+  }
+  *tuple = Tuple{values, &GetOutputSchema()};
+  return true;
 }
 
 auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
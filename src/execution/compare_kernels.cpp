@@ -0,0 +1,277 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compare_kernels.cpp
+//
+// Identification: src/execution/compare_kernels.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compare_kernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <type_traits>
+
+#include "common/macros.h"
+#include "execution/expressions/comparison_expression.h"
+
+namespace bustub {
+
+namespace {
+
+/** The SIMD registers of a C++ type; LANES is 0 if the rows of the type are compared one by one */
+template <typename T>
+struct Simd {
+  static constexpr size_t LANES = 0;
+};
+
+/**
+ * The comparisons of a signed integer type, built from Eq and Gt of the Simd specialization. Each returns one bit per
+ * lane, set if the comparison is true.
+ */
+template <typename S>
+struct IntegerCompare {
+  /** @return A mask with one bit for each lane of the register */
+  static constexpr auto AllLanes() -> uint32_t { return S::LANES == 32 ? 0xffffffffU : (1U << S::LANES) - 1; }
+
+  template <typename Reg>
+  static auto Ne(Reg a, Reg b) -> uint32_t {
+    return ~S::Eq(a, b) & AllLanes();
+  }
+  template <typename Reg>
+  static auto Lt(Reg a, Reg b) -> uint32_t {
+    return S::Gt(b, a);
+  }
+  template <typename Reg>
+  static auto Le(Reg a, Reg b) -> uint32_t {
+    return ~S::Gt(a, b) & AllLanes();
+  }
+  template <typename Reg>
+  static auto Ge(Reg a, Reg b) -> uint32_t {
+    return ~S::Gt(b, a) & AllLanes();
+  }
+};
+
+#if defined(__AVX2__)
+
+template <>
+struct Simd<int8_t> : IntegerCompare<Simd<int8_t>> {
+  using Reg = __m256i;
+  static constexpr size_t LANES = 32;
+  static auto Load(const int8_t *p) -> Reg { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static auto Set1(int8_t v) -> Reg { return _mm256_set1_epi8(v); }
+  static auto Eq(Reg a, Reg b) -> uint32_t { return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)); }
+  static auto Gt(Reg a, Reg b) -> uint32_t { return _mm256_movemask_epi8(_mm256_cmpgt_epi8(a, b)); }
+};
+
+template <>
+struct Simd<int32_t> : IntegerCompare<Simd<int32_t>> {
+  using Reg = __m256i;
+  static constexpr size_t LANES = 8;
+  static auto Load(const int32_t *p) -> Reg { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static auto Set1(int32_t v) -> Reg { return _mm256_set1_epi32(v); }
+  static auto Eq(Reg a, Reg b) -> uint32_t {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+  }
+  static auto Gt(Reg a, Reg b) -> uint32_t {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));
+  }
+};
+
+template <>
+struct Simd<int64_t> : IntegerCompare<Simd<int64_t>> {
+  using Reg = __m256i;
+  static constexpr size_t LANES = 4;
+  static auto Load(const int64_t *p) -> Reg { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static auto Set1(int64_t v) -> Reg { return _mm256_set1_epi64x(v); }
+  static auto Eq(Reg a, Reg b) -> uint32_t {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+  }
+  static auto Gt(Reg a, Reg b) -> uint32_t {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)));
+  }
+};
+
+template <>
+struct Simd<double> {
+  using Reg = __m256d;
+  static constexpr size_t LANES = 4;
+  static auto Load(const double *p) -> Reg { return _mm256_loadu_pd(p); }
+  static auto Set1(double v) -> Reg { return _mm256_set1_pd(v); }
+  // The predicates match the scalar operators, including for NaN.
+  static auto Eq(Reg a, Reg b) -> uint32_t { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+  static auto Ne(Reg a, Reg b) -> uint32_t { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)); }
+  static auto Lt(Reg a, Reg b) -> uint32_t { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+  static auto Le(Reg a, Reg b) -> uint32_t { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)); }
+  static auto Gt(Reg a, Reg b) -> uint32_t { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+  static auto Ge(Reg a, Reg b) -> uint32_t { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)); }
+};
+
+#elif defined(__SSE2__)
+
+template <>
+struct Simd<int8_t> : IntegerCompare<Simd<int8_t>> {
+  using Reg = __m128i;
+  static constexpr size_t LANES = 16;
+  static auto Load(const int8_t *p) -> Reg { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+  static auto Set1(int8_t v) -> Reg { return _mm_set1_epi8(v); }
+  static auto Eq(Reg a, Reg b) -> uint32_t { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)); }
+  static auto Gt(Reg a, Reg b) -> uint32_t { return _mm_movemask_epi8(_mm_cmpgt_epi8(a, b)); }
+};
+
+template <>
+struct Simd<int32_t> : IntegerCompare<Simd<int32_t>> {
+  using Reg = __m128i;
+  static constexpr size_t LANES = 4;
+  static auto Load(const int32_t *p) -> Reg { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+  static auto Set1(int32_t v) -> Reg { return _mm_set1_epi32(v); }
+  static auto Eq(Reg a, Reg b) -> uint32_t { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+  static auto Gt(Reg a, Reg b) -> uint32_t { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b))); }
+};
+
+template <>
+struct Simd<double> {
+  using Reg = __m128d;
+  static constexpr size_t LANES = 2;
+  static auto Load(const double *p) -> Reg { return _mm_loadu_pd(p); }
+  static auto Set1(double v) -> Reg { return _mm_set1_pd(v); }
+  static auto Eq(Reg a, Reg b) -> uint32_t { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+  static auto Ne(Reg a, Reg b) -> uint32_t { return _mm_movemask_pd(_mm_cmpneq_pd(a, b)); }
+  static auto Lt(Reg a, Reg b) -> uint32_t { return _mm_movemask_pd(_mm_cmplt_pd(a, b)); }
+  static auto Le(Reg a, Reg b) -> uint32_t { return _mm_movemask_pd(_mm_cmple_pd(a, b)); }
+  static auto Gt(Reg a, Reg b) -> uint32_t { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+  static auto Ge(Reg a, Reg b) -> uint32_t { return _mm_movemask_pd(_mm_cmpge_pd(a, b)); }
+};
+
+#endif
+
+template <ComparisonType OP, typename T>
+inline auto CompareScalar(T l, T r) -> bool {
+  switch (OP) {
+    case ComparisonType::Equal:
+      return l == r;
+    case ComparisonType::NotEqual:
+      return l != r;
+    case ComparisonType::LessThan:
+      return l < r;
+    case ComparisonType::LessThanOrEqual:
+      return l <= r;
+    case ComparisonType::GreaterThan:
+      return l > r;
+    case ComparisonType::GreaterThanOrEqual:
+      return l >= r;
+  }
+  return false;
+}
+
+template <ComparisonType OP, typename S, typename Reg>
+inline auto CompareLanes(Reg a, Reg b) -> uint32_t {
+  switch (OP) {
+    case ComparisonType::Equal:
+      return S::Eq(a, b);
+    case ComparisonType::NotEqual:
+      return S::Ne(a, b);
+    case ComparisonType::LessThan:
+      return S::Lt(a, b);
+    case ComparisonType::LessThanOrEqual:
+      return S::Le(a, b);
+    case ComparisonType::GreaterThan:
+      return S::Gt(a, b);
+    case ComparisonType::GreaterThanOrEqual:
+      return S::Ge(a, b);
+  }
+  return 0;
+}
+
+/**
+ * Set the bit of every row where `lhs[row] OP rhs[row]`, or `lhs[row] OP *rhs` for a constant. Full words of 64 rows
+ * go through the SIMD registers, the rows after them one at a time. The mask must be zeroed.
+ */
+template <ComparisonType OP, bool CONSTANT, typename T>
+void CompareLoop(const T *lhs, const T *rhs, size_t size, uint64_t *mask) {
+  size_t row = 0;
+  if constexpr (Simd<T>::LANES > 0) {
+    using S = Simd<T>;
+    typename S::Reg constant{};
+    if constexpr (CONSTANT) {
+      constant = S::Set1(*rhs);
+    }
+    for (; row + 64 <= size; row += 64) {
+      uint64_t word = 0;
+      for (size_t lane = 0; lane < 64; lane += S::LANES) {
+        auto r = CONSTANT ? constant : S::Load(rhs + row + lane);
+        word |= static_cast<uint64_t>(CompareLanes<OP, S>(S::Load(lhs + row + lane), r)) << lane;
+      }
+      mask[row / 64] = word;
+    }
+  }
+  for (; row < size; row++) {
+    bool match = CompareScalar<OP>(lhs[row], CONSTANT ? *rhs : rhs[row]);
+    mask[row / 64] |= static_cast<uint64_t>(match) << (row % 64);
+  }
+}
+
+template <bool CONSTANT, typename T>
+void CompareDispatch(ComparisonType op, const T *lhs, const T *rhs, size_t size, uint64_t *mask) {
+  switch (op) {
+    case ComparisonType::Equal:
+      return CompareLoop<ComparisonType::Equal, CONSTANT>(lhs, rhs, size, mask);
+    case ComparisonType::NotEqual:
+      return CompareLoop<ComparisonType::NotEqual, CONSTANT>(lhs, rhs, size, mask);
+    case ComparisonType::LessThan:
+      return CompareLoop<ComparisonType::LessThan, CONSTANT>(lhs, rhs, size, mask);
+    case ComparisonType::LessThanOrEqual:
+      return CompareLoop<ComparisonType::LessThanOrEqual, CONSTANT>(lhs, rhs, size, mask);
+    case ComparisonType::GreaterThan:
+      return CompareLoop<ComparisonType::GreaterThan, CONSTANT>(lhs, rhs, size, mask);
+    case ComparisonType::GreaterThanOrEqual:
+      return CompareLoop<ComparisonType::GreaterThanOrEqual, CONSTANT>(lhs, rhs, size, mask);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+}  // namespace
+
+void CompareColumns(const ColumnVector &lhs, ComparisonType op, const ColumnVector &rhs, SelectionMask *mask) {
+  BUSTUB_ASSERT(lhs.GetType() == rhs.GetType() && lhs.Size() == rhs.Size(), "the columns must be alike");
+  size_t size = lhs.Size();
+  mask->assign((size + 63) / 64, 0);
+  DispatchFixedType(lhs.GetType(), [&](auto *type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    CompareDispatch<false>(op, lhs.Data<T>(), rhs.Data<T>(), size, mask->data());
+  });
+  const uint64_t *lhs_nulls = lhs.NullWords();
+  const uint64_t *rhs_nulls = rhs.NullWords();
+  for (size_t i = 0; i < mask->size(); i++) {
+    (*mask)[i] &= ~(lhs_nulls[i] | rhs_nulls[i]);
+  }
+}
+
+void CompareColumnConstant(const ColumnVector &column, ComparisonType op, const Value &constant, SelectionMask *mask) {
+  BUSTUB_ASSERT(column.GetType() == constant.GetTypeId(), "the constant must have the type of the column");
+  size_t size = column.Size();
+  mask->assign((size + 63) / 64, 0);
+  if (constant.IsNull()) {
+    return;
+  }
+  DispatchFixedType(column.GetType(), [&](auto *type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    T value = constant.GetAs<T>();
+    CompareDispatch<true>(op, column.Data<T>(), &value, size, mask->data());
+  });
+  const uint64_t *nulls = column.NullWords();
+  for (size_t i = 0; i < mask->size(); i++) {
+    (*mask)[i] &= ~nulls[i];
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// data_chunk.cpp
+//
+// Identification: src/execution/data_chunk.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+#include "execution/data_chunk.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return The value that stands for null in the tuple format of a fixed-length type */
+template <typename T>
+auto NullSentinel(TypeId type) -> T {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return static_cast<T>(BUSTUB_BOOLEAN_NULL);
+    case TypeId::TINYINT:
+      return static_cast<T>(BUSTUB_INT8_NULL);
+    case TypeId::SMALLINT:
+      return static_cast<T>(BUSTUB_INT16_NULL);
+    case TypeId::INTEGER:
+      return static_cast<T>(BUSTUB_INT32_NULL);
+    case TypeId::BIGINT:
+      return static_cast<T>(BUSTUB_INT64_NULL);
+    case TypeId::DECIMAL:
+      return static_cast<T>(BUSTUB_DECIMAL_NULL);
+    case TypeId::TIMESTAMP:
+      return static_cast<T>(BUSTUB_TIMESTAMP_NULL);
+    default:
+      UNREACHABLE("not a fixed-length type");
+  }
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// ColumnVector
+//===--------------------------------------------------------------------===//
+
+auto ColumnVector::ValueWidth(TypeId type) -> size_t {
+  if (!IsFixedType(type)) {
+    return 0;
+  }
+  size_t width = 0;
+  DispatchFixedType(type, [&](auto *type_ptr) { width = sizeof(*type_ptr); });
+  return width;
+}
+
+void ColumnVector::Reset(TypeId type) {
+  type_ = type;
+  size_ = 0;
+  strings_.clear();
+  nulls_.clear();
+}
+
+void ColumnVector::Resize(size_t size) {
+  if (!IsFixedType(type_)) {
+    strings_.resize(size);
+  } else {
+    data_.resize((size * ValueWidth(type_) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  }
+  // The bits of the rows that are added may still be set from a larger size before.
+  if (size > size_ && size_ % 64 != 0) {
+    nulls_[size_ / 64] &= (static_cast<uint64_t>(1) << (size_ % 64)) - 1;
+  }
+  nulls_.resize((size + 63) / 64, 0);
+  size_ = size;
+}
+
+auto ColumnVector::HasNoNulls() const -> bool {
+  return std::all_of(nulls_.begin(), nulls_.end(), [](uint64_t word) { return word == 0; });
+}
+
+auto ColumnVector::GetValue(size_t row) const -> Value {
+  if (IsNull(row)) {
+    return ValueFactory::GetNullValueByType(type_);
+  }
+  if (type_ == TypeId::VARCHAR) {
+    return {TypeId::VARCHAR, strings_[row]};
+  }
+  Value value;
+  DispatchFixedType(type_, [&](auto *type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    value = Value{type_, Data<T>()[row]};
+  });
+  return value;
+}
+
+void ColumnVector::SetValue(size_t row, const Value &value) {
+  SetNull(row, value.IsNull());
+  if (value.IsNull()) {
+    return;
+  }
+  if (type_ == TypeId::VARCHAR) {
+    strings_[row] = value.ToString();
+    return;
+  }
+  DispatchFixedType(type_, [&](auto *type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    Data<T>()[row] = value.GetAs<T>();
+  });
+}
+
+void ColumnVector::Broadcast(const Value &value, size_t size) {
+  Resize(size);
+  if (value.IsNull()) {
+    std::fill(nulls_.begin(), nulls_.end(), ~static_cast<uint64_t>(0));
+    return;
+  }
+  std::fill(nulls_.begin(), nulls_.end(), 0);
+  if (type_ == TypeId::VARCHAR) {
+    std::fill(strings_.begin(), strings_.end(), value.ToString());
+    return;
+  }
+  DispatchFixedType(type_, [&](auto *type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    std::fill(Data<T>(), Data<T>() + size, value.GetAs<T>());
+  });
+}
+
+void ColumnVector::Select(const SelectionVector &selection) {
+  if (type_ == TypeId::VARCHAR) {
+    for (size_t i = 0; i < selection.size(); i++) {
+      strings_[i] = std::move(strings_[selection[i]]);
+    }
+  } else {
+    DispatchFixedType(type_, [&](auto *type_ptr) {
+      using T = std::remove_pointer_t<decltype(type_ptr)>;
+      T *data = Data<T>();
+      for (size_t i = 0; i < selection.size(); i++) {
+        data[i] = data[selection[i]];
+      }
+    });
+  }
+  if (!HasNoNulls()) {
+    for (size_t i = 0; i < selection.size(); i++) {
+      SetNull(i, IsNull(selection[i]));
+    }
+  }
+  Resize(selection.size());
+}
+
+//===--------------------------------------------------------------------===//
+// DataChunk
+//===--------------------------------------------------------------------===//
+
+void DataChunk::Load(const std::vector<Tuple> &tuples, const Schema *schema) {
+  schema_ = schema;
+  size_ = tuples.size();
+  columns_.resize(schema->GetColumnCount());
+  for (uint32_t c = 0; c < schema->GetColumnCount(); c++) {
+    const auto &column = schema->GetColumn(c);
+    auto &vector = columns_[c];
+    vector.Reset(column.GetType());
+    vector.Resize(size_);
+
+    if (!column.IsInlined()) {
+      for (size_t row = 0; row < size_; row++) {
+        vector.SetValue(row, tuples[row].GetValue(schema, c));
+      }
+      continue;
+    }
+
+    // Fixed-length values are stored at the same offset of every tuple, with a sentinel for null.
+    DispatchFixedType(column.GetType(), [&](auto *type_ptr) {
+      using T = std::remove_pointer_t<decltype(type_ptr)>;
+      const T null = NullSentinel<T>(column.GetType());
+      T *data = vector.Data<T>();
+      uint64_t *nulls = vector.NullWords();
+      uint32_t offset = column.GetOffset();
+      for (size_t row = 0; row < size_; row++) {
+        T value;
+        std::memcpy(&value, tuples[row].GetData() + offset, sizeof(T));
+        data[row] = value;
+        nulls[row / 64] |= static_cast<uint64_t>(value == null) << (row % 64);
+      }
+    });
+  }
+}
+
+auto DataChunk::RowTuple(size_t row) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column.GetValue(row));
+  }
+  return {values, schema_};
+}
+
+void DataChunk::Select(const SelectionVector &selection) {
+  for (auto &column : columns_) {
+    column.Select(selection);
+  }
+  size_ = selection.size();
+}
+
+void TrueMask(const ColumnVector &column, SelectionMask *mask) {
+  BUSTUB_ASSERT(column.GetType() == TypeId::BOOLEAN, "only a boolean column selects rows");
+  size_t size = column.Size();
+  mask->assign((size + 63) / 64, 0);
+  const int8_t *data = column.Data<int8_t>();
+  const uint64_t *nulls = column.NullWords();
+  for (size_t row = 0; row < size; row++) {
+    (*mask)[row / 64] |= static_cast<uint64_t>(data[row] != 0) << (row % 64);
+  }
+  for (size_t i = 0; i < mask->size(); i++) {
+    (*mask)[i] &= ~nulls[i];
+  }
+}
+
+void MaskToSelection(const SelectionMask &mask, size_t size, SelectionVector *selection) {
+  selection->clear();
+  for (size_t i = 0; i < (size + 63) / 64; i++) {
+    for (uint64_t word = mask[i]; word != 0; word &= word - 1) {
+      selection->push_back(static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+    }
+  }
+}
+
+}  // namespace bustub
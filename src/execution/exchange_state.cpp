@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_state.cpp
+//
+// Identification: src/execution/exchange_state.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/exchange_state.h"
+
+#include <utility>
+
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+#include "execution/executor_factory.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+RepartitionExchange::RepartitionExchange(const RepartitionPlanNode *plan,
+                                         std::vector<std::unique_ptr<AbstractExecutor>> producers)
+    : plan_(plan), producers_(std::move(producers)) {
+  for (size_t i = 0; i < plan_->GetNumPartitions(); i++) {
+    queues_.push_back(std::make_unique<ExchangeQueue>(producers_.size()));
+  }
+}
+
+RepartitionExchange::~RepartitionExchange() {
+  Cancel();
+  Join();
+}
+
+void RepartitionExchange::Start() {
+  for (size_t i = 0; i < producers_.size(); i++) {
+    threads_.emplace_back([this, i]() { Produce(i); });
+  }
+}
+
+void RepartitionExchange::Cancel() {
+  for (auto &queue : queues_) {
+    queue->Close();
+  }
+}
+
+void RepartitionExchange::Join() {
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+}
+
+auto RepartitionExchange::Pop(size_t partition, TupleBatch *batch) -> bool {
+  if (partition < queues_.size() && queues_[partition]->Pop(batch)) {
+    return true;
+  }
+  std::scoped_lock lock(error_latch_);
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  return false;
+}
+
+auto RepartitionExchange::PartitionOf(const Tuple &tuple, const Schema &schema) const -> size_t {
+  hash_t hash = 0;
+  for (const auto &key : plan_->GetPartitionKeys()) {
+    auto value = key->Evaluate(&tuple, schema);
+    if (!value.IsNull()) {
+      hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&value));
+    }
+  }
+  return hash % queues_.size();
+}
+
+void RepartitionExchange::Produce(size_t producer) {
+  auto *child = producers_[producer].get();
+  try {
+    child->Init();
+    const auto &schema = child->GetOutputSchema();
+    std::vector<TupleBatch> partitions(queues_.size());
+    TupleBatch batch;
+    bool open = true;
+    while (open && child->NextBatch(&batch)) {
+      for (size_t i = 0; open && i < batch.Size(); i++) {
+        auto partition = PartitionOf(batch.TupleAt(i), schema);
+        partitions[partition].Append(std::move(batch.TupleAt(i)), batch.RidAt(i));
+        if (partitions[partition].IsFull()) {
+          open = queues_[partition]->Push(std::move(partitions[partition]));
+          partitions[partition].Clear();
+        }
+      }
+    }
+    for (size_t partition = 0; open && partition < partitions.size(); partition++) {
+      if (!partitions[partition].IsEmpty()) {
+        open = queues_[partition]->Push(std::move(partitions[partition]));
+      }
+    }
+  } catch (...) {
+    {
+      std::scoped_lock lock(error_latch_);
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+    // The consumers see the end of their partitions, and then the error.
+    Cancel();
+  }
+  for (auto &queue : queues_) {
+    queue->ProducerDone();
+  }
+}
+
+ExchangeState::~ExchangeState() {
+  Cancel();
+  repartitions_.clear();
+}
+
+auto ExchangeState::MakeWorkerContext(size_t worker) -> ExecutorContext * {
+  auto &context = contexts_.emplace_back(
+      std::make_unique<ExecutorContext>(exec_ctx_->GetTransaction(), exec_ctx_->GetCatalog(),
+                                        exec_ctx_->GetBufferPoolManager(), exec_ctx_->GetTransactionManager(),
+                                        exec_ctx_->GetLockManager()));
+  context->SetExchange(this, worker);
+  context->SetMemoryBudget(exec_ctx_->GetMemoryBudget());
+  return context.get();
+}
+
+auto ExchangeState::MorselsOf(const AbstractPlanNode *scan) -> std::shared_ptr<MorselQueue> {
+  if (auto iter = morsels_.find(scan); iter != morsels_.end()) {
+    return iter->second;
+  }
+  std::shared_ptr<MorselQueue> morsels;
+  if (scan->GetType() == PlanType::SeqScan) {
+    morsels = SeqScanExecutor::MakeMorselQueue(exec_ctx_, dynamic_cast<const SeqScanPlanNode *>(scan));
+  } else {
+    morsels = MockScanExecutor::MakeMorselQueue(dynamic_cast<const MockScanPlanNode *>(scan));
+  }
+  morsels_.emplace(scan, morsels);
+  return morsels;
+}
+
+auto ExchangeState::RepartitionOf(const RepartitionPlanNode *plan) -> RepartitionExchange * {
+  if (auto iter = repartitions_.find(plan); iter != repartitions_.end()) {
+    return iter->second.get();
+  }
+  if (plan->GetNumPartitions() != num_workers_) {
+    throw Exception("a repartition must have a partition per worker of its gather");
+  }
+  // The producers split the scans of the child like the workers do, through the same state.
+  std::vector<std::unique_ptr<AbstractExecutor>> producers;
+  for (size_t i = 0; i < num_workers_; i++) {
+    producers.push_back(ExecutorFactory::CreateExecutor(MakeWorkerContext(i), plan->GetChildPlan()));
+  }
+  auto exchange = std::make_unique<RepartitionExchange>(plan, std::move(producers));
+  auto *result = exchange.get();
+  repartitions_.emplace(plan, std::move(exchange));
+  return result;
+}
+
+void ExchangeState::Start() {
+  for (auto &[plan, exchange] : repartitions_) {
+    exchange->Start();
+  }
+}
+
+void ExchangeState::Cancel() {
+  for (auto &[plan, exchange] : repartitions_) {
+    exchange->Cancel();
+  }
+}
+
+}  // namespace bustub
@@ -19,6 +19,7 @@
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
@@ -27,14 +28,18 @@
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
 #include "execution/executors/projection_executor.h"
+#include "execution/executors/repartition_executor.h"
 #include "execution/executors/seq_scan_executor.h"
 #include "execution/executors/sort_executor.h"
 #include "execution/executors/topn_executor.h"
 #include "execution/executors/update_executor.h"
 #include "execution/executors/values_executor.h"
+#include "execution/exchange_state.h"
 #include "execution/plans/filter_plan.h"
+#include "execution/plans/gather_plan.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "execution/plans/projection_plan.h"
+#include "execution/plans/repartition_plan.h"
 #include "execution/plans/sort_plan.h"
 #include "execution/plans/topn_plan.h"
 #include "execution/plans/values_plan.h"
@@ -47,7 +52,12 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
-      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+      const auto *seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan.get());
+      // On a worker of a gather, the scan splits the table with the other workers.
+      if (auto *exchange = exec_ctx->GetExchange(); exchange != nullptr) {
+        return std::make_unique<SeqScanExecutor>(exec_ctx, seq_scan_plan, exchange->MorselsOf(seq_scan_plan));
+      }
+      return std::make_unique<SeqScanExecutor>(exec_ctx, seq_scan_plan);
     }
 
     // Create a new index scan executor
@@ -117,6 +127,16 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
+      if (auto *exchange = exec_ctx->GetExchange(); exchange != nullptr) {
+        auto morsels = exchange->MorselsOf(mock_scan_plan);
+        // A shuffled table cannot be split: the first worker scans all of it, and the others nothing.
+        if (morsels == nullptr && exec_ctx->GetExchangeWorker() != 0) {
+          morsels = std::make_shared<MorselQueue>(0, 1);
+        }
+        if (morsels != nullptr) {
+          return std::make_unique<MockScanExecutor>(exec_ctx, mock_scan_plan, std::move(morsels));
+        }
+      }
       return std::make_unique<MockScanExecutor>(exec_ctx, mock_scan_plan);
     }
 
@@ -154,6 +174,23 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<TopNExecutor>(exec_ctx, topn_plan, std::move(child));
     }
 
+      // Create a new gather executor, which builds the executors of its child for every worker itself
+    case PlanType::Gather: {
+      const auto *gather_plan = dynamic_cast<const GatherPlanNode *>(plan.get());
+      return std::make_unique<GatherExecutor>(exec_ctx, gather_plan);
+    }
+
+      // Create a new repartition executor
+    case PlanType::Repartition: {
+      const auto *repartition_plan = dynamic_cast<const RepartitionPlanNode *>(plan.get());
+      if (auto *exchange = exec_ctx->GetExchange(); exchange != nullptr) {
+        return std::make_unique<RepartitionExecutor>(exec_ctx, repartition_plan,
+                                                     exchange->RepartitionOf(repartition_plan));
+      }
+      auto child = ExecutorFactory::CreateExecutor(exec_ctx, repartition_plan->GetChildPlan());
+      return std::make_unique<RepartitionExecutor>(exec_ctx, repartition_plan, std::move(child));
+    }
+
     default:
       UNREACHABLE("Unsupported plan type.");
   }
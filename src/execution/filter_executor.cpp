@@ -31,4 +31,21 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  const auto &schema = child_executor_->GetOutputSchema();
+
+  // Filter the tuples of the child batch in place, until one of them passes.
+  while (child_executor_->NextBatch(batch)) {
+    chunk_.Load(batch->GetTuples(), &schema);
+    filter_expr->EvaluateMask(chunk_, &mask_);
+    MaskToSelection(mask_, chunk_.Size(), &selection_);
+    batch->Select(selection_);
+    if (!batch->IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
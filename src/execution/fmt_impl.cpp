@@ -9,6 +9,7 @@
 #include "execution/plans/aggregation_plan.h"
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/projection_plan.h"
+#include "execution/plans/repartition_plan.h"
 #include "execution/plans/sort_plan.h"
 #include "execution/plans/topn_plan.h"
 
@@ -49,6 +50,10 @@ auto SortPlanNode::PlanNodeToString() const -> std::string {
 
 auto LimitPlanNode::PlanNodeToString() const -> std::string { return fmt::format("Limit {{ limit={} }}", limit_); }
 
+auto RepartitionPlanNode::PlanNodeToString() const -> std::string {
+  return fmt::format("Repartition {{ keys={}, partitions={} }}", partition_keys_, num_partitions_);
+}
+
 auto TopNPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("TopN {{ n={}, order_bys={}}}", n_, order_bys_);
 }
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/gather_executor.h"
+
+#include <utility>
+
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+GatherExecutor::~GatherExecutor() { Stop(); }
+
+void GatherExecutor::Init() {
+  Stop();
+  error_ = nullptr;
+  batch_.Clear();
+  batch_idx_ = 0;
+
+  size_t num_workers = plan_->GetNumWorkers();
+  exchange_ = std::make_unique<ExchangeState>(exec_ctx_, num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.push_back(ExecutorFactory::CreateExecutor(exchange_->MakeWorkerContext(i), plan_->GetChildPlan()));
+  }
+  queue_ = std::make_unique<ExchangeQueue>(num_workers);
+  exchange_->Start();
+  for (size_t i = 0; i < num_workers; i++) {
+    threads_.emplace_back([this, i]() { RunWorker(i); });
+  }
+}
+
+void GatherExecutor::RunWorker(size_t worker) {
+  auto *executor = workers_[worker].get();
+  try {
+    executor->Init();
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      if (!queue_->Push(std::move(batch))) {
+        break;
+      }
+      batch.Clear();
+    }
+  } catch (...) {
+    {
+      std::scoped_lock lock(error_latch_);
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+    // Every other worker stops too, and the consumer sees the end of the queue and then the error.
+    queue_->Close();
+    exchange_->Cancel();
+  }
+  queue_->ProducerDone();
+}
+
+void GatherExecutor::Stop() {
+  if (queue_ != nullptr) {
+    queue_->Close();
+  }
+  if (exchange_ != nullptr) {
+    exchange_->Cancel();
+  }
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  // The instances run in the contexts of the exchange, and read the repartitions it owns.
+  workers_.clear();
+  exchange_.reset();
+  queue_.reset();
+}
+
+auto GatherExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (queue_ != nullptr && queue_->Pop(batch)) {
+    return true;
+  }
+  batch->Clear();
+  Stop();
+  std::scoped_lock lock(error_latch_);
+  if (error_ != nullptr) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+  return false;
+}
+
+auto GatherExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (batch_idx_ == batch_.Size()) {
+    if (!NextBatch(&batch_)) {
+      return false;
+    }
+    batch_idx_ = 0;
+  }
+  *rid = batch_.RidAt(batch_idx_);
+  *tuple = std::move(batch_.TupleAt(batch_idx_++));
+  return true;
+}
+
+}  // namespace bustub
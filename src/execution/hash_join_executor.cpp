@@ -10,25 +10,498 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "execution/executors/hash_join_executor.h"
+#include <algorithm>
+#include <atomic>
 
-// Note for 2022 Fall: You don't need to implement HashJoinExecutor to pass all tests. You ONLY need to implement it
-// if you want to get faster in leaderboard tests.
+#include "execution/executors/hash_join_executor.h"
+#include "execution/parallel_pipeline.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return The hash of a join key, mixed so that every bit of it depends on the whole key */
+auto RadixHash(const Value &key) -> uint64_t {
+  auto hash = static_cast<uint64_t>(std::hash<HashJoinKey>{}(HashJoinKey{key}));
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/** @return The spilled partition of a hash at a level of splitting */
+auto GraceOf(uint64_t hash, uint32_t level) -> size_t {
+  for (uint32_t i = 0; i < level; i++) {
+    hash /= GRACE_PARTITIONS;
+  }
+  return hash % GRACE_PARTITIONS;
+}
+
+/** @return The partition of a hash in a pass that splits by `bits` bits above the lowest `shift` ones */
+auto RadixOf(uint64_t hash, uint32_t bits, uint32_t shift) -> size_t {
+  return bits == 0 ? 0 : (hash >> shift) & ((static_cast<uint64_t>(1) << bits) - 1);
+}
+
+}  // namespace
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_child)),
+      right_executor_(std::move(right_child)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void HashJoinExecutor::Init() { throw NotImplementedException("HashJoinExecutor is not implemented"); }
+HashJoinExecutor::~HashJoinExecutor() { exec_ctx_->GetMemoryBudget()->Release(memory_reserved_); }
+
+void HashJoinExecutor::Init() {
+  auto *budget = exec_ctx_->GetMemoryBudget();
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  budget->Release(memory_reserved_);
+  memory_reserved_ = 0;
+  ht_.Clear();
+  radix_output_.clear();
+  output_partition_ = 0;
+  output_idx_ = 0;
+  grace_ = false;
+  grace_partitions_.clear();
+  grace_reader_.reset();
+  grace_current_ = GracePartition{};
+  left_batch_.Clear();
+  left_idx_ = 0;
+  has_left_ = false;
+
+  // A null key never matches, and an inner join has nothing to produce for a left tuple with a null key.
+  bool skip_null_left = plan_->GetJoinType() == JoinType::INNER;
+  SpillPartitions right_spill(bpm, 0);
+  auto right =
+      Materialize(right_executor_.get(), plan_->GetRightPlan(), plan_->RightJoinKeyExpression(), true, &right_spill);
+  if (right_spill.spilling_) {
+    SpillChunks(&right, &right_spill);
+    right_spill.Finish();
+    SpillPartitions left_spill(bpm, 0);
+    left_spill.spilling_ = true;
+    Materialize(left_executor_.get(), plan_->GetLeftPlan(), plan_->LeftJoinKeyExpression(), skip_null_left,
+                &left_spill);
+    StartGrace(&left_spill, &right_spill);
+    return;
+  }
+
+  size_t right_size = 0;
+  for (const auto &chunk : right) {
+    right_size += chunk.size();
+  }
+  if (right_size >= static_cast<size_t>(RADIX_JOIN_MIN_ROWS)) {
+    SpillPartitions left_spill(bpm, 0);
+    auto left = Materialize(left_executor_.get(), plan_->GetLeftPlan(), plan_->LeftJoinKeyExpression(),
+                            skip_null_left, &left_spill);
+    if (left_spill.spilling_) {
+      SpillChunks(&left, &left_spill);
+      SpillChunks(&right, &right_spill);
+      StartGrace(&left_spill, &right_spill);
+      return;
+    }
+    radix_ = true;
+    RadixJoin(std::move(left), std::move(right));
+    return;
+  }
+
+  radix_ = false;
+  for (auto &chunk : right) {
+    for (auto &right_tuple : chunk) {
+      ht_.Upsert(
+          HashJoinKey{right_tuple.key_}, []() { return std::vector<Tuple>{}; },
+          [&](std::vector<Tuple> &tuples) { tuples.push_back(std::move(right_tuple.tuple_)); });
+    }
+  }
+  left_executor_->Init();
+}
+
+auto HashJoinExecutor::Materialize(AbstractExecutor *executor, const AbstractPlanNodeRef &child_plan,
+                                   const AbstractExpression &key_expr, bool skip_null_keys, SpillPartitions *spill)
+    -> RadixChunks {
+  auto *budget = exec_ctx_->GetMemoryBudget();
+  auto read = [&](AbstractExecutor *child, std::vector<RadixTuple> *chunk, size_t *reserved) {
+    const auto &schema = child->GetOutputSchema();
+    TupleBatch batch;
+    while (child->NextBatch(&batch)) {
+      size_t bytes = 0;
+      for (const auto &tuple : batch.GetTuples()) {
+        bytes += MemoryOf(tuple);
+      }
+      // Another worker may start spilling meanwhile; the batch goes to one place all the same.
+      bool spilling = spill->spilling_;
+      if (!spilling && !budget->Reserve(bytes)) {
+        spill->spilling_ = true;
+        spilling = true;
+      }
+      if (spilling) {
+        // The tuples read so far go to the partitions too, to free their memory for the rest of the query.
+        for (auto &radix_tuple : *chunk) {
+          spill->Add(radix_tuple.hash_, radix_tuple.tuple_);
+        }
+        std::vector<RadixTuple>().swap(*chunk);
+        budget->Release(*reserved);
+        *reserved = 0;
+      }
+      for (auto &tuple : batch.GetTuples()) {
+        auto key = key_expr.Evaluate(&tuple, schema);
+        if (skip_null_keys && key.IsNull()) {
+          continue;
+        }
+        auto hash = RadixHash(key);
+        if (spilling) {
+          spill->Add(hash, tuple);
+        } else {
+          chunk->push_back(RadixTuple{hash, std::move(key), std::move(tuple)});
+        }
+      }
+      if (!spilling) {
+        *reserved += bytes;
+      }
+    }
+  };
+
+  RadixChunks chunks;
+  std::vector<size_t> reserved;
+  if (auto pipeline = ParallelPipeline::Create(exec_ctx_, child_plan.get()); pipeline != nullptr) {
+    chunks.resize(pipeline->NumWorkers());
+    reserved.resize(pipeline->NumWorkers());
+    pipeline->Run(
+        [&](size_t worker, AbstractExecutor *child) { read(child, &chunks[worker], &reserved[worker]); });
+  } else {
+    chunks.resize(1);
+    reserved.resize(1);
+    executor->Init();
+    read(executor, &chunks[0], &reserved[0]);
+  }
+  for (auto bytes : reserved) {
+    memory_reserved_ += bytes;
+  }
+  return chunks;
+}
+
+HashJoinExecutor::SpillPartitions::SpillPartitions(BufferPoolManager *bpm, uint32_t level)
+    : bytes_(GRACE_PARTITIONS, 0), latches_(GRACE_PARTITIONS), level_(level) {
+  for (int i = 0; i < GRACE_PARTITIONS; i++) {
+    files_.push_back(std::make_unique<TmpTupleFile>(bpm));
+  }
+}
+
+void HashJoinExecutor::SpillPartitions::Add(uint64_t hash, const Tuple &tuple) {
+  auto partition = GraceOf(hash, level_);
+  std::scoped_lock lock(latches_[partition]);
+  files_[partition]->Append(tuple);
+  bytes_[partition] += MemoryOf(tuple);
+}
+
+void HashJoinExecutor::SpillPartitions::Finish() {
+  for (auto &file : files_) {
+    file->Finish();
+  }
+}
+
+void HashJoinExecutor::SpillChunks(RadixChunks *chunks, SpillPartitions *spill) {
+  for (auto &chunk : *chunks) {
+    for (auto &radix_tuple : chunk) {
+      spill->Add(radix_tuple.hash_, radix_tuple.tuple_);
+    }
+    std::vector<RadixTuple>().swap(chunk);
+  }
+}
+
+void HashJoinExecutor::StartGrace(SpillPartitions *left, SpillPartitions *right) {
+  exec_ctx_->GetMemoryBudget()->Release(memory_reserved_);
+  memory_reserved_ = 0;
+  grace_ = true;
+  radix_ = false;
+  PushGracePartitions(left, right);
+}
+
+void HashJoinExecutor::PushGracePartitions(SpillPartitions *left, SpillPartitions *right) {
+  left->Finish();
+  right->Finish();
+  for (size_t i = 0; i < left->files_.size(); i++) {
+    grace_partitions_.push_back(
+        GracePartition{std::move(left->files_[i]), std::move(right->files_[i]), right->bytes_[i], left->level_});
+  }
+}
+
+void HashJoinExecutor::Repartition(GracePartition partition) {
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  SpillPartitions left(bpm, partition.level_ + 1);
+  SpillPartitions right(bpm, partition.level_ + 1);
+  auto split = [](TmpTupleFile *file, const AbstractExpression &key_expr, const Schema &schema,
+                  SpillPartitions *spill) {
+    TmpTupleFile::Reader reader(file);
+    Tuple tuple;
+    while (reader.Next(&tuple)) {
+      spill->Add(RadixHash(key_expr.Evaluate(&tuple, schema)), tuple);
+    }
+    spill->Finish();
+  };
+  split(partition.right_.get(), plan_->RightJoinKeyExpression(), right_executor_->GetOutputSchema(), &right);
+  split(partition.left_.get(), plan_->LeftJoinKeyExpression(), left_executor_->GetOutputSchema(), &left);
+  PushGracePartitions(&left, &right);
+}
+
+auto HashJoinExecutor::NextGracePartition() -> bool {
+  auto *budget = exec_ctx_->GetMemoryBudget();
+  while (!grace_partitions_.empty()) {
+    auto partition = std::move(grace_partitions_.back());
+    grace_partitions_.pop_back();
+    if (partition.left_->Size() == 0 ||
+        (partition.right_->Size() == 0 && plan_->GetJoinType() == JoinType::INNER)) {
+      continue;
+    }
+    ht_.Clear();
+    budget->Release(memory_reserved_);
+    memory_reserved_ = 0;
+    if (!budget->Reserve(partition.right_bytes_)) {
+      if (partition.level_ + 1 < static_cast<uint32_t>(GRACE_MAX_LEVELS)) {
+        Repartition(std::move(partition));
+        continue;
+      }
+      // The keys of the partition are too skewed for any split to make it fit.
+      budget->ForceReserve(partition.right_bytes_);
+    }
+    memory_reserved_ = partition.right_bytes_;
+
+    const auto &right_schema = right_executor_->GetOutputSchema();
+    TmpTupleFile::Reader reader(partition.right_.get());
+    Tuple right_tuple;
+    while (reader.Next(&right_tuple)) {
+      ht_.Upsert(
+          HashJoinKey{plan_->RightJoinKeyExpression().Evaluate(&right_tuple, right_schema)},
+          []() { return std::vector<Tuple>{}; },
+          [&](std::vector<Tuple> &tuples) { tuples.push_back(std::move(right_tuple)); });
+    }
+    grace_current_ = std::move(partition);
+    grace_reader_ = std::make_unique<TmpTupleFile::Reader>(grace_current_.left_.get());
+    left_batch_.Clear();
+    left_idx_ = 0;
+    return true;
+  }
+  grace_reader_.reset();
+  grace_current_ = GracePartition{};
+  return false;
+}
+
+void HashJoinExecutor::RadixJoin(RadixChunks left, RadixChunks right) {
+  size_t right_size = 0;
+  for (const auto &chunk : right) {
+    right_size += chunk.size();
+  }
+  // Enough partitions for the right tuples of each to fit in cache, split in two passes of a bounded fan-out.
+  uint32_t bits = 0;
+  while ((right_size >> bits) > static_cast<size_t>(RADIX_PARTITION_ROWS) && bits < 2 * RADIX_BITS_PER_PASS) {
+    bits++;
+  }
+  uint32_t first_bits = std::min(bits, static_cast<uint32_t>(RADIX_BITS_PER_PASS));
+  uint32_t second_bits = bits - first_bits;
+
+  std::vector<RadixTuple> left_tuples;
+  std::vector<RadixTuple> right_tuples;
+  std::vector<size_t> left_bounds;
+  std::vector<size_t> right_bounds;
+  PartitionChunks(&left, first_bits, 64 - first_bits, &left_tuples, &left_bounds);
+  PartitionChunks(&right, first_bits, 64 - first_bits, &right_tuples, &right_bounds);
+
+  size_t num_partitions = static_cast<size_t>(1) << first_bits;
+  radix_output_.resize(num_partitions);
+  ParallelFor(num_partitions, [&](size_t partition) {
+    JoinPartition(&left_tuples[left_bounds[partition]], left_bounds[partition + 1] - left_bounds[partition],
+                  &right_tuples[right_bounds[partition]], right_bounds[partition + 1] - right_bounds[partition],
+                  second_bits, 64 - first_bits - second_bits, &radix_output_[partition]);
+  });
+}
+
+void HashJoinExecutor::PartitionChunks(RadixChunks *chunks, uint32_t bits, uint32_t shift,
+                                       std::vector<RadixTuple> *out, std::vector<size_t> *bounds) {
+  size_t fanout = static_cast<size_t>(1) << bits;
+  // Every chunk counts its tuples per partition first, so that the chunks know where to write them, all at once.
+  std::vector<std::vector<size_t>> offsets(chunks->size(), std::vector<size_t>(fanout, 0));
+  ParallelFor(chunks->size(), [&](size_t c) {
+    for (const auto &tuple : (*chunks)[c]) {
+      offsets[c][RadixOf(tuple.hash_, bits, shift)]++;
+    }
+  });
+  bounds->assign(fanout + 1, 0);
+  size_t offset = 0;
+  for (size_t partition = 0; partition < fanout; partition++) {
+    (*bounds)[partition] = offset;
+    for (auto &chunk_offsets : offsets) {
+      auto count = chunk_offsets[partition];
+      chunk_offsets[partition] = offset;
+      offset += count;
+    }
+  }
+  (*bounds)[fanout] = offset;
+
+  out->resize(offset);
+  ParallelFor(chunks->size(), [&](size_t c) {
+    auto &chunk = (*chunks)[c];
+    for (auto &tuple : chunk) {
+      (*out)[offsets[c][RadixOf(tuple.hash_, bits, shift)]++] = std::move(tuple);
+    }
+    std::vector<RadixTuple>().swap(chunk);
+  });
+}
+
+void HashJoinExecutor::JoinPartition(RadixTuple *left, size_t left_size, RadixTuple *right, size_t right_size,
+                                     uint32_t bits, uint32_t shift, std::vector<Tuple> *output) const {
+  // The second pass orders pointers to the tuples, which are much smaller to move than the tuples themselves.
+  size_t fanout = static_cast<size_t>(1) << bits;
+  auto split = [&](RadixTuple *tuples, size_t size, std::vector<RadixTuple *> *parts, std::vector<size_t> *bounds) {
+    bounds->assign(fanout + 1, 0);
+    for (size_t i = 0; i < size; i++) {
+      (*bounds)[RadixOf(tuples[i].hash_, bits, shift) + 1]++;
+    }
+    for (size_t part = 0; part < fanout; part++) {
+      (*bounds)[part + 1] += (*bounds)[part];
+    }
+    std::vector<size_t> next(bounds->begin(), bounds->end() - 1);
+    parts->resize(size);
+    for (size_t i = 0; i < size; i++) {
+      (*parts)[next[RadixOf(tuples[i].hash_, bits, shift)]++] = &tuples[i];
+    }
+  };
+  std::vector<RadixTuple *> left_parts;
+  std::vector<RadixTuple *> right_parts;
+  std::vector<size_t> left_bounds;
+  std::vector<size_t> right_bounds;
+  split(left, left_size, &left_parts, &left_bounds);
+  split(right, right_size, &right_parts, &right_bounds);
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+  FlatHashTable<HashJoinKey, std::vector<const Tuple *>> table;
+  for (size_t part = 0; part < fanout; part++) {
+    table.Clear();
+    for (size_t i = right_bounds[part]; i < right_bounds[part + 1]; i++) {
+      const auto *right_tuple = right_parts[i];
+      table.Upsert(
+          HashJoinKey{right_tuple->key_}, []() { return std::vector<const Tuple *>{}; },
+          [&](std::vector<const Tuple *> &tuples) { tuples.push_back(&right_tuple->tuple_); });
+    }
+    for (size_t i = left_bounds[part]; i < left_bounds[part + 1]; i++) {
+      const auto *left_tuple = left_parts[i];
+      const auto *matches = left_tuple->key_.IsNull() ? nullptr : table.Find(HashJoinKey{left_tuple->key_});
+      if (matches != nullptr) {
+        for (const auto *right_tuple : *matches) {
+          output->push_back(MakeOutputTuple(left_tuple->tuple_, right_tuple));
+        }
+      } else if (plan_->GetJoinType() == JoinType::LEFT) {
+        output->push_back(MakeOutputTuple(left_tuple->tuple_, nullptr));
+      }
+    }
+  }
+}
+
+void HashJoinExecutor::ParallelFor(size_t num_tasks, const std::function<void(size_t)> &task) {
+  auto num_workers = std::min(exec_ctx_->GetMaxParallelWorkers(), num_tasks);
+  if (num_workers <= 1) {
+    for (size_t i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next{0};
+  exec_ctx_->GetWorkerPool()->Run(num_workers, [&](size_t worker) {
+    for (size_t i = next++; i < num_tasks; i = next++) {
+      task(i);
+    }
+  });
+}
+
+auto HashJoinExecutor::NextLeft() -> bool {
+  if (left_idx_ >= left_batch_.Size()) {
+    if (grace_) {
+      left_batch_.Clear();
+      Tuple tuple;
+      while (grace_reader_ != nullptr && !left_batch_.IsFull() && grace_reader_->Next(&tuple)) {
+        left_batch_.Append(std::move(tuple), RID{});
+      }
+      if (left_batch_.IsEmpty()) {
+        return false;
+      }
+    } else if (!left_executor_->NextBatch(&left_batch_)) {
+      return false;
+    }
+    left_idx_ = 0;
+  }
+  cur_left_ = left_idx_++;
+  has_left_ = true;
+  const auto &left = left_batch_.TupleAt(cur_left_);
+  auto key = plan_->LeftJoinKeyExpression().Evaluate(&left, left_executor_->GetOutputSchema());
+  matches_ = key.IsNull() ? nullptr : ht_.Find(HashJoinKey{key});
+  match_idx_ = 0;
+  return true;
+}
+
+auto HashJoinExecutor::NextJoined(Tuple *tuple) -> bool {
+  if (radix_) {
+    while (output_partition_ < radix_output_.size()) {
+      auto &partition = radix_output_[output_partition_];
+      if (output_idx_ < partition.size()) {
+        *tuple = std::move(partition[output_idx_++]);
+        return true;
+      }
+      std::vector<Tuple>().swap(partition);
+      output_partition_++;
+      output_idx_ = 0;
+    }
+    return false;
+  }
+  while (true) {
+    if (!has_left_ && !NextLeft()) {
+      if (grace_ && NextGracePartition()) {
+        continue;
+      }
+      return false;
+    }
+    if (matches_ != nullptr && match_idx_ < matches_->size()) {
+      *tuple = MakeOutputTuple(left_batch_.TupleAt(cur_left_), &(*matches_)[match_idx_++]);
+      return true;
+    }
+    has_left_ = false;
+    if (matches_ == nullptr && plan_->GetJoinType() == JoinType::LEFT) {
+      *tuple = MakeOutputTuple(left_batch_.TupleAt(cur_left_), nullptr);
+      return true;
+    }
+  }
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextJoined(tuple); }
+
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Clear();
+  Tuple tuple;
+  while (!batch->IsFull() && NextJoined(&tuple)) {
+    batch->Append(std::move(tuple), RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+auto HashJoinExecutor::MakeOutputTuple(const Tuple &left, const Tuple *right) const -> Tuple {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(left.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    values.push_back(right != nullptr ? right->GetValue(&right_schema, i)
+                                      : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+  return Tuple{values, &GetOutputSchema()};
+}
 
 }  // namespace bustub
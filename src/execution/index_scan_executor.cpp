@@ -11,28 +11,111 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx),plan_(plan),iterator_(tree_->GetBeginIterator()) {}
-
-void IndexScanExecutor::Init() { 
-    index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
-    table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
-    tree_ = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get());
-    iterator_ = tree_->GetBeginIterator();
-    // throw NotImplementedException("IndexScanExecutor is not implemented"); 
-    
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+  auto low = MakeKeyTuple(plan_->lower_bound_);
+  auto high = MakeKeyTuple(plan_->upper_bound_);
+
+  tree_ = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get());
+  if (tree_ != nullptr) {
+    iterator_ = tree_->GetRangeIterator(MakeTreeKey<IntegerKeyType>(low), plan_->lower_inclusive_,
+                                        MakeTreeKey<IntegerKeyType>(high), plan_->upper_inclusive_);
+    return;
+  }
+  covering_tree_ = dynamic_cast<BPlusTreeCoveringIndexForOneIntegerColumn *>(index_info_->index_.get());
+  if (covering_tree_ != nullptr) {
+    covering_iterator_ = covering_tree_->GetRangeIterator(MakeTreeKey<CoveringKeyType>(low), plan_->lower_inclusive_,
+                                                          MakeTreeKey<CoveringKeyType>(high), plan_->upper_inclusive_);
+    return;
+  }
+  rids_.clear();
+  rid_idx_ = 0;
+  if (IsHashIndex(index_info_->index_type_)) {
+    // the planner only hands a hash index ranges that are a single key
+    if (!low.has_value() || !high.has_value() || !plan_->lower_inclusive_ || !plan_->upper_inclusive_ ||
+        plan_->lower_bound_->CompareEquals(*plan_->upper_bound_) != CmpBool::CmpTrue) {
+      throw NotImplementedException("hash index scan only supports equality lookups");
+    }
+    index_info_->index_->ScanKey(*low, &rids_, exec_ctx_->GetTransaction());
+    return;
+  }
+  auto *art = dynamic_cast<ArtIndex *>(index_info_->index_.get());
+  if (art == nullptr) {
+    throw NotImplementedException("index scan only supports b+ tree, art and hash indexes");
+  }
+  art->ScanRange(low, plan_->lower_inclusive_, high, plan_->upper_inclusive_, &rids_, exec_ctx_->GetTransaction());
+}
+
+auto IndexScanExecutor::MakeKeyTuple(const std::optional<Value> &bound) const -> std::optional<Tuple> {
+  if (!bound.has_value()) {
+    return std::nullopt;
+  }
+  const auto &key_schema = index_info_->key_schema_;
+  return Tuple({bound->CastAs(key_schema.GetColumn(0).GetType())}, &key_schema);
+}
+
+template <typename KeyType>
+auto IndexScanExecutor::TupleFromEntry(const KeyType &entry) const -> Tuple {
+  const auto &schema = table_info_->schema_;
+  auto *entry_schema = index_info_->index_->GetEntrySchema();
+  const auto &entry_attrs = index_info_->index_->GetEntryAttrs();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (const auto &column : schema.GetColumns()) {
+    values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+  for (uint32_t i = 0; i < entry_attrs.size(); i++) {
+    values[entry_attrs[i]] = entry.ToValue(entry_schema, i);
+  }
+  return {values, &schema};
 }
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { 
-    if( (iterator_ != tree_->GetEndIterator()) ) {
-        RID tmp_rid{(*iterator_).second};
-        table_info_->table_->GetTuple(tmp_rid,tuple,exec_ctx_->GetTransaction());
-        rid = &(tuple->GetRid());
-        iterator_++;
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  // An index only scan builds the tuples from the entries, every column read above the scan is in there.
+  while (true) {
+    RID tuple_rid;
+    if (tree_ != nullptr) {
+      if (iterator_.IsEnd()) {
+        return false;
+      }
+      tuple_rid = (*iterator_).second;
+      if (plan_->index_only_) {
+        *tuple = TupleFromEntry((*iterator_).first);
+        *rid = tuple_rid;
+        ++iterator_;
         return true;
+      }
+      ++iterator_;
+    } else if (covering_tree_ != nullptr) {
+      if (covering_iterator_.IsEnd()) {
+        return false;
+      }
+      tuple_rid = (*covering_iterator_).second;
+      if (plan_->index_only_) {
+        *tuple = TupleFromEntry((*covering_iterator_).first);
+        *rid = tuple_rid;
+        ++covering_iterator_;
+        return true;
+      }
+      ++covering_iterator_;
+    } else {
+      if (rid_idx_ == rids_.size()) {
+        return false;
+      }
+      tuple_rid = rids_[rid_idx_++];
+    }
+    if (table_info_->table_->GetTuple(tuple_rid, tuple, exec_ctx_->GetTransaction())) {
+      *rid = tuple_rid;
+      return true;
     }
-    return false; 
+  }
 }
 
 }  // namespace bustub
@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_normalizer.cpp
+//
+// Identification: src/execution/key_normalizer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/key_normalizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return The size of a normalized value of a type */
+auto NormalizedSizeOf(TypeId type) -> size_t {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return 1;
+    case TypeId::SMALLINT:
+      return 2;
+    case TypeId::INTEGER:
+      return 4;
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+    case TypeId::TIMESTAMP:
+      return 8;
+    case TypeId::VARCHAR:
+      return NORMALIZED_VARCHAR_PREFIX;
+    default:
+      throw NotImplementedException(fmt::format("cannot sort by type {}", Type::TypeIdToString(type)));
+  }
+}
+
+/** Write the lowest `size` bytes of an integer, most significant first, so that memcmp orders them as numbers. */
+void StoreBigEndian(uint64_t bits, size_t size, char *out) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = static_cast<char>((bits >> (8 * (size - 1 - i))) & 0xFF);
+  }
+}
+
+/** Write a signed integer of `size` bytes, with its sign bit flipped so that negative numbers come first. */
+void StoreSigned(int64_t value, size_t size, char *out) {
+  StoreBigEndian(static_cast<uint64_t>(value) ^ (static_cast<uint64_t>(1) << (8 * size - 1)), size, out);
+}
+
+/** Write a non-null value of a type in `size` bytes. */
+void StoreValue(const Value &value, TypeId type, size_t size, char *out) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      out[0] = static_cast<char>(value.GetAs<int8_t>());
+      break;
+    case TypeId::TINYINT:
+      StoreSigned(value.GetAs<int8_t>(), size, out);
+      break;
+    case TypeId::SMALLINT:
+      StoreSigned(value.GetAs<int16_t>(), size, out);
+      break;
+    case TypeId::INTEGER:
+      StoreSigned(value.GetAs<int32_t>(), size, out);
+      break;
+    case TypeId::BIGINT:
+      StoreSigned(value.GetAs<int64_t>(), size, out);
+      break;
+    case TypeId::DECIMAL: {
+      // -0.0 equals 0.0; a negative number has all its bits flipped so that larger magnitudes come first.
+      auto decimal = value.GetAs<double>() == 0 ? 0.0 : value.GetAs<double>();
+      uint64_t bits;
+      memcpy(&bits, &decimal, sizeof(bits));
+      bits = (bits >> 63) != 0 ? ~bits : bits | (static_cast<uint64_t>(1) << 63);
+      StoreBigEndian(bits, size, out);
+      break;
+    }
+    case TypeId::TIMESTAMP:
+      StoreBigEndian(value.GetAs<uint64_t>(), size, out);
+      break;
+    default: {
+      // The length of a VARCHAR counts its terminating zero.
+      size_t length = value.GetLength() == 0 ? 0 : value.GetLength() - 1;
+      auto prefix = std::min(length, size);
+      memcpy(out, value.GetData(), prefix);
+      memset(out + prefix, 0, size - prefix);
+      break;
+    }
+  }
+}
+
+void MsdRadixSort(const char *keys, size_t key_size, uint32_t *rows, uint32_t *buffer, size_t num_rows, size_t byte) {
+  if (byte == key_size) {
+    return;
+  }
+  if (num_rows < static_cast<size_t>(RADIX_SORT_MIN_ROWS)) {
+    std::sort(rows, rows + num_rows, [&](uint32_t lhs, uint32_t rhs) {
+      return memcmp(keys + lhs * key_size + byte, keys + rhs * key_size + byte, key_size - byte) < 0;
+    });
+    return;
+  }
+  std::array<size_t, 257> offsets{};
+  for (size_t i = 0; i < num_rows; i++) {
+    offsets[static_cast<uint8_t>(keys[rows[i] * key_size + byte]) + 1]++;
+  }
+  for (size_t digit = 0; digit < 256; digit++) {
+    if (offsets[digit + 1] == num_rows) {
+      // Every row has the same byte here, e.g. a null byte or the high bytes of small numbers.
+      MsdRadixSort(keys, key_size, rows, buffer, num_rows, byte + 1);
+      return;
+    }
+    offsets[digit + 1] += offsets[digit];
+  }
+  std::array<size_t, 256> next;
+  std::copy(offsets.begin(), offsets.end() - 1, next.begin());
+  for (size_t i = 0; i < num_rows; i++) {
+    buffer[next[static_cast<uint8_t>(keys[rows[i] * key_size + byte])]++] = rows[i];
+  }
+  std::copy(buffer, buffer + num_rows, rows);
+  for (size_t digit = 0; digit < 256; digit++) {
+    auto count = offsets[digit + 1] - offsets[digit];
+    if (count > 1) {
+      MsdRadixSort(keys, key_size, rows + offsets[digit], buffer + offsets[digit], count, byte + 1);
+    }
+  }
+}
+
+}  // namespace
+
+KeyNormalizer::KeyNormalizer(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys,
+                             const Schema &schema)
+    : schema_(schema) {
+  for (const auto &[order_by_type, expr] : order_bys) {
+    auto type = expr->GetReturnType();
+    auto size = NormalizedSizeOf(type);
+    columns_.push_back(KeyColumn{order_by_type == OrderByType::DESC, expr, type, key_size_, size});
+    if (exact_) {
+      num_key_columns_++;
+      key_size_ += 1 + size;
+      exact_ = type != TypeId::VARCHAR;
+    }
+  }
+}
+
+void KeyNormalizer::Normalize(const Tuple &tuple, char *key) const {
+  for (size_t i = 0; i < num_key_columns_; i++) {
+    const auto &column = columns_[i];
+    auto value = column.expr_->Evaluate(&tuple, schema_);
+    char *out = key + column.offset_;
+    if (value.IsNull()) {
+      memset(out, 0, 1 + column.size_);
+    } else {
+      out[0] = 1;
+      StoreValue(value.GetTypeId() == column.type_ ? value : value.CastAs(column.type_), column.type_, column.size_,
+                 out + 1);
+    }
+    if (column.desc_) {
+      for (size_t byte = 0; byte <= column.size_; byte++) {
+        out[byte] = static_cast<char>(~out[byte]);
+      }
+    }
+  }
+}
+
+auto KeyNormalizer::Normalize(const Tuple &tuple) const -> std::string {
+  std::string key(key_size_, 0);
+  Normalize(tuple, key.data());
+  return key;
+}
+
+auto KeyNormalizer::Compare(const Tuple &lhs, const Tuple &rhs) const -> int {
+  for (const auto &column : columns_) {
+    auto left = column.expr_->Evaluate(&lhs, schema_);
+    auto right = column.expr_->Evaluate(&rhs, schema_);
+    int result = 0;
+    if (left.IsNull() || right.IsNull()) {
+      result = static_cast<int>(right.IsNull()) - static_cast<int>(left.IsNull());
+    } else if (left.CompareLessThan(right) == CmpBool::CmpTrue) {
+      result = -1;
+    } else if (left.CompareGreaterThan(right) == CmpBool::CmpTrue) {
+      result = 1;
+    }
+    if (result != 0) {
+      return column.desc_ ? -result : result;
+    }
+  }
+  return 0;
+}
+
+void RadixSortKeys(const char *keys, size_t key_size, std::vector<uint32_t> *rows) {
+  std::vector<uint32_t> buffer(rows->size());
+  MsdRadixSort(keys, key_size, rows->data(), buffer.data(), rows->size(), 0);
+}
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #include "execution/executors/mock_scan_executor.h"
 #include <algorithm>
 #include <random>
+#include <utility>
 
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -391,15 +392,34 @@ MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlan
   }
 }
 
+MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan,
+                                   std::shared_ptr<MorselQueue> morsels)
+    : AbstractExecutor{exec_ctx},
+      plan_{plan},
+      morsels_(std::move(morsels)),
+      func_(GetFunctionOf(plan)),
+      size_(GetSizeOf(plan)) {}
+
+auto MockScanExecutor::MakeMorselQueue(const MockScanPlanNode *plan) -> std::shared_ptr<MorselQueue> {
+  // Every worker would shuffle the rows differently.
+  if (GetShuffled(plan)) {
+    return nullptr;
+  }
+  return std::make_shared<MorselQueue>(GetSizeOf(plan), MORSEL_ROWS);
+}
+
 void MockScanExecutor::Init() {
   // Reset the cursor
   cursor_ = 0;
+  end_ = morsels_ == nullptr ? size_ : 0;
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (cursor_ == size_) {
-    // Scan complete
-    return EXECUTOR_EXHAUSTED;
+  while (cursor_ == end_) {
+    if (morsels_ == nullptr || !morsels_->Next(&cursor_, &end_)) {
+      // Scan complete
+      return EXECUTOR_EXHAUSTED;
+    }
   }
   if (shuffled_idx_.empty()) {
     *tuple = func_(cursor_);
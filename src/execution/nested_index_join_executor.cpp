@@ -11,20 +11,104 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  inner_table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  outer_tuples_.clear();
+  matches_.clear();
+  outer_idx_ = 0;
+  match_idx_ = 0;
+  outer_matched_ = false;
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (outer_idx_ == outer_tuples_.size() && !FetchBatch()) {
+      return false;
+    }
+    const auto &rids = matches_[outer_idx_];
+    while (match_idx_ < rids.size()) {
+      Tuple inner;
+      if (inner_table_info_->table_->GetTuple(rids[match_idx_++], &inner, exec_ctx_->GetTransaction())) {
+        outer_matched_ = true;
+        *tuple = MakeOutputTuple(outer_tuples_[outer_idx_], &inner);
+        return true;
+      }
+    }
+    bool emit_nulls = plan_->GetJoinType() == JoinType::LEFT && !outer_matched_;
+    const auto &outer = outer_tuples_[outer_idx_++];
+    match_idx_ = 0;
+    outer_matched_ = false;
+    if (emit_nulls) {
+      *tuple = MakeOutputTuple(outer, nullptr);
+      return true;
+    }
+  }
+}
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto NestIndexJoinExecutor::FetchBatch() -> bool {
+  outer_tuples_.clear();
+  Tuple outer;
+  RID outer_rid;
+  while (outer_tuples_.size() < BATCH_SIZE && child_executor_->Next(&outer, &outer_rid)) {
+    outer_tuples_.push_back(outer);
+  }
+  outer_idx_ = 0;
+  match_idx_ = 0;
+  outer_matched_ = false;
+  if (outer_tuples_.empty()) {
+    return false;
+  }
+
+  // A null key never matches, only the other outer tuples are probed.
+  const auto &key_schema = index_info_->key_schema_;
+  std::vector<Tuple> keys;
+  std::vector<size_t> probes;
+  for (size_t i = 0; i < outer_tuples_.size(); i++) {
+    auto value = plan_->KeyPredicate()->Evaluate(&outer_tuples_[i], child_executor_->GetOutputSchema());
+    if (value.IsNull()) {
+      continue;
+    }
+    keys.emplace_back(std::vector<Value>{value.CastAs(key_schema.GetColumn(0).GetType())}, &key_schema);
+    probes.push_back(i);
+  }
+
+  std::vector<std::vector<RID>> rids;
+  index_info_->index_->ScanKeys(keys, &rids, exec_ctx_->GetTransaction());
+  matches_.assign(outer_tuples_.size(), {});
+  for (size_t i = 0; i < probes.size(); i++) {
+    matches_[probes[i]] = std::move(rids[i]);
+  }
+  return true;
+}
+
+auto NestIndexJoinExecutor::MakeOutputTuple(const Tuple &outer, const Tuple *inner) const -> Tuple {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+    values.push_back(outer.GetValue(&outer_schema, i));
+  }
+  for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+    values.push_back(inner != nullptr ? inner->GetValue(&inner_schema, i)
+                                      : ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+  }
+  return Tuple{values, &GetOutputSchema()};
+}
 
 }  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.cpp
+//
+// Identification: src/execution/parallel_pipeline.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/filter_executor.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/executors/projection_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/parallel_pipeline.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+auto ParallelPipeline::Create(ExecutorContext *exec_ctx, const AbstractPlanNode *plan)
+    -> std::unique_ptr<ParallelPipeline> {
+  if (exec_ctx->GetMaxParallelWorkers() <= 1) {
+    return nullptr;
+  }
+
+  // Filters and projections are applied by every worker to its own tuples, down to the scan that splits the input.
+  const auto *leaf = plan;
+  while (leaf->GetType() == PlanType::Filter || leaf->GetType() == PlanType::Projection) {
+    leaf = leaf->GetChildAt(0).get();
+  }
+  std::shared_ptr<MorselQueue> morsels;
+  if (leaf->GetType() == PlanType::SeqScan) {
+    morsels = SeqScanExecutor::MakeMorselQueue(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(leaf));
+  } else if (leaf->GetType() == PlanType::MockScan) {
+    morsels = MockScanExecutor::MakeMorselQueue(dynamic_cast<const MockScanPlanNode *>(leaf));
+  }
+  if (morsels == nullptr) {
+    return nullptr;
+  }
+
+  // A worker without a morsel to take would only cost a thread.
+  auto num_workers = std::min(exec_ctx->GetMaxParallelWorkers(), morsels->NumMorsels());
+  if (num_workers <= 1) {
+    return nullptr;
+  }
+  std::vector<std::unique_ptr<AbstractExecutor>> executors;
+  executors.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    executors.push_back(CreateExecutor(exec_ctx, plan, morsels));
+  }
+  return std::unique_ptr<ParallelPipeline>(new ParallelPipeline(exec_ctx, std::move(executors)));
+}
+
+auto ParallelPipeline::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                                      const std::shared_ptr<MorselQueue> &morsels)
+    -> std::unique_ptr<AbstractExecutor> {
+  switch (plan->GetType()) {
+    case PlanType::Filter:
+      return std::make_unique<FilterExecutor>(exec_ctx, dynamic_cast<const FilterPlanNode *>(plan),
+                                              CreateExecutor(exec_ctx, plan->GetChildAt(0).get(), morsels));
+    case PlanType::Projection:
+      return std::make_unique<ProjectionExecutor>(exec_ctx, dynamic_cast<const ProjectionPlanNode *>(plan),
+                                                  CreateExecutor(exec_ctx, plan->GetChildAt(0).get(), morsels));
+    case PlanType::SeqScan:
+      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan), morsels);
+    case PlanType::MockScan:
+      return std::make_unique<MockScanExecutor>(exec_ctx, dynamic_cast<const MockScanPlanNode *>(plan), morsels);
+    default:
+      UNREACHABLE("not a plan of a parallel pipeline");
+  }
+}
+
+void ParallelPipeline::Run(const std::function<void(size_t, AbstractExecutor *)> &consume) {
+  exec_ctx_->GetWorkerPool()->Run(executors_.size(), [&](size_t worker) {
+    executors_[worker]->Init();
+    consume(worker, executors_[worker].get());
+  });
+}
+
+}  // namespace bustub
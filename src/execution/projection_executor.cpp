@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "execution/executors/projection_executor.h"
 #include "storage/table/tuple.h"
 
@@ -10,6 +12,16 @@ ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const Projecti
 void ProjectionExecutor::Init() {
   // Initialize the child executor
   child_executor_->Init();
+
+  // Batches are evaluated column by column if some expression computes something, and every result fits a column.
+  const auto &exprs = plan_->GetExpressions();
+  vectorized_ = std::all_of(exprs.begin(), exprs.end(),
+                            [](const AbstractExpressionRef &expr) {
+                              return IsFixedType(expr->GetReturnType()) || expr->GetReturnType() == TypeId::VARCHAR;
+                            }) &&
+                std::any_of(exprs.begin(), exprs.end(),
+                            [](const AbstractExpressionRef &expr) { return !expr->GetChildren().empty(); });
+  columns_.resize(exprs.size());
 }
 
 auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -33,4 +45,39 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Clear();
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+
+  const auto &exprs = plan_->GetExpressions();
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  std::vector<Value> values{};
+  values.reserve(exprs.size());
+  if (!vectorized_) {
+    for (size_t i = 0; i < child_batch_.Size(); i++) {
+      values.clear();
+      for (const auto &expr : exprs) {
+        values.push_back(expr->Evaluate(&child_batch_.TupleAt(i), child_schema));
+      }
+      batch->Append(Tuple{values, &GetOutputSchema()}, child_batch_.RidAt(i));
+    }
+    return true;
+  }
+
+  chunk_.Load(child_batch_.GetTuples(), &child_schema);
+  for (size_t c = 0; c < exprs.size(); c++) {
+    exprs[c]->EvaluateChunk(chunk_, &columns_[c]);
+  }
+  for (size_t i = 0; i < child_batch_.Size(); i++) {
+    values.clear();
+    for (const auto &column : columns_) {
+      values.push_back(column.GetValue(i));
+    }
+    batch->Append(Tuple{values, &GetOutputSchema()}, child_batch_.RidAt(i));
+  }
+  return true;
+}
 }  // namespace bustub
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_executor.cpp
+//
+// Identification: src/execution/repartition_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/repartition_executor.h"
+
+namespace bustub {
+
+void RepartitionExecutor::Init() {
+  if (child_ != nullptr) {
+    child_->Init();
+  }
+  batch_.Clear();
+  batch_idx_ = 0;
+}
+
+auto RepartitionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (child_ != nullptr) {
+    return child_->NextBatch(batch);
+  }
+  if (!exchange_->Pop(exec_ctx_->GetExchangeWorker(), batch)) {
+    batch->Clear();
+    return false;
+  }
+  return true;
+}
+
+auto RepartitionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (child_ != nullptr) {
+    return child_->Next(tuple, rid);
+  }
+  while (batch_idx_ == batch_.Size()) {
+    if (!NextBatch(&batch_)) {
+      return false;
+    }
+    batch_idx_ = 0;
+  }
+  *rid = batch_.RidAt(batch_idx_);
+  *tuple = std::move(batch_.TupleAt(batch_idx_++));
+  return true;
+}
+
+}  // namespace bustub
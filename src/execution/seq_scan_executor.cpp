@@ -10,28 +10,100 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <utility>
+
 #include "execution/executors/seq_scan_executor.h"
 
 namespace bustub {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx),plan_(plan) {}
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan,
+                                 std::shared_ptr<MorselQueue> morsels)
+    : AbstractExecutor(exec_ctx), plan_(plan), morsels_(std::move(morsels)) {}
+
+auto SeqScanExecutor::MakeMorselQueue(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    -> std::shared_ptr<MorselQueue> {
+  auto *table_info = exec_ctx->GetCatalog()->GetTable(plan->GetTableOid());
+  return std::make_shared<MorselQueue>(table_info->table_->GetPageIds(), MORSEL_PAGES);
+}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  if (morsels_ != nullptr) {
+    morsel_begin_ = morsel_end_ = 0;
+    page_tuples_.clear();
+    page_cursor_ = 0;
+    return;
+  }
+  iterator_.emplace(table_info_->table_->Begin(exec_ctx_->GetTransaction()));
+  end_.emplace(table_info_->table_->End());
+}
+
+auto SeqScanExecutor::NextTuple(Tuple *tuple) -> bool {
+  if (morsels_ == nullptr) {
+    auto &iter = *iterator_;
+    if (iter == *end_) {
+      return false;
+    }
+    *tuple = *iter;
+    ++iter;
+    return true;
+  }
+  // A parallel scan reads the pages of the morsels it takes, a page at a time.
+  while (page_cursor_ == page_tuples_.size()) {
+    if (morsel_begin_ == morsel_end_ && !morsels_->Next(&morsel_begin_, &morsel_end_)) {
+      return false;
+    }
+    page_tuples_.clear();
+    page_cursor_ = 0;
+    table_info_->table_->GetPageTuples(morsels_->PageAt(morsel_begin_++), exec_ctx_->GetTransaction(), &page_tuples_);
+  }
+  *tuple = std::move(page_tuples_[page_cursor_++]);
+  return true;
+}
 
-void SeqScanExecutor::Init() { 
-    table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->table_name_);
-    //do not have the trans id, just suppose the running trasaction is what i need
-    iterator_ = table_info_->table_->Begin(exec_ctx_->GetTransaction());
-    // throw NotImplementedException("SeqScanExecutor is not implemented"); 
+auto SeqScanExecutor::Matches(const Tuple &tuple) const -> bool {
+  if (plan_->filter_predicate_ == nullptr) {
+    return true;
+  }
+  auto value = plan_->filter_predicate_->Evaluate(&tuple, GetOutputSchema());
+  return !value.IsNull() && value.GetAs<bool>();
 }
 
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { 
-    if( !(iterator_ == table_info_->table_->End()) ) {
-        *tuple = *iterator_;
-        *rid = tuple->GetRid();
-        // memcpy(tuple,&(*iterator_),sizeof(Tuple));
-        // Tuple tmp_tuple = const_cast<Tuple&>(*iterator_);
-        return true;
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (NextTuple(tuple)) {
+    if (Matches(*tuple)) {
+      *rid = tuple->GetRid();
+      return true;
+    }
+  }
+  return false;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  bool exhausted = false;
+  do {
+    batch->Clear();
+    Tuple tuple;
+    while (!batch->IsFull()) {
+      if (!NextTuple(&tuple)) {
+        exhausted = true;
+        break;
+      }
+      RID rid = tuple.GetRid();
+      batch->Append(std::move(tuple), rid);
+    }
+    // The pushed-down predicate is evaluated on the whole batch at once.
+    if (plan_->filter_predicate_ != nullptr && !batch->IsEmpty()) {
+      chunk_.Load(batch->GetTuples(), &GetOutputSchema());
+      plan_->filter_predicate_->EvaluateMask(chunk_, &mask_);
+      MaskToSelection(mask_, chunk_.Size(), &selection_);
+      batch->Select(selection_);
     }
-    return false; 
+  } while (batch->IsEmpty() && !exhausted);
+  return !batch->IsEmpty();
 }
 
 }  // namespace bustub
@@ -1,13 +1,177 @@
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
 #include "execution/executors/sort_executor.h"
 
 namespace bustub {
 
+namespace {
+
+/** Pack a normalized key and its tuple into one tuple of a run: | Key | TupleSize (4) | TupleData | */
+auto PackRecord(const char *key, size_t key_size, const Tuple &tuple) -> Tuple {
+  auto size = static_cast<uint32_t>(key_size + sizeof(uint32_t) + tuple.GetLength());
+  std::vector<char> storage(sizeof(uint32_t) + size);
+  memcpy(storage.data(), &size, sizeof(uint32_t));
+  memcpy(storage.data() + sizeof(uint32_t), key, key_size);
+  tuple.SerializeTo(storage.data() + sizeof(uint32_t) + key_size);
+  Tuple record;
+  record.DeserializeFrom(storage.data());
+  return record;
+}
+
+}  // namespace
+
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      normalizer_(plan->GetOrderBy(), child_executor_->GetOutputSchema()) {}
+
+SortExecutor::~SortExecutor() { exec_ctx_->GetMemoryBudget()->Release(memory_reserved_); }
+
+void SortExecutor::Init() {
+  auto *budget = exec_ctx_->GetMemoryBudget();
+  auto key_size = normalizer_.KeySize();
+  budget->Release(memory_reserved_);
+  memory_reserved_ = 0;
+  keys_.clear();
+  tuples_.clear();
+  order_.clear();
+  next_entry_ = 0;
+  merge_.reset();
+  sources_.clear();
+  runs_.clear();
+
+  child_executor_->Init();
+  TupleBatch batch;
+  while (child_executor_->NextBatch(&batch)) {
+    size_t bytes = 0;
+    for (const auto &tuple : batch.GetTuples()) {
+      bytes += key_size + sizeof(Tuple) + sizeof(uint32_t) + tuple.GetLength();
+    }
+    if (!budget->Reserve(bytes)) {
+      if (!tuples_.empty()) {
+        SpillRun();
+      }
+      // A batch is sorted in memory even if it exceeds the budget on its own.
+      if (!budget->Reserve(bytes)) {
+        budget->ForceReserve(bytes);
+      }
+    }
+    memory_reserved_ += bytes;
+    for (auto &tuple : batch.GetTuples()) {
+      keys_.resize(keys_.size() + key_size);
+      normalizer_.Normalize(tuple, keys_.data() + keys_.size() - key_size);
+      tuples_.push_back(std::move(tuple));
+    }
+  }
+
+  if (runs_.empty()) {
+    SortInMemory();
+    return;
+  }
+  if (!tuples_.empty()) {
+    SpillRun();
+  }
+  while (runs_.size() > static_cast<size_t>(SORT_MERGE_FAN_IN)) {
+    std::vector<std::unique_ptr<TmpTupleFile>> group(std::make_move_iterator(runs_.begin()),
+                                                     std::make_move_iterator(runs_.begin() + SORT_MERGE_FAN_IN));
+    runs_.erase(runs_.begin(), runs_.begin() + SORT_MERGE_FAN_IN);
+    runs_.push_back(MergeRuns(std::move(group)));
+  }
+  sources_ = OpenSources(std::move(runs_));
+  runs_.clear();
+  merge_ = std::make_unique<LoserTree<SourceLess>>(sources_.size(), SourceLess{&sources_, &normalizer_});
+}
+
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (merge_ == nullptr) {
+    if (next_entry_ == order_.size()) {
+      return false;
+    }
+    *tuple = std::move(tuples_[order_[next_entry_++]]);
+    return true;
+  }
+  auto top = merge_->Top();
+  auto &source = sources_[top];
+  if (source.done_) {
+    return false;
+  }
+  *tuple = std::move(source.tuple_);
+  source.Advance(normalizer_.KeySize());
+  merge_->Replay(top);
+  return true;
+}
+
+void SortExecutor::SortInMemory() {
+  auto key_size = normalizer_.KeySize();
+  order_.resize(tuples_.size());
+  std::iota(order_.begin(), order_.end(), 0);
+  RadixSortKeys(keys_.data(), key_size, &order_);
+  if (normalizer_.IsExact()) {
+    return;
+  }
+  // Equal keys may still come from different strings; order them by their values.
+  auto key_of = [&](uint32_t row) { return keys_.data() + static_cast<size_t>(row) * key_size; };
+  for (size_t begin = 0, end = 0; begin < order_.size(); begin = end) {
+    for (end = begin + 1; end < order_.size() && memcmp(key_of(order_[begin]), key_of(order_[end]), key_size) == 0;
+         end++) {
+    }
+    if (end - begin > 1) {
+      std::sort(order_.begin() + begin, order_.begin() + end,
+                [&](uint32_t lhs, uint32_t rhs) { return normalizer_.Compare(tuples_[lhs], tuples_[rhs]) < 0; });
+    }
+  }
+}
+
+void SortExecutor::SpillRun() {
+  auto key_size = normalizer_.KeySize();
+  SortInMemory();
+  auto run = std::make_unique<TmpTupleFile>(exec_ctx_->GetBufferPoolManager());
+  for (auto row : order_) {
+    run->Append(PackRecord(keys_.data() + static_cast<size_t>(row) * key_size, key_size, tuples_[row]));
+  }
+  run->Finish();
+  runs_.push_back(std::move(run));
+  keys_.clear();
+  tuples_.clear();
+  order_.clear();
+  exec_ctx_->GetMemoryBudget()->Release(memory_reserved_);
+  memory_reserved_ = 0;
+}
+
+auto SortExecutor::OpenSources(std::vector<std::unique_ptr<TmpTupleFile>> runs) const -> std::vector<MergeSource> {
+  std::vector<MergeSource> sources(runs.size());
+  for (size_t i = 0; i < runs.size(); i++) {
+    sources[i].run_ = std::move(runs[i]);
+    sources[i].reader_ = std::make_unique<TmpTupleFile::Reader>(sources[i].run_.get());
+    sources[i].Advance(normalizer_.KeySize());
+  }
+  return sources;
+}
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+auto SortExecutor::MergeRuns(std::vector<std::unique_ptr<TmpTupleFile>> runs) -> std::unique_ptr<TmpTupleFile> {
+  auto sources = OpenSources(std::move(runs));
+  LoserTree<SourceLess> merge(sources.size(), SourceLess{&sources, &normalizer_});
+  auto run = std::make_unique<TmpTupleFile>(exec_ctx_->GetBufferPoolManager());
+  for (auto top = merge.Top(); !sources[top].done_; top = merge.Top()) {
+    run->Append(sources[top].record_);
+    sources[top].Advance(normalizer_.KeySize());
+    merge.Replay(top);
+  }
+  run->Finish();
+  return run;
+}
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SortExecutor::MergeSource::Advance(size_t key_size) -> bool {
+  if (!reader_->Next(&record_)) {
+    done_ = true;
+    return false;
+  }
+  tuple_.DeserializeFrom(record_.GetData() + key_size);
+  return true;
+}
 
 }  // namespace bustub
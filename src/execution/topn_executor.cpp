@@ -1,13 +1,56 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace bustub {
 
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      normalizer_(plan->GetOrderBy(), child_executor_->GetOutputSchema()) {}
+
+void TopNExecutor::Init() {
+  entries_.clear();
+  next_entry_ = 0;
+  child_executor_->Init();
+  auto less = [this](const TopNEntry &lhs, const TopNEntry &rhs) { return Less(lhs, rhs); };
+  auto n = plan_->GetN();
+  TupleBatch batch;
+  TopNEntry candidate{std::string(normalizer_.KeySize(), 0), Tuple{}};
+  while (child_executor_->NextBatch(&batch)) {
+    for (auto &tuple : batch.GetTuples()) {
+      normalizer_.Normalize(tuple, candidate.key_.data());
+      candidate.tuple_ = std::move(tuple);
+      if (entries_.size() < n) {
+        entries_.push_back(candidate);
+        std::push_heap(entries_.begin(), entries_.end(), less);
+      } else if (n > 0 && Less(candidate, entries_.front())) {
+        std::pop_heap(entries_.begin(), entries_.end(), less);
+        std::swap(entries_.back(), candidate);
+        std::push_heap(entries_.begin(), entries_.end(), less);
+      }
+    }
+  }
+  std::sort_heap(entries_.begin(), entries_.end(), less);
+}
 
-void TopNExecutor::Init() { throw NotImplementedException("TopNExecutor is not implemented"); }
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (next_entry_ == entries_.size()) {
+    return false;
+  }
+  *tuple = std::move(entries_[next_entry_++].tuple_);
+  return true;
+}
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto TopNExecutor::Less(const TopNEntry &lhs, const TopNEntry &rhs) const -> bool {
+  auto result = memcmp(lhs.key_.data(), rhs.key_.data(), normalizer_.KeySize());
+  if (result != 0 || normalizer_.IsExact()) {
+    return result < 0;
+  }
+  return normalizer_.Compare(lhs.tuple_, rhs.tuple_) < 0;
+}
 
 }  // namespace bustub
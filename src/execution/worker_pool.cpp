@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.cpp
+//
+// Identification: src/execution/worker_pool.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/worker_pool.h"
+
+#include <exception>
+#include <utility>
+
+namespace bustub {
+
+WorkerPool::WorkerPool(size_t num_threads) {
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::scoped_lock lock(latch_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::WorkerLoop() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    cv_.wait(lock, [&]() { return stopped_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    auto task = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+void WorkerPool::Run(size_t num_tasks, const std::function<void(size_t)> &task) {
+  if (num_tasks == 0) {
+    return;
+  }
+  std::mutex done_latch;
+  std::condition_variable done_cv;
+  size_t remaining = num_tasks;
+  std::exception_ptr error;
+  auto run = [&](size_t i) {
+    try {
+      task(i);
+    } catch (...) {
+      std::scoped_lock lock(done_latch);
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+    std::scoped_lock lock(done_latch);
+    if (--remaining == 0) {
+      done_cv.notify_all();
+    }
+  };
+
+  {
+    std::scoped_lock lock(latch_);
+    for (size_t i = 1; i < num_tasks; i++) {
+      queue_.emplace_back([&run, i]() { run(i); });
+    }
+  }
+  cv_.notify_all();
+  run(0);
+
+  // Help with the queue rather than wait while tasks of this call may still be in it.
+  while (true) {
+    std::unique_lock lock(latch_);
+    if (queue_.empty()) {
+      break;
+    }
+    auto queued = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    queued();
+  }
+  std::unique_lock lock(done_latch);
+  done_cv.wait(lock, [&]() { return remaining == 0; });
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace bustub
@@ -63,6 +63,7 @@ struct PGColumnRef;
 struct PGResTarget;
 struct PGAExpr;
 struct PGJoinExpr;
+struct PGVacuumStmt;
 }  // namespace duckdb_libpgquery
 
 namespace bustub {
@@ -81,6 +82,7 @@ class ExplainStatement;
 class IndexStatement;
 class DeleteStatement;
 class UpdateStatement;
+class AnalyzeStatement;
 
 /**
  * The binder is responsible for transforming the Postgres parse tree to a binder tree
@@ -204,6 +206,8 @@ class Binder {
 
   auto BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> std::unique_ptr<VariableShowStatement>;
 
+  auto BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement>;
+
   class ContextGuard {
    public:
     explicit ContextGuard(const BoundTableRef **scope, const CTEList **cte_scope) {
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/analyze_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/** `ANALYZE [table]`, collects the statistics of the indexes of one table, or of every table. */
+class AnalyzeStatement : public BoundStatement {
+ public:
+  explicit AnalyzeStatement(std::optional<std::string> table)
+      : BoundStatement(StatementType::ANALYZE_STATEMENT), table_(std::move(table)) {}
+
+  /** The table to analyze, unset for all tables */
+  std::optional<std::string> table_;
+
+  auto ToString() const -> std::string override {
+    return fmt::format("BoundAnalyze {{ table={} }}", table_.value_or("<all>"));
+  }
+};
+
+}  // namespace bustub
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -21,7 +22,9 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, std::string index_type, bool is_unique,
+                          std::vector<std::unique_ptr<BoundColumnRef>> include_cols,
+                          std::optional<int> fill_factor);
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +35,18 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Access method given in `USING`, e.g. `btree` or `art` */
+  std::string index_type_;
+
+  /** Whether the index was created with `CREATE UNIQUE INDEX` */
+  bool is_unique_;
+
+  /** Columns stored in the index next to the key, given with `WITH (include = 'col, ...')` */
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols_;
+
+  /** How full, in percent, the index packs its pages, given with `WITH (fillfactor = 90)` */
+  std::optional<int> fill_factor_;
+
   auto ToString() const -> std::string override;
 };
 
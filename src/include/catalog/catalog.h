@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -21,9 +22,11 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -35,6 +38,14 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The data structure backing an index. */
+enum class IndexType { BPlusTreeIndex, ArtIndex, HashTableIndex, LinearProbeHashTableIndex };
+
+/** Whether an index of this type only answers point lookups, in no particular key order. */
+inline auto IsHashIndex(IndexType index_type) -> bool {
+  return index_type == IndexType::HashTableIndex || index_type == IndexType::LinearProbeHashTableIndex;
+}
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -70,15 +81,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure backing the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +104,10 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure backing the index */
+  const IndexType index_type_;
+  /** Statistics of the index as of the last ANALYZE, unset if it was never analyzed */
+  std::optional<IndexStats> stats_;
 };
 
 /**
@@ -196,12 +213,18 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The data structure backing the index
+   * @param is_unique Whether a key may map to at most one tuple
+   * @param include_attrs Attributes stored next to the key, so that scans reading only them skip the table
+   * @param fill_factor How full, in percent, a b+ tree index packs its pages
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex,
+                   bool is_unique = false, const std::vector<uint32_t> &include_attrs = {},
+                   int fill_factor = BPLUSTREE_DEFAULT_FILL_FACTOR) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -218,29 +241,43 @@ class Catalog {
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, is_unique, include_attrs,
+                                                fill_factor);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
+    switch (index_type) {
+      case IndexType::BPlusTreeIndex:
+        index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+        break;
+      case IndexType::ArtIndex:
+        index = std::make_unique<ArtIndex>(std::move(meta));
+        break;
+      case IndexType::HashTableIndex:
+        index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                              hash_function);
+        break;
+      case IndexType::LinearProbeHashTableIndex:
+        // start from a single block, the table grows as it fills up
+        index = std::make_unique<LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                               1, hash_function);
+        break;
+    }
 
     // Populate the index with all tuples in table heap
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
     for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      index->InsertEntry(tuple->KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs()), tuple->GetRid(),
+                         txn);
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -307,6 +344,16 @@ class Catalog {
     return index->second.get();
   }
 
+  /** Get the index identifier by `index_oid`, for readers of a const catalog such as the optimizer. */
+  auto GetIndex(index_oid_t index_oid) const -> const IndexInfo * {
+    auto index = indexes_.find(index_oid);
+    if (index == indexes_.end()) {
+      return NULL_INDEX_INFO;
+    }
+
+    return index->second.get();
+  }
+
   /**
    * Get all of the indexes for the table identified by `table_name`.
    * @param table_name The name of the table for which indexes should be retrieved
@@ -333,6 +380,20 @@ class Catalog {
     return indexes;
   }
 
+  /**
+   * Collect fresh statistics for every index of the table identified by `table_name`.
+   * Indexes that cannot collect statistics keep none.
+   * @param table_name The name of the table to analyze
+   * @return The indexes of the table, with their statistics updated
+   */
+  auto AnalyzeTable(const std::string &table_name) const -> std::vector<IndexInfo *> {
+    auto indexes = GetTableIndexes(table_name);
+    for (auto *index_info : indexes) {
+      index_info->stats_ = index_info->index_->CollectStats();
+    }
+    return indexes;
+  }
+
   auto GetTableNames() -> std::vector<std::string> {
     std::vector<std::string> result;
     for (const auto &x : table_names_) {
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -40,6 +41,7 @@ class LogManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class WorkerPool;
 
 class ResultWriter {
  public:
@@ -252,6 +254,8 @@ class BustubInstance {
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
   ExecutionEngine *execution_engine_;
+  /** The threads of parallel queries, started by the first query that may use more than one */
+  std::unique_ptr<WorkerPool> worker_pool_;
   std::shared_mutex catalog_lock_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
@@ -266,6 +270,18 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return The number of workers of a parallel pipeline at most, from `SET max_parallel_workers`; 1 by default */
+  auto GetMaxParallelWorkers() -> size_t {
+    auto workers = std::strtoul(GetSessionVariable("max_parallel_workers").c_str(), nullptr, 10);
+    return workers == 0 ? 1 : workers;
+  }
+
+  /** @return The memory budget of a query in bytes, from `SET query_memory_budget`; 256 MB by default */
+  auto GetQueryMemoryBudget() -> size_t {
+    auto budget = std::strtoull(GetSessionVariable("query_memory_budget").c_str(), nullptr, 10);
+    return budget == 0 ? DEFAULT_QUERY_MEMORY_BUDGET : budget;
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
@@ -46,4 +46,50 @@ using oid_t = uint16_t;
 
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
+/** Share of a page, in percent, that a b+ tree fills when it splits the rightmost page of a level or is rebuilt. */
+static constexpr int BPLUSTREE_DEFAULT_FILL_FACTOR = 50;
+static constexpr int BPLUSTREE_MIN_FILL_FACTOR = 10;
+
+/** Number of leaves that b+ tree statistics are collected from, and buckets of their key histogram. */
+static constexpr int BPLUSTREE_STATS_SAMPLE_LEAVES = 100;
+static constexpr int BPLUSTREE_STATS_HISTOGRAM_BUCKETS = 16;
+
+/** Number of tuples that an executor produces per NextBatch call. */
+static constexpr int EXECUTION_BATCH_SIZE = 1024;
+
+/** Number of table pages, or rows of a mock table, that a worker of a parallel scan takes at a time. */
+static constexpr int MORSEL_PAGES = 16;
+static constexpr int MORSEL_ROWS = 16384;
+
+/** Number of partitions, each with its own latch, of the hash tables that parallel workers write at once. */
+static constexpr int PARALLEL_HASH_PARTITIONS = 64;
+
+/** Number of build tuples from which a hash join partitions both of its inputs by the radix of the key hashes. */
+static constexpr int RADIX_JOIN_MIN_ROWS = 65536;
+/** Number of build tuples that a radix partition of a hash join aims for, so that its hash table stays in cache. */
+static constexpr int RADIX_PARTITION_ROWS = 4096;
+/** Number of hash bits that a pass of radix partitioning splits by at most, so that its fan-out stays TLB-friendly. */
+static constexpr int RADIX_BITS_PER_PASS = 6;
+
+/** Memory, in bytes, that the hash tables and buffers of a query may hold before they spill to temporary pages. */
+static constexpr size_t DEFAULT_QUERY_MEMORY_BUDGET = 256 << 20;
+/** Number of partitions that a hash join splits its inputs into, per level, when they are spilled. */
+static constexpr int GRACE_PARTITIONS = 16;
+/** Number of times a hash join splits a spilled partition again when its build side still exceeds the budget. */
+static constexpr int GRACE_MAX_LEVELS = 4;
+
+/** Number of leading bytes of a VARCHAR that a normalized sort key holds; longer strings tie on it. */
+static constexpr int NORMALIZED_VARCHAR_PREFIX = 16;
+/** Number of rows below which the radix sort of normalized keys falls back to comparisons. */
+static constexpr int RADIX_SORT_MIN_ROWS = 64;
+
+/** Number of sorted runs that a sort merges at once; more runs are merged into longer ones first. */
+static constexpr int SORT_MERGE_FAN_IN = 64;
+
+/** Number of batches that an exchange queue holds before its producers wait for the consumer. */
+static constexpr int EXCHANGE_QUEUE_BATCHES = 8;
+
+/** Estimated number of rows of a table from which the optimizer splits its scans across the workers of an exchange. */
+static constexpr int PARALLEL_EXCHANGE_MIN_ROWS = 100000;
+
 }  // namespace bustub
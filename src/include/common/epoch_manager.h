@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * EpochManager provides epoch based memory reclamation for latch-free data structures.
+ *
+ * Every operation on the data structure runs inside an epoch guard. Memory that has been unlinked from the data
+ * structure is handed to Retire() instead of being freed, and is only freed once every operation that was running
+ * at the time it was unlinked has finished, so optimistic readers never touch freed memory.
+ *
+ * The global epoch only advances when no operation is left in the epoch before the current one, and memory retired
+ * in epoch e is freed when the global epoch advances to e + 3. The number of operations in each epoch is kept in
+ * striped counters so that entering and leaving a guard does not make all threads contend on one cache line.
+ */
+class EpochManager {
+ public:
+  /** RAII guard that keeps memory retired while it is alive from being freed. */
+  class Guard {
+   public:
+    explicit Guard(EpochManager *manager) : manager_(manager), slot_(manager->Enter()) {}
+    ~Guard() { manager_->Exit(slot_); }
+    DISALLOW_COPY_AND_MOVE(Guard);
+
+   private:
+    EpochManager *manager_;
+    std::atomic<int64_t> *slot_;
+  };
+
+  EpochManager() = default;
+  ~EpochManager();
+  DISALLOW_COPY_AND_MOVE(EpochManager);
+
+  /**
+   * Free `ptr` with `deleter` once no running operation can reach it any more. The caller must have unlinked `ptr`
+   * and must be inside a guard.
+   */
+  void Retire(void *ptr, void (*deleter)(void *));
+
+  /** Retire an object allocated with `new`. */
+  template <typename T>
+  void Retire(T *ptr) {
+    Retire(static_cast<void *>(ptr), [](void *p) { delete static_cast<T *>(p); });
+  }
+
+ private:
+  static constexpr size_t NUM_STRIPES = 16;
+  /** Try to advance the epoch once this many objects wait to be freed. */
+  static constexpr size_t RETIRE_THRESHOLD = 64;
+
+  struct alignas(64) Counter {
+    std::atomic<int64_t> count_{0};
+  };
+
+  /** Register the calling thread in the current epoch, returns the counter to decrement on exit. */
+  auto Enter() -> std::atomic<int64_t> *;
+  void Exit(std::atomic<int64_t> *slot) { slot->fetch_sub(1, std::memory_order_release); }
+
+  /** Advance the epoch if nobody is left in the previous one, freeing what was retired three epochs ago. */
+  void TryAdvance();
+  void FreeAll(std::vector<std::pair<void *, void (*)(void *)>> *retired);
+
+  std::atomic<uint64_t> epoch_{0};
+  std::array<std::array<Counter, NUM_STRIPES>, 3> active_;
+
+  std::mutex retired_latch_;
+  std::array<std::vector<std::pair<void *, void (*)(void *)>>, 3> retired_;
+  size_t num_retired_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art.h
+//
+// Identification: src/include/container/art/art.h
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * art.h
+ *
+ * In-memory adaptive radix tree with optimistic lock coupling.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/epoch_manager.h"
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * ArtKey is a binary-comparable key: comparing two keys byte by byte gives the same order as comparing the values
+ * they were built from.
+ */
+class ArtKey {
+ public:
+  ArtKey() = default;
+
+  /** Append a signed integer of `width` bytes, big-endian with the sign bit flipped so that negatives sort first. */
+  void AppendInteger(int64_t value, size_t width) {
+    auto bits = static_cast<uint64_t>(value) ^ (uint64_t{1} << (width * 8 - 1));
+    for (size_t i = width; i > 0; i--) {
+      bytes_.push_back(static_cast<char>((bits >> ((i - 1) * 8)) & 0xFF));
+    }
+  }
+
+  /**
+   * Append a string of `len` bytes. Zero bytes are escaped as 0x00 0x01 and the string ends with 0x00 0x00, so no
+   * encoded string is a prefix of another and shorter strings sort before longer ones with the same start.
+   */
+  void AppendString(const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      bytes_.push_back(data[i]);
+      if (data[i] == '\0') {
+        bytes_.push_back('\1');
+      }
+    }
+    bytes_.append(2, '\0');
+  }
+
+  auto operator[](size_t i) const -> uint8_t { return static_cast<uint8_t>(bytes_[i]); }
+  auto operator==(const ArtKey &other) const -> bool { return bytes_ == other.bytes_; }
+  /** Bytes compare as unsigned, the same order the tree keeps its keys in. */
+  auto operator<(const ArtKey &other) const -> bool { return bytes_ < other.bytes_; }
+  auto Size() const -> size_t { return bytes_.size(); }
+
+ private:
+  std::string bytes_;
+};
+
+/**
+ * AdaptiveRadixTree maps binary-comparable keys to RIDs, following Leis et al., "The Adaptive Radix Tree: ARTful
+ * Indexing for Main-Memory Databases" and "The ART of Practical Synchronization".
+ *
+ * Inner nodes grow and shrink between four layouts (Node4, Node16, Node48 and Node256) depending on their fan-out,
+ * and common key prefixes are collapsed into the node below them (path compression). Each key is stored in full in
+ * its leaf, so only the first few bytes of a compressed prefix are kept in the node.
+ *
+ * Concurrency uses optimistic lock coupling: every node carries a version word. Readers never write to shared
+ * memory, they remember the version of each node they visit and restart if it changed under them. Writers lock
+ * only the one or two nodes they modify. Replaced nodes and removed leaves are freed through an epoch manager, so a
+ * reader that is still looking at them never touches freed memory.
+ *
+ * Keys must not be prefixes of each other, which holds for keys built from the same column types with ArtKey.
+ */
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  /**
+   * Look up a key.
+   * @param[out] value the value of the key, if found
+   * @return true if the key exists
+   */
+  auto Lookup(const ArtKey &key, RID *value) const -> bool;
+
+  /**
+   * Insert a key, unless it exists already.
+   * @return true if the key was inserted, false if it exists
+   */
+  auto Insert(const ArtKey &key, RID value) -> bool;
+
+  /**
+   * Remove a key.
+   * @param value if set, the key is removed only if it maps to this value
+   * @return true if the key was removed, false if it does not exist or maps to another value
+   */
+  auto Remove(const ArtKey &key, std::optional<RID> value = std::nullopt) -> bool;
+
+  /**
+   * Collect the values of the keys between `low` and `high` in key order, an unset bound leaves that side open.
+   * A concurrent writer that changes a node the scan has visited makes the scan start over.
+   */
+  void ScanRange(const std::optional<ArtKey> &low, bool low_inclusive, const std::optional<ArtKey> &high,
+                 bool high_inclusive, std::vector<RID> *result) const;
+
+ private:
+  struct Node;
+  template <uint16_t CAPACITY>
+  struct SortedNode;
+  struct Node4;
+  struct Node16;
+  struct Node48;
+  struct Node256;
+  struct Leaf;
+  struct ScanBounds;
+
+  // single attempts of the operations above, they set `restart` when a concurrent writer got in the way
+  auto LookupOptimistic(const ArtKey &key, RID *value, bool *restart) const -> bool;
+  auto InsertOptimistic(const ArtKey &key, RID value, bool *restart) -> bool;
+  auto RemoveOptimistic(const ArtKey &key, const std::optional<RID> &value, bool *restart) -> bool;
+  /** Scan the subtree of `node`, `low_tight` and `high_tight` tell whether the path to it still equals that bound. */
+  void ScanOptimistic(const Node *node, uint32_t level, bool low_tight, bool high_tight, const ScanBounds &bounds,
+                      std::vector<RID> *result, bool *restart) const;
+
+  // inner node helpers, dispatching on the node layout
+  static auto GetChild(const Node *node, uint8_t key) -> Node *;
+  static void Change(Node *node, uint8_t key, Node *child);
+  static auto AnyLeaf(const Node *node, bool *restart) -> const Leaf *;
+  void InsertAndUnlock(Node *node, uint64_t version, Node *parent, uint64_t parent_version, uint8_t parent_key,
+                       uint8_t key, Node *child, bool *restart);
+  void RemoveAndUnlock(Node *node, uint64_t version, Node *parent, uint64_t parent_version, uint8_t parent_key,
+                       uint8_t key, bool *restart);
+  template <typename CurNode, typename BiggerNode>
+  void InsertGrow(CurNode *node, uint64_t version, Node *parent, uint64_t parent_version, uint8_t parent_key,
+                  uint8_t key, Node *child, bool *restart);
+  template <typename CurNode, typename SmallerNode>
+  void RemoveShrink(CurNode *node, uint64_t version, Node *parent, uint64_t parent_version, uint8_t parent_key,
+                    uint8_t key, bool *restart);
+
+  // compressed prefix helpers, `level` is advanced past the prefix
+  static auto CheckPrefix(const Node *node, const ArtKey &key, uint32_t *level) -> bool;
+  static auto CheckPrefixPessimistic(const Node *node, const ArtKey &key, uint32_t *level, uint8_t *non_matching_key,
+                                     std::string *remaining_prefix, bool *restart) -> bool;
+
+  static void DeleteNode(void *node);
+  static void DeleteLeaf(void *leaf);
+  static void DestroySubtree(Node *node);
+
+  /** The root is a Node256 with no prefix that is never replaced, so every other node has a parent. */
+  Node *root_;
+  mutable EpochManager epoch_manager_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/extendible_hash_table_header_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
@@ -30,6 +32,18 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * The directory has two levels: a header page picks a directory page by the
+ * top bits of the hash, and the directory page picks the bucket by the low
+ * bits. Once a directory page is full, it is split in two by the next top bit,
+ * so the table outgrows the 512 buckets a single directory page can address.
+ *
+ * Latches are taken top down. Lookups, inserts and removes read latch the
+ * header and the directory page, so they only contend on the latch of the one
+ * bucket page they touch: lookups read latch it, inserts and removes write
+ * latch it. Splits and merges of buckets write latch their directory page,
+ * and leave the rest of the table alone. Splits of directory pages change
+ * the header and write latch it.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +54,14 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param unique whether a key may have at most one value
+   * @param header_max_depth the largest global depth of the header page
+   * @param directory_max_depth the largest global depth of a directory page
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   bool unique = false, uint32_t header_max_depth = HEADER_MAX_DEPTH,
+                                   uint32_t directory_max_depth = DIRECTORY_MAX_DEPTH);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -50,7 +69,8 @@ class DiskExtendibleHashTable {
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair exists, or the key does in a unique table
+   * @throw Exception if the bucket of the key is full and neither its directory nor the header can grow any more
    */
   auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
@@ -75,12 +95,17 @@ class DiskExtendibleHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Returns the global depth
+   * Returns the largest global depth of the directory pages
    */
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Helper function to verify the integrity of the extendible hash table's directory.
+   * Returns the global depth of the header page
+   */
+  auto GetHeaderGlobalDepth() -> uint32_t;
+
+  /**
+   * Helper function to verify the integrity of the extendible hash table's header and directories.
    */
   void VerifyIntegrity();
 
@@ -122,19 +147,90 @@ class DiskExtendibleHashTable {
   auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Fetches the header page from the buffer pool manager.
    *
-   * @return a pointer to the directory page
+   * @return a pointer to the page holding the header
    */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
+  auto FetchHeaderPage() -> Page *;
+
+  /**
+   * Fetches a directory page from the buffer pool manager.
+   *
+   * @param directory_page_id the page_id to fetch
+   * @return a pointer to the page holding the directory
+   */
+  auto FetchDirectoryPage(page_id_t directory_page_id) -> Page *;
+
+  /**
+   * Fetches the directory page a key belongs to. The header must be latched.
+   *
+   * @param key the key for lookup
+   * @param header_page the page holding the header
+   * @return a pointer to the page holding the directory
+   */
+  auto FetchDirectoryPageOf(const KeyType &key, Page *header_page) -> Page *;
+
+  /** @return the header stored in a page */
+  static auto HeaderOf(Page *page) -> ExtendibleHashTableHeaderPage * {
+    return reinterpret_cast<ExtendibleHashTableHeaderPage *>(page->GetData());
+  }
+
+  /** @return the directory stored in a page */
+  static auto DirectoryOf(Page *page) -> HashTableDirectoryPage * {
+    return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  }
 
   /**
    * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
+   * The page is returned rather than the bucket in it, so that the caller can latch it.
    *
    * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * @return a pointer to the page holding the bucket
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  auto FetchBucketPage(page_id_t bucket_page_id) -> Page *;
+
+  /** @return whether the bucket stored in a page holds no pairs */
+  auto IsBucketEmpty(page_id_t bucket_page_id) -> bool;
+
+  /** @return the bucket stored in a page */
+  static auto BucketOf(Page *page) -> HASH_TABLE_BUCKET_TYPE * {
+    return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  }
+
+  /**
+   * Inserts into a bucket that is latched for writing.
+   *
+   * @return whether the pair was inserted, unset if the bucket is full
+   */
+  auto InsertIntoBucket(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value)
+      -> std::optional<bool>;
+
+  /**
+   * Splits the bucket at bucket_idx in two, doubling the directory first if
+   * the bucket's local depth equals the global depth. The directory page must
+   * be write latched.
+   *
+   * @return false if the directory is at its maximum depth already
+   */
+  auto SplitBucket(HashTableDirectoryPage *dir_page, uint32_t bucket_idx) -> bool;
+
+  /**
+   * Moves the pairs whose hash has hash_bit set from one bucket to another.
+   */
+  void MoveBucketPairs(HASH_TABLE_BUCKET_TYPE *from, HASH_TABLE_BUCKET_TYPE *to, uint32_t hash_bit);
+
+  /**
+   * Splits the directory page of a key in two by the next top bit of the
+   * hash, doubling the header first if the directory's local depth equals the
+   * header's global depth. Every bucket of the directory is split along, so
+   * the new directory page gets the same shape as the old one.
+   *
+   * Does nothing if another insert made room for the key in the meantime.
+   *
+   * @param key the key that found its bucket full
+   * @throw Exception if the header is at its maximum depth already
+   */
+  void SplitDirectory(const KeyType &key);
 
   /**
    * Performs insertion with an optional bucket splitting.
@@ -151,7 +247,7 @@ class DiskExtendibleHashTable {
    * if Remove makes a bucket empty.
    *
    * There are three conditions under which we skip the merge:
-   * 1. The bucket is no longer empty.
+   * 1. Neither the bucket nor its split image is empty.
    * 2. The bucket has local depth 0.
    * 3. The bucket's local depth doesn't match its split image's local depth.
    *
@@ -162,12 +258,11 @@ class DiskExtendibleHashTable {
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
-
-  // Readers includes inserts and removes, writers are splits and merges
-  ReaderWriterLatch table_latch_;
+  bool unique_;
+  uint32_t directory_max_depth_;
   HashFunction<KeyType> hash_fn_;
 };
 
@@ -24,12 +24,25 @@
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define LINEAR_PROBE_HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * A slot is taken once and stays occupied after a remove, as a tombstone that
+ * keeps the probe sequences running through it intact. Tombstones count
+ * towards the load factor and are dropped when the table grows.
+ *
+ * Growing is incremental. It only allocates the header of a table of twice
+ * the size, whose blocks are allocated on first use. Every later insert and
+ * remove then moves the pairs of a few blocks of the old table over, until the
+ * old table is empty and dropped. Until then, lookups probe both tables; the
+ * probe sequences of the old table run on through the blocks that were moved.
+ *
+ * Lookups hold the table latch in read mode, inserts and removes, which move
+ * pairs to the new table along, in write mode.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -39,18 +52,21 @@ class LinearProbeHashTable {
    *
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
-   * @param num_buckets initial number of buckets contained by this hash table
+   * @param num_buckets initial number of buckets contained by this hash table, rounded up to whole blocks
    * @param hash_fn the hash function
+   * @param unique whether a key may have at most one value
    */
   explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn,
+                                bool unique = false);
 
   /**
    * Inserts a key-value pair into the hash table.
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair exists, or the key does in a unique table
+   * @throw Exception if the table would need more blocks than a header page has room for
    */
   auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
@@ -73,8 +89,11 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. Pairs are
+   * moved to the new table by the inserts and removes that follow; a resize
+   * that is still going on is finished first.
    * @param initial_size the initial size of the hash table
+   * @throw Exception if the table would need more blocks than a header page has room for
    */
   void Resize(size_t initial_size);
 
@@ -84,11 +103,55 @@ class LinearProbeHashTable {
    */
   auto GetSize() -> size_t;
 
+  /**
+   * @return whether pairs of a smaller table are still to be moved to the current one
+   */
+  auto IsResizing() -> bool;
+
+  /** Largest share of occupied slots, tombstones included, before the table grows */
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
+
+  /** Number of blocks of the old table that each insert and remove moves to the new one while resizing */
+  static constexpr size_t MIGRATE_BLOCKS_PER_WRITE = 1;
+
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
+  auto GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage *;
   auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
+
+  /**
+   * Walks the probe sequence of a key through one table, calling visit(block,
+   * slot) on each occupied slot, and on the first free one, where it stops.
+   * block is null for a block that is not allocated yet, whose slots are all
+   * free. The walk also stops once visit returns true.
+   *
+   * @param skip_blocks the number of leading blocks that were moved out of the table already, and are stepped over
+   */
+  template <typename Visitor>
+  void Probe(HashTableHeaderPage *header_page, size_t skip_blocks, const KeyType &key, Visitor &&visit);
+
+  /** @return whether a table holds the pair, or any pair of the key if value is null */
+  auto Contains(HashTableHeaderPage *header_page, size_t skip_blocks, const KeyType &key, const ValueType *value)
+      -> bool;
+
+  /** Removes a pair from a table. @return whether it was there */
+  auto RemoveFrom(HashTableHeaderPage *header_page, size_t skip_blocks, const KeyType &key, const ValueType &value)
+      -> bool;
+
+  /** Inserts a pair into the first free slot of its probe sequence, without checking for duplicates. */
   void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
+
+  /** Moves up to num_blocks blocks of the old table to the current one, and drops the old table once it is empty. */
+  void MigrateBlocks(HashTableHeaderPage *header_page, size_t num_blocks);
+
+  /**
+   * Starts a resize to at least num_slots slots, finishing the one that is
+   * going on first. The table latch must be held in write mode.
+   *
+   * @return the header page of the new table, pinned
+   */
+  auto StartResize(HashTableHeaderPage *header_page, size_t num_slots) -> HashTableHeaderPage *;
+
+  /** Adds num_blocks blocks to a table, to be allocated on first use. */
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
   auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
@@ -96,6 +159,7 @@ class LinearProbeHashTable {
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
+  bool unique_;
 
   // Readers includes inserts and removes, writer is only resize
   ReaderWriterLatch table_latch_;
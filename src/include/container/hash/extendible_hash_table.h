@@ -17,9 +17,8 @@
 
 #pragma once
 
-#include <list>
 #include <memory>
-#include <mutex>  // NOLINT
+#include <shared_mutex>
 #include <utility>
 #include <vector>
 
@@ -29,6 +28,10 @@ namespace bustub {
 
 /**
  * ExtendibleHashTable implements a hash table using the extendible hashing algorithm.
+ *
+ * The directory latch is only taken exclusively to split a bucket. Every other operation shares it and then latches
+ * the one bucket it touches, so lookups and updates of different buckets run in parallel.
+ *
  * @tparam K key type
  * @tparam V value type
  */
@@ -36,9 +39,6 @@ template <typename K, typename V>
 class ExtendibleHashTable : public HashTable<K, V> {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Create a new ExtendibleHashTable.
    * @param bucket_size: fixed size for each bucket
    */
@@ -64,16 +64,12 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto GetNumBuckets() const -> int;
 
   /**
-   * @brief Get the Buckets Size object
-   * 
-   * @return int 
+   * @brief Get the number of key-value pairs a bucket holds at most.
+   * @return The size of a bucket.
    */
   auto GetBucketsSize() const -> int;
 
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Find the value associated with the given key.
    *
    * Use IndexOf(key) to find the directory index the key hashes to.
@@ -85,9 +81,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto Find(const K &key, V &value) -> bool override;
 
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Insert the given key-value pair into the hash table.
    * If a key already exists, the value should be updated.
    * If the bucket is full and can't be inserted, do the following steps before retrying:
@@ -102,9 +95,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   void Insert(const K &key, const V &value) override;
 
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Given the key, remove the corresponding key-value pair in the hash table.
    * Shrink & Combination is not required for this project
    * @param key The key to be deleted.
@@ -114,13 +104,16 @@ class ExtendibleHashTable : public HashTable<K, V> {
 
   /**
    * Bucket class for each hash table bucket that the directory points to.
+   *
+   * The pairs are kept in one array that is allocated up front, so a lookup scans a few contiguous cache lines. The
+   * bucket does not latch itself; its latch is taken by the table, which has to hold the directory latch as well.
    */
-   public:
   class Bucket {
+   public:
     explicit Bucket(size_t size, int depth = 0);
 
     /** @brief Check if a bucket is full. */
-    inline auto IsFull() const -> bool { return list_.size() == size_; }
+    inline auto IsFull() const -> bool { return items_.size() == size_; }
 
     /** @brief Get the local depth of the bucket. */
     inline auto GetDepth() const -> int { return depth_; }
@@ -128,23 +121,20 @@ class ExtendibleHashTable : public HashTable<K, V> {
     /** @brief Increment the local depth of a bucket. */
     inline void IncrementDepth() { depth_++; }
 
-    inline auto GetItems() -> std::list<std::pair<K, V>> & { return list_; }
+    inline auto GetItems() -> std::vector<std::pair<K, V>> & { return items_; }
+
+    /** @brief The latch that guards the items of the bucket. */
+    inline auto GetLatch() const -> std::shared_mutex & { return latch_; }
 
     /**
-     *
-     * TODO(P1): Add implementation
-     *
      * @brief Find the value associated with the given key in the bucket.
      * @param key The key to be searched.
      * @param[out] value The value associated with the key.
      * @return True if the key is found, false otherwise.
      */
-    auto Find(const K &key, V &value) -> bool;
+    auto Find(const K &key, V &value) const -> bool;
 
     /**
-     *
-     * TODO(P1): Add implementation
-     *
      * @brief Given the key, remove the corresponding key-value pair in the bucket.
      * @param key The key to be deleted.
      * @return True if the key exists, false otherwise.
@@ -152,9 +142,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Remove(const K &key) -> bool;
 
     /**
-     *
-     * TODO(P1): Add implementation
-     *
      * @brief Insert the given key-value pair into the bucket.
      *      1. If a key already exists, the value should be updated.
      *      2. If the bucket is full, do nothing and return false.
@@ -165,29 +152,24 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Insert(const K &key, const V &value) -> bool;
 
    private:
-    // TODO(student): You may add additional private members and helper functions
     size_t size_;
     int depth_;
-    std::list<std::pair<K, V>> list_;
+    std::vector<std::pair<K, V>> items_;
+    mutable std::shared_mutex latch_;
   };
 
  private:
-  // TODO(student): You may add additional private members and helper functions and remove the ones
-  // you don't need.
-
   int global_depth_;    // The global depth of the directory
   size_t bucket_size_;  // The size of a bucket
   int num_buckets_;     // The number of buckets in the hash table
-  mutable std::mutex latch_;
+  mutable std::shared_mutex latch_;           // Shared by every operation, exclusive only to split a bucket
   std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
 
-  // The following functions are completely optional, you can delete them if you have your own ideas.
-
   /**
-   * @brief Redistribute the kv pairs in a full bucket.
+   * @brief Split a full bucket in two and point the directory entries of its upper half at the new bucket.
    * @param bucket The bucket to be redistributed.
    */
-  auto RedistributeBucket(std::shared_ptr<Bucket> bucket) -> void;
+  auto RedistributeBucket(const std::shared_ptr<Bucket> &bucket) -> void;
 
   /*****************************************************************
    * Must acquire latch_ first before calling the below functions. *
@@ -198,12 +180,11 @@ class ExtendibleHashTable : public HashTable<K, V> {
    * @param key The key to be hashed.
    * @return The entry index in the directory.
    */
-  auto IndexOf(const K &key) -> size_t;
+  auto IndexOf(const K &key) const -> size_t;
 
   auto GetGlobalDepthInternal() const -> int;
   auto GetLocalDepthInternal(int dir_index) const -> int;
   auto GetNumBucketsInternal() const -> int;
-  auto GetBucketsSizeInternal() const->int;
 };
 
 }  // namespace bustub
@@ -0,0 +1,324 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table.h
+//
+// Identification: src/include/container/hash/flat_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FlatHashTable is an in-memory open addressing hash table for the hash tables of the executors.
+ *
+ * The slot array only holds the full hash of a key and a pointer to its entry, so a probe compares hashes in one
+ * contiguous array and looks at a key only when the hashes match. Growing the slot array never hashes a key again.
+ * The entries live in an arena of fixed-size chunks; they never move, and pointers to them stay valid until Clear().
+ *
+ * A table built with more than one partition may be written by many threads at once. A key always goes to the same
+ * partition, and every partition has its own slot array, arena and latch. Iterating over the table must not overlap
+ * with writes. Tables with as many partitions put a key in the same partition, so a table built without latches may
+ * still be written by many threads, as long as each partition is written by one thread at a time.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ * @tparam Hash hash function of the keys
+ * @tparam KeyEqual equality of the keys
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatHashTable {
+ public:
+  /** The slot array of a partition grows once it is this full */
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
+  /** The number of entries that are allocated at once */
+  static constexpr size_t ENTRIES_PER_CHUNK = 256;
+
+  /**
+   * Create a new FlatHashTable.
+   * @param num_partitions the number of partitions, a power of two; with more than one, writes may be concurrent
+   * @param latched whether the writes of a partition take its latch
+   */
+  explicit FlatHashTable(size_t num_partitions = 1, bool latched = true)
+      : partitions_(num_partitions), latched_(latched) {
+    BUSTUB_ASSERT(num_partitions > 0 && (num_partitions & (num_partitions - 1)) == 0,
+                  "the number of partitions must be a power of two");
+    while ((static_cast<size_t>(1) << partition_bits_) < num_partitions) {
+      partition_bits_++;
+    }
+  }
+
+  FlatHashTable(const FlatHashTable &) = delete;
+  auto operator=(const FlatHashTable &) -> FlatHashTable & = delete;
+
+  ~FlatHashTable() { Clear(); }
+
+  /** @return Whether writes of the same partition may come from many threads at once */
+  auto IsConcurrent() const -> bool { return latched_ && partitions_.size() > 1; }
+
+  /** @return The number of partitions */
+  auto NumPartitions() const -> size_t { return partitions_.size(); }
+
+  /**
+   * Find the value of a key, or insert one built by `init` if the key is not there yet, and then pass it to `update`.
+   * Concurrent writers of the same key see each other's updates; `update` runs under the latch of the partition.
+   * @param key the key to be upserted
+   * @param init called without arguments for the initial value of a new key
+   * @param update called with a reference to the value of the key
+   */
+  template <typename Init, typename Update>
+  void Upsert(const K &key, Init &&init, Update &&update) {
+    auto hash = HashOf(key);
+    auto &partition = PartitionOf(hash);
+    std::optional<std::scoped_lock<std::mutex>> lock;
+    if (IsConcurrent()) {
+      lock.emplace(partition.latch_);
+    }
+    auto &slot = partition.FindSlot(hash, key, key_equal_);
+    auto *entry = slot.entry_ != nullptr ? slot.entry_ : partition.Emplace(&slot, hash, key, init());
+    update(entry->value_);
+  }
+
+  /**
+   * Insert a key and its value if the key is not there yet.
+   * @return `true` if the pair was inserted, `false` if the key was already there
+   */
+  auto Insert(const K &key, V value) -> bool {
+    bool inserted = false;
+    Upsert(
+        key,
+        [&]() {
+          inserted = true;
+          return std::move(value);
+        },
+        [](V &) {});
+    return inserted;
+  }
+
+  /**
+   * Find the value of a key. The table must not be written at the same time, but any number of threads may read it.
+   * @return A pointer to the value, or `nullptr` if the key is not there
+   */
+  auto Find(const K &key) const -> const V * {
+    auto hash = HashOf(key);
+    auto *entry = PartitionOf(hash).Lookup(hash, key, key_equal_);
+    return entry == nullptr ? nullptr : &entry->value_;
+  }
+
+  /** Find the value of a key to update it in place, see the const Find. */
+  auto Find(const K &key) -> V * {
+    auto hash = HashOf(key);
+    auto *entry = PartitionOf(hash).Lookup(hash, key, key_equal_);
+    return entry == nullptr ? nullptr : &entry->value_;
+  }
+
+  /** @return The number of keys in the table */
+  auto Size() const -> size_t {
+    size_t size = 0;
+    for (const auto &partition : partitions_) {
+      size += partition.size_;
+    }
+    return size;
+  }
+
+  /** Remove all keys. The slot arrays keep their size. */
+  void Clear() {
+    for (auto &partition : partitions_) {
+      partition.Clear();
+    }
+  }
+
+ private:
+  /** A key and its value, in the arena of a partition */
+  struct Entry {
+    K key_;
+    V value_;
+  };
+
+  /** A slot of the slot array, empty if it has no entry */
+  struct Slot {
+    uint64_t hash_;
+    Entry *entry_;
+  };
+
+  using EntryStorage = std::aligned_storage_t<sizeof(Entry), alignof(Entry)>;
+
+  struct Partition {
+    /** @return The slot of the key, or the empty slot where it would be inserted */
+    auto FindSlot(uint64_t hash, const K &key, const KeyEqual &key_equal) -> Slot & {
+      if (slots_.empty()) {
+        slots_.resize(16, Slot{0, nullptr});
+      }
+      size_t mask = slots_.size() - 1;
+      for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        auto &slot = slots_[i];
+        if (slot.entry_ == nullptr || (slot.hash_ == hash && key_equal(slot.entry_->key_, key))) {
+          return slot;
+        }
+      }
+    }
+
+    /** @return The entry of the key, or `nullptr` if it is not there. Never allocates the slot array. */
+    auto Lookup(uint64_t hash, const K &key, const KeyEqual &key_equal) const -> Entry * {
+      if (slots_.empty()) {
+        return nullptr;
+      }
+      size_t mask = slots_.size() - 1;
+      for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const auto &slot = slots_[i];
+        if (slot.entry_ == nullptr || (slot.hash_ == hash && key_equal(slot.entry_->key_, key))) {
+          return slot.entry_;
+        }
+      }
+    }
+
+    /** Construct a new entry in the arena for an empty slot. The slot is gone if the slot array grows. */
+    auto Emplace(Slot *slot, uint64_t hash, const K &key, V &&value) -> Entry * {
+      if (size_ % ENTRIES_PER_CHUNK == 0 && size_ / ENTRIES_PER_CHUNK == chunks_.size()) {
+        chunks_.emplace_back(new EntryStorage[ENTRIES_PER_CHUNK]);
+      }
+      auto *entry = new (&chunks_[size_ / ENTRIES_PER_CHUNK][size_ % ENTRIES_PER_CHUNK]) Entry{key, std::move(value)};
+      size_++;
+      *slot = Slot{hash, entry};
+      if (size_ > MAX_LOAD_FACTOR * slots_.size()) {
+        Grow();
+      }
+      return entry;
+    }
+
+    /** Double the slot array, placing every entry by the hash it was inserted with */
+    void Grow() {
+      std::vector<Slot> slots(2 * slots_.size(), Slot{0, nullptr});
+      size_t mask = slots.size() - 1;
+      for (const auto &slot : slots_) {
+        if (slot.entry_ == nullptr) {
+          continue;
+        }
+        size_t i = slot.hash_ & mask;
+        while (slots[i].entry_ != nullptr) {
+          i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+      }
+      slots_ = std::move(slots);
+    }
+
+    /** @return The i-th entry of the arena */
+    auto EntryAt(size_t i) -> Entry * {
+      return std::launder(reinterpret_cast<Entry *>(&chunks_[i / ENTRIES_PER_CHUNK][i % ENTRIES_PER_CHUNK]));
+    }
+
+    void Clear() {
+      for (size_t i = 0; i < size_; i++) {
+        EntryAt(i)->~Entry();
+      }
+      size_ = 0;
+      std::fill(slots_.begin(), slots_.end(), Slot{0, nullptr});
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<std::unique_ptr<EntryStorage[]>> chunks_;
+    size_t size_{0};
+    std::mutex latch_;
+  };
+
+ public:
+  /** An iterator over the keys of the table, in the order they were inserted into each partition */
+  class Iterator {
+   public:
+    Iterator(FlatHashTable *table, size_t partition_idx, size_t entry_idx)
+        : table_(table), partition_idx_(partition_idx), entry_idx_(entry_idx) {
+      SkipEmptyPartitions();
+    }
+
+    /** @return The key of the iterator */
+    auto Key() const -> const K & { return Current()->key_; }
+
+    /** @return The value of the iterator */
+    auto Val() const -> V & { return Current()->value_; }
+
+    /** @return The iterator after it is incremented */
+    auto operator++() -> Iterator & {
+      entry_idx_++;
+      SkipEmptyPartitions();
+      return *this;
+    }
+
+    /** @return `true` if both iterators are identical */
+    auto operator==(const Iterator &other) const -> bool {
+      return partition_idx_ == other.partition_idx_ && entry_idx_ == other.entry_idx_;
+    }
+
+    /** @return `true` if both iterators are different */
+    auto operator!=(const Iterator &other) const -> bool { return !(*this == other); }
+
+   private:
+    auto Current() const -> Entry * { return table_->partitions_[partition_idx_].EntryAt(entry_idx_); }
+
+    void SkipEmptyPartitions() {
+      while (partition_idx_ < table_->partitions_.size() && entry_idx_ == table_->partitions_[partition_idx_].size_) {
+        partition_idx_++;
+        entry_idx_ = 0;
+      }
+    }
+
+    FlatHashTable *table_;
+    size_t partition_idx_;
+    size_t entry_idx_;
+  };
+
+  /** @return Iterator to the first key of the table */
+  auto Begin() -> Iterator { return Iterator{this, 0, 0}; }
+
+  /** @return Iterator past the last key of the table */
+  auto End() -> Iterator { return Iterator{this, partitions_.size(), 0}; }
+
+  /** @return Iterator to the first key of a partition */
+  auto Begin(size_t partition) -> Iterator { return Iterator{this, partition, 0}; }
+
+  /** @return Iterator past the last key of a partition */
+  auto End(size_t partition) -> Iterator { return Iterator{this, partition + 1, 0}; }
+
+ private:
+  /** @return The hash of a key, mixed so that the partition and the slot can be taken from its bits */
+  auto HashOf(const K &key) const -> uint64_t {
+    auto hash = static_cast<uint64_t>(hash_(key));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /** @return The partition of a hash, chosen by its highest bits while the slots use the lowest ones */
+  auto PartitionOf(uint64_t hash) -> Partition & { return partitions_[PartitionIndexOf(hash)]; }
+  auto PartitionOf(uint64_t hash) const -> const Partition & { return partitions_[PartitionIndexOf(hash)]; }
+  auto PartitionIndexOf(uint64_t hash) const -> size_t {
+    return partition_bits_ == 0 ? 0 : hash >> (64 - partition_bits_);
+  }
+
+  std::vector<Partition> partitions_;
+  bool latched_;
+  uint32_t partition_bits_{0};
+  Hash hash_{};
+  KeyEqual key_equal_{};
+};
+
+}  // namespace bustub
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compare_kernels.h
+//
+// Identification: src/include/execution/compare_kernels.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/data_chunk.h"
+#include "type/value.h"
+
+namespace bustub {
+
+enum class ComparisonType;
+
+/**
+ * The comparison kernels compare the typed arrays of fixed-length columns many rows at a time, with AVX2 or SSE2
+ * where the build targets them, and produce the mask of the rows for which the comparison is true. A row that is null
+ * on either side is never selected.
+ */
+
+/**
+ * Compare two columns row by row.
+ * @param lhs The left column
+ * @param op The comparison
+ * @param rhs The right column, of the same fixed-length type and size as the left one
+ * @param[out] mask The rows where `lhs op rhs` is true
+ */
+void CompareColumns(const ColumnVector &lhs, ComparisonType op, const ColumnVector &rhs, SelectionMask *mask);
+
+/**
+ * Compare every row of a column with a constant.
+ * @param column The column
+ * @param op The comparison
+ * @param constant The constant, of the fixed-length type of the column
+ * @param[out] mask The rows where `column op constant` is true
+ */
+void CompareColumnConstant(const ColumnVector &column, ComparisonType op, const Value &constant, SelectionMask *mask);
+
+}  // namespace bustub
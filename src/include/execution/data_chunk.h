@@ -0,0 +1,267 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// data_chunk.h
+//
+// Identification: src/include/execution/data_chunk.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The indexes of the rows of a chunk or batch that are selected, ascending */
+using SelectionVector = std::vector<uint32_t>;
+
+/** One bit for each row of a chunk, in words of 64 rows, set if the row is selected; bits past the last row are 0 */
+using SelectionMask = std::vector<uint64_t>;
+
+/** @return Whether values of the type are kept in the typed array of a ColumnVector */
+inline auto IsFixedType(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+    case TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** Call `fn` with a null pointer to the C++ type that the typed array of a fixed-length type holds. */
+template <typename Fn>
+void DispatchFixedType(TypeId type, Fn &&fn) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      fn(static_cast<int8_t *>(nullptr));
+      break;
+    case TypeId::SMALLINT:
+      fn(static_cast<int16_t *>(nullptr));
+      break;
+    case TypeId::INTEGER:
+      fn(static_cast<int32_t *>(nullptr));
+      break;
+    case TypeId::BIGINT:
+      fn(static_cast<int64_t *>(nullptr));
+      break;
+    case TypeId::DECIMAL:
+      fn(static_cast<double *>(nullptr));
+      break;
+    case TypeId::TIMESTAMP:
+      fn(static_cast<uint64_t *>(nullptr));
+      break;
+    default:
+      UNREACHABLE("not a fixed-length type");
+  }
+}
+
+/**
+ * ColumnVector holds the values of one column for the rows of a DataChunk.
+ *
+ * Fixed-length types are stored in a typed array that Data<T>() exposes: int8_t for BOOLEAN and TINYINT, int16_t,
+ * int32_t and int64_t for the other integers, double for DECIMAL and uint64_t for TIMESTAMP. A BOOLEAN is 0 or 1.
+ * VARCHAR values are stored as strings. Nulls are kept in a bitmap, apart from the values; the value of a null row is
+ * unspecified.
+ */
+class ColumnVector {
+ public:
+  ColumnVector() = default;
+
+  /**
+   * Construct an empty column.
+   * @param type The type of the values
+   */
+  explicit ColumnVector(TypeId type) : type_(type) {}
+
+  /** @return The type of the values */
+  auto GetType() const -> TypeId { return type_; }
+
+  /** @return The number of rows */
+  auto Size() const -> size_t { return size_; }
+
+  /**
+   * Remove all rows, and change the type of the column.
+   * @param type The type of the values
+   */
+  void Reset(TypeId type);
+
+  /**
+   * Change the number of rows. New rows are not null, with unspecified values.
+   * @param size The number of rows
+   */
+  void Resize(size_t size);
+
+  /** @return The typed array of the values, see the class comment for which T goes with which type */
+  template <typename T>
+  auto Data() -> T * {
+    return reinterpret_cast<T *>(data_.data());
+  }
+  template <typename T>
+  auto Data() const -> const T * {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  /** @return The strings of a VARCHAR column */
+  auto Strings() -> std::vector<std::string> & { return strings_; }
+  auto Strings() const -> const std::vector<std::string> & { return strings_; }
+
+  /** @return Whether the value of a row is null */
+  auto IsNull(size_t row) const -> bool { return (nulls_[row / 64] >> (row % 64) & 1) != 0; }
+
+  /** Mark the value of a row as null or not null. */
+  void SetNull(size_t row, bool is_null) {
+    if (is_null) {
+      nulls_[row / 64] |= static_cast<uint64_t>(1) << (row % 64);
+    } else {
+      nulls_[row / 64] &= ~(static_cast<uint64_t>(1) << (row % 64));
+    }
+  }
+
+  /** @return `true` if no row is null */
+  auto HasNoNulls() const -> bool;
+
+  /** @return The words of the null bitmap, one bit per row */
+  auto NullWords() -> uint64_t * { return nulls_.data(); }
+  auto NullWords() const -> const uint64_t * { return nulls_.data(); }
+
+  /** Mark every row that is null in either column as null, and no other row. */
+  void UnionNulls(const ColumnVector &lhs, const ColumnVector &rhs) {
+    for (size_t i = 0; i < nulls_.size(); i++) {
+      nulls_[i] = lhs.nulls_[i] | rhs.nulls_[i];
+    }
+  }
+
+  /** @return The value of a row */
+  auto GetValue(size_t row) const -> Value;
+
+  /** Set the value of a row, which must have the type of the column. */
+  void SetValue(size_t row, const Value &value);
+
+  /**
+   * Make this column `size` copies of one value.
+   * @param value The value, which must have the type of the column
+   * @param size The number of rows
+   */
+  void Broadcast(const Value &value, size_t size);
+
+  /**
+   * Keep only the selected rows, in the order of the selection.
+   * @param selection The rows to keep, ascending
+   */
+  void Select(const SelectionVector &selection);
+
+  /** @return The size in bytes of a value in the typed array, 0 for VARCHAR */
+  static auto ValueWidth(TypeId type) -> size_t;
+
+ private:
+  TypeId type_{TypeId::INVALID};
+  size_t size_{0};
+  /** The typed array, in 8-byte words so that every type is aligned */
+  std::vector<uint64_t> data_;
+  std::vector<std::string> strings_;
+  /** One bit per row, set if the row is null */
+  std::vector<uint64_t> nulls_;
+};
+
+/**
+ * DataChunk is the columnar form of a batch of tuples: one ColumnVector per column of a schema, all with the same
+ * number of rows. Expressions evaluate a whole chunk at a time with AbstractExpression::EvaluateChunk().
+ */
+class DataChunk {
+ public:
+  DataChunk() = default;
+
+  /** @return The schema of the rows */
+  auto GetSchema() const -> const Schema * { return schema_; }
+
+  /** @return The number of rows */
+  auto Size() const -> size_t { return size_; }
+
+  /** @return The number of columns */
+  auto ColumnCount() const -> size_t { return columns_.size(); }
+
+  /** @return The i-th column */
+  auto Column(size_t i) -> ColumnVector & { return columns_[i]; }
+  auto Column(size_t i) const -> const ColumnVector & { return columns_[i]; }
+
+  /**
+   * Decode tuples into the columns of the chunk. Fixed-length columns are copied from the tuple data directly.
+   * @param tuples The tuples, in the format of the schema
+   * @param schema The schema of the tuples, which must outlive the chunk
+   */
+  void Load(const std::vector<Tuple> &tuples, const Schema *schema);
+
+  /** @return A row of the chunk as a tuple of the schema */
+  auto RowTuple(size_t row) const -> Tuple;
+
+  /**
+   * Keep only the selected rows, in the order of the selection.
+   * @param selection The rows to keep, ascending
+   */
+  void Select(const SelectionVector &selection);
+
+ private:
+  const Schema *schema_{nullptr};
+  size_t size_{0};
+  std::vector<ColumnVector> columns_;
+};
+
+/**
+ * Select the rows of a BOOLEAN column that are true.
+ * @param column The column
+ * @param[out] mask The rows that are true and not null
+ */
+void TrueMask(const ColumnVector &column, SelectionMask *mask);
+
+/**
+ * List the rows that a mask selects.
+ * @param mask The mask
+ * @param size The number of rows of the mask
+ * @param[out] selection The selected rows, ascending
+ */
+void MaskToSelection(const SelectionMask &mask, size_t size, SelectionVector *selection);
+
+/**
+ * Apply a binary operator to the typed arrays of two columns of the same size, row by row. A row of the result is null
+ * if it is null in either input. The operator also runs on null rows, whose values are unspecified.
+ * @tparam T The C++ type of the inputs
+ * @tparam R The C++ type of the result
+ * @param lhs The left input
+ * @param rhs The right input
+ * @param[out] result The result, which is resized to the inputs and must already have its type
+ * @param op Called with two T for each row, returning an R
+ */
+template <typename T, typename R, typename Op>
+void BinaryColumnOp(const ColumnVector &lhs, const ColumnVector &rhs, ColumnVector *result, Op op) {
+  size_t size = lhs.Size();
+  result->Resize(size);
+  const T *l = lhs.template Data<T>();
+  const T *r = rhs.template Data<T>();
+  R *out = result->template Data<R>();
+  for (size_t i = 0; i < size; i++) {
+    out[i] = op(l[i], r[i]);
+  }
+  result->UnionNulls(lhs, rhs);
+}
+
+}  // namespace bustub
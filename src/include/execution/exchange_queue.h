@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_queue.h
+//
+// Identification: src/include/execution/exchange_queue.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <utility>
+
+#include "common/config.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * ExchangeQueue hands batches of tuples from the producers of an exchange to its consumer. The queue is bounded, so
+ * producers that are ahead of the consumer wait instead of buffering their whole output. The queue passes whole
+ * batches, so its latch is taken once per batch rather than once per tuple.
+ */
+class ExchangeQueue {
+ public:
+  /**
+   * Create a queue.
+   * @param num_producers The number of producers that push into the queue
+   * @param capacity The number of batches that the queue holds at most
+   */
+  explicit ExchangeQueue(size_t num_producers, size_t capacity = EXCHANGE_QUEUE_BATCHES)
+      : num_producers_(num_producers), capacity_(capacity) {}
+
+  /**
+   * Push a batch, waiting while the queue is full.
+   * @return `false` if the queue was closed, and the batch was dropped
+   */
+  auto Push(TupleBatch &&batch) -> bool {
+    std::unique_lock lock(latch_);
+    not_full_.wait(lock, [&]() { return closed_ || batches_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    batches_.push_back(std::move(batch));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * Pop a batch, waiting while the queue is empty and some producer is not done.
+   * @param[out] batch The batch
+   * @return `false` if every producer is done and every batch was popped, or if the queue was closed
+   */
+  auto Pop(TupleBatch *batch) -> bool {
+    std::unique_lock lock(latch_);
+    not_empty_.wait(lock, [&]() { return closed_ || !batches_.empty() || num_producers_ == 0; });
+    if (closed_ || batches_.empty()) {
+      return false;
+    }
+    *batch = std::move(batches_.front());
+    batches_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /** Mark one producer as done; the consumer sees the end of the queue once all of them are. */
+  void ProducerDone() {
+    std::scoped_lock lock(latch_);
+    if (--num_producers_ == 0) {
+      not_empty_.notify_all();
+    }
+  }
+
+  /** Wake every producer and consumer, and drop the batches. Used to stop an exchange before its end. */
+  void Close() {
+    std::scoped_lock lock(latch_);
+    closed_ = true;
+    batches_.clear();
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  std::mutex latch_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<TupleBatch> batches_;
+  size_t num_producers_;
+  const size_t capacity_;
+  bool closed_{false};
+};
+
+}  // namespace bustub
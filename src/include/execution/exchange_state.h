@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_state.h
+//
+// Identification: src/include/execution/exchange_state.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "execution/exchange_queue.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/repartition_plan.h"
+
+namespace bustub {
+
+/**
+ * RepartitionExchange is the state that the instances of a repartition share on the workers of a gather: the
+ * producers that run the child of the repartition on their own threads, and one queue per partition, which the
+ * instance on the worker of the same index consumes.
+ */
+class RepartitionExchange {
+ public:
+  /**
+   * Create the exchange.
+   * @param plan The repartition plan
+   * @param producers The executors of the child of the repartition, one per producer
+   */
+  RepartitionExchange(const RepartitionPlanNode *plan, std::vector<std::unique_ptr<AbstractExecutor>> producers);
+
+  /** Stop the producers. */
+  ~RepartitionExchange();
+
+  DISALLOW_COPY_AND_MOVE(RepartitionExchange);
+
+  /** Start the threads of the producers. */
+  void Start();
+
+  /** Stop the exchange before its end: the producers and the consumers see closed queues. */
+  void Cancel();
+
+  /** Wait for the threads of the producers. */
+  void Join();
+
+  /**
+   * Pop the next batch of a partition, waiting for the producers.
+   * @param partition The partition
+   * @param[out] batch The batch
+   * @return `false` if the partition has no more tuples; rethrows the error of a producer that failed
+   */
+  auto Pop(size_t partition, TupleBatch *batch) -> bool;
+
+ private:
+  /** Run a producer, routing every tuple of its child to the queue of its partition. */
+  void Produce(size_t producer);
+
+  /** @return The partition of a tuple of the child */
+  auto PartitionOf(const Tuple &tuple, const Schema &schema) const -> size_t;
+
+  const RepartitionPlanNode *plan_;
+  std::vector<std::unique_ptr<AbstractExecutor>> producers_;
+  std::vector<std::unique_ptr<ExchangeQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::mutex error_latch_;
+  std::exception_ptr error_;
+};
+
+/**
+ * ExchangeState is the state that the workers of a gather share: the executor context of each worker, the morsels of
+ * the scans that the workers split, and the repartitions below the gather. The gather builds it on its own thread
+ * before any worker starts.
+ */
+class ExchangeState {
+ public:
+  /**
+   * Create the state of a gather.
+   * @param exec_ctx The executor context of the gather
+   * @param num_workers The number of workers of the gather, and of partitions of every repartition below it
+   */
+  ExchangeState(ExecutorContext *exec_ctx, size_t num_workers) : exec_ctx_(exec_ctx), num_workers_(num_workers) {}
+
+  /** Stop the repartitions. */
+  ~ExchangeState();
+
+  DISALLOW_COPY_AND_MOVE(ExchangeState);
+
+  /** @return The number of workers of the gather */
+  auto NumWorkers() const -> size_t { return num_workers_; }
+
+  /**
+   * Create the executor context of a worker, or of a producer of a repartition, whose executors split their scans
+   * with the other workers through this state.
+   * @param worker The index of the worker
+   * @return The context, owned by the state
+   */
+  auto MakeWorkerContext(size_t worker) -> ExecutorContext *;
+
+  /**
+   * @return The morsels of a sequential or mock scan, shared by all the instances of the scan, or nullptr for a
+   * shuffled mock table, which cannot be split
+   */
+  auto MorselsOf(const AbstractPlanNode *scan) -> std::shared_ptr<MorselQueue>;
+
+  /** @return The exchange shared by all the instances of a repartition, with its producers built on first use */
+  auto RepartitionOf(const RepartitionPlanNode *plan) -> RepartitionExchange *;
+
+  /** Start the producers of every repartition. */
+  void Start();
+
+  /** Stop every repartition before its end. */
+  void Cancel();
+
+ private:
+  ExecutorContext *exec_ctx_;
+  const size_t num_workers_;
+  std::vector<std::unique_ptr<ExecutorContext>> contexts_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<MorselQueue>> morsels_;
+  std::unordered_map<const AbstractPlanNode *, std::unique_ptr<RepartitionExchange>> repartitions_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <iterator>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -84,11 +85,12 @@ class ExecutionEngine {
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
                            std::vector<Tuple> *result_set) {
-    RID rid{};
-    Tuple tuple{};
-    while (executor->Next(&tuple, &rid)) {
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
       if (result_set != nullptr) {
-        result_set->push_back(tuple);
+        auto &tuples = batch.GetTuples();
+        result_set->insert(result_set->end(), std::make_move_iterator(tuples.begin()),
+                           std::make_move_iterator(tuples.end()));
       }
     }
   }
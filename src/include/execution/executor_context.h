@@ -18,9 +18,14 @@
 
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
+#include "execution/memory_budget.h"
+#include "execution/worker_pool.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+class ExchangeState;
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -60,6 +65,45 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /**
+   * Let the executors run parallel pipelines.
+   * @param pool The pool that runs the workers
+   * @param max_workers The number of workers of a pipeline at most, counting the thread of the executor
+   */
+  void SetWorkerPool(WorkerPool *pool, size_t max_workers) {
+    worker_pool_ = pool;
+    max_parallel_workers_ = max_workers;
+  }
+
+  /** @return the pool that runs the workers of parallel pipelines, or nullptr if the query runs on one thread */
+  auto GetWorkerPool() -> WorkerPool * { return worker_pool_; }
+
+  /** @return the number of workers of a parallel pipeline at most */
+  auto GetMaxParallelWorkers() const -> size_t { return worker_pool_ == nullptr ? 1 : max_parallel_workers_; }
+
+  /** @return The memory budget of the query */
+  auto GetMemoryBudget() -> MemoryBudget * { return memory_budget_; }
+
+  /** @param budget The memory budget shared with the context of the query that this context is a worker of */
+  void SetMemoryBudget(MemoryBudget *budget) { memory_budget_ = budget; }
+
+  /**
+   * Make the executors of this context one worker of a gather: their scans split the table with the other workers,
+   * and their repartitions receive one partition.
+   * @param exchange The state shared by the workers of the gather
+   * @param worker The index of the worker
+   */
+  void SetExchange(ExchangeState *exchange, size_t worker) {
+    exchange_ = exchange;
+    exchange_worker_ = worker;
+  }
+
+  /** @return the state of the gather that the executors are a worker of, or nullptr */
+  auto GetExchange() -> ExchangeState * { return exchange_; }
+
+  /** @return the index of the worker of the gather */
+  auto GetExchangeWorker() const -> size_t { return exchange_worker_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +115,18 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The pool that runs the workers of parallel pipelines */
+  WorkerPool *worker_pool_{nullptr};
+  /** The number of workers of a parallel pipeline at most */
+  size_t max_parallel_workers_{1};
+  /** The memory budget of the query, unless the context is a worker of another one */
+  MemoryBudget query_memory_budget_;
+  /** The memory budget that the executors reserve from */
+  MemoryBudget *memory_budget_{&query_memory_budget_};
+  /** The state of the gather that the executors are a worker of */
+  ExchangeState *exchange_{nullptr};
+  /** The index of the worker of the gather */
+  size_t exchange_worker_{0};
 };
 
 }  // namespace bustub
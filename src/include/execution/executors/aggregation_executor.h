@@ -12,13 +12,15 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
+#include "container/hash/flat_hash_table.h"
 #include "container/hash/hash_function.h"
+#include "execution/data_chunk.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -28,6 +30,24 @@
 
 namespace bustub {
 
+/**
+ * The running state of one aggregate of a group. It is typed by the input of the aggregate, so that combining a row
+ * adds or compares a C++ number instead of building and combining Values.
+ */
+struct AggregateSlot {
+  /** Whether the aggregate is still null, as it has not seen a non-null input yet */
+  bool null_{true};
+  /** The count, or the sum, minimum or maximum of an integer input */
+  int64_t integer_{0};
+  /** The sum, minimum or maximum of a DECIMAL input */
+  double decimal_{0};
+  /** The sum, minimum or maximum of an input of another type */
+  Value value_;
+};
+
+/** The running state of the aggregates of a group, one slot per aggregate */
+using AggregateState = std::vector<AggregateSlot>;
+
 /**
  * A simplified hash table that has all the necessary functionality for aggregations.
  */
@@ -37,80 +57,79 @@ class SimpleAggregationHashTable {
    * Construct a new SimpleAggregationHashTable instance.
    * @param agg_exprs the aggregation expressions
    * @param agg_types the types of aggregations
+   * @param num_partitions the number of partitions of the table; tables with as many partitions put a group in the
+   * same partition, and different partitions may be written by different threads at once
    */
   SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-  /** @return The initial aggregrate value for this aggregation executor */
-  auto GenerateInitialAggregateValue() -> AggregateValue {
-    std::vector<Value> values{};
-    for (const auto &agg_type : agg_types_) {
-      switch (agg_type) {
-        case AggregationType::CountStarAggregate:
-          // Count start starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          // Others starts at null.
-          values.emplace_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
-          break;
-      }
+                             const std::vector<AggregationType> &agg_types, size_t num_partitions = 1)
+      : ht_{num_partitions, false}, agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
+
+  /** @return The state of the aggregates before any input */
+  auto GenerateInitialAggregateState() const -> AggregateState {
+    AggregateState state(agg_types_.size());
+    for (uint32_t i = 0; i < agg_types_.size(); i++) {
+      // Count star starts at zero, and the others start at null.
+      state[i].null_ = agg_types_[i] != AggregationType::CountStarAggregate;
     }
-    return {values};
+    return state;
   }
 
   /**
-   * TODO(Student)
-   *
-   * Combines the input into the aggregation result.
-   * @param[out] result The output aggregate value
-   * @param input The input value
+   * Find the state of a group, or insert its initial state if the group is new.
+   * @param agg_key the key of the group
+   * @return The state of the group; it stays valid until the table is cleared
    */
-  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountStarAggregate:
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          break;
-      }
-    }
+  auto FindOrInsert(const AggregateKey &agg_key) -> AggregateState * {
+    AggregateState *state = nullptr;
+    ht_.Upsert(
+        agg_key, [&]() { return GenerateInitialAggregateState(); }, [&](AggregateState &found) { state = &found; });
+    return state;
   }
 
   /**
-   * Inserts a value into the hash table and then combines it with the current aggregation.
-   * @param agg_key the key to be inserted
-   * @param agg_val the value to be inserted
+   * Combines the input of an aggregate for a chunk of rows into the states of their groups.
+   * @param agg_idx the index of the aggregate
+   * @param input the input of the aggregate for every row; not read by COUNT(*)
+   * @param states the state of the group of every row
    */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
-    }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
-  }
+  void CombineAggregateColumn(uint32_t agg_idx, const ColumnVector &input, const std::vector<AggregateState *> &states);
+
+  /**
+   * Inserts the partial aggregation of a group into the hash table and then merges it with the current aggregation.
+   * @param agg_key the key of the group
+   * @param partial the partial state of the group
+   */
+  void InsertMerge(const AggregateKey &agg_key, const AggregateState &partial);
+
+  /**
+   * Append the results of the aggregates of a group.
+   * @param state the state of the group
+   * @param[out] values the values to append to
+   */
+  void FinalizeAggregateState(const AggregateState &state, std::vector<Value> *values) const;
 
   /**
    * Clear the hash table
    */
-  void Clear() { ht_.clear(); }
+  void Clear() { ht_.Clear(); }
+
+  /** @return The number of groups in the hash table */
+  auto Size() const -> size_t { return ht_.Size(); }
+
+  /** @return The number of partitions of the hash table */
+  auto NumPartitions() const -> size_t { return ht_.NumPartitions(); }
 
   /** An iterator over the aggregation hash table */
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    explicit Iterator(FlatHashTable<AggregateKey, AggregateState>::Iterator iter) : iter_{iter} {}
 
     /** @return The key of the iterator */
-    auto Key() -> const AggregateKey & { return iter_->first; }
+    auto Key() -> const AggregateKey & { return iter_.Key(); }
 
     /** @return The value of the iterator */
-    auto Val() -> const AggregateValue & { return iter_->second; }
+    auto Val() -> const AggregateState & { return iter_.Val(); }
 
     /** @return The iterator before it is incremented */
     auto operator++() -> Iterator & {
@@ -126,18 +145,24 @@ class SimpleAggregationHashTable {
 
    private:
     /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    FlatHashTable<AggregateKey, AggregateState>::Iterator iter_;
   };
 
   /** @return Iterator to the start of the hash table */
-  auto Begin() -> Iterator { return Iterator{ht_.cbegin()}; }
+  auto Begin() -> Iterator { return Iterator{ht_.Begin()}; }
 
   /** @return Iterator to the end of the hash table */
-  auto End() -> Iterator { return Iterator{ht_.cend()}; }
+  auto End() -> Iterator { return Iterator{ht_.End()}; }
+
+  /** @return Iterator to the start of a partition of the hash table */
+  auto Begin(size_t partition) -> Iterator { return Iterator{ht_.Begin(partition)}; }
+
+  /** @return Iterator to the end of a partition of the hash table */
+  auto End(size_t partition) -> Iterator { return Iterator{ht_.End(partition)}; }
 
  private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  /** The hash table is just a map from aggregate keys to aggregate states */
+  FlatHashTable<AggregateKey, AggregateState> ht_;
   /** The aggregate expressions that we have */
   const std::vector<AbstractExpressionRef> &agg_exprs_;
   /** The types of aggregations that we have */
@@ -147,6 +172,11 @@ class SimpleAggregationHashTable {
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * The input is aggregated a batch at a time: the group-bys and the inputs of the aggregates are evaluated over the
+ * columns of the batch, and every aggregate is combined into the states of the groups with one typed loop. When the
+ * child may run in parallel, the aggregation has two phases: every worker aggregates its own tuples into a local table
+ * without latches, and then the workers merge the local tables one partition at a time, each partition on one worker.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -177,34 +207,40 @@ class AggregationExecutor : public AbstractExecutor {
   auto GetChildExecutor() const -> const AbstractExecutor *;
 
  private:
-  /** @return The tuple as an AggregateKey */
-  auto MakeAggregateKey(const Tuple *tuple) -> AggregateKey {
-    std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {keys};
-  }
+  /** The columns of a batch of input tuples, and the states of their groups */
+  struct BatchScratch {
+    DataChunk chunk_;
+    std::vector<ColumnVector> group_bys_;
+    std::vector<ColumnVector> aggregates_;
+    AggregateKey key_;
+    std::vector<AggregateState *> states_;
+  };
 
-  /** @return The tuple as an AggregateValue */
-  auto MakeAggregateValue(const Tuple *tuple) -> AggregateValue {
-    std::vector<Value> vals;
-    for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {vals};
-  }
+  /** Aggregate the child on the workers of the pool. @return `false` if the child cannot run in parallel */
+  auto ParallelAggregate() -> bool;
+
+  /**
+   * Combine a batch of input tuples into the groups of a table.
+   * @param tuples The input tuples
+   * @param table The table to aggregate into
+   * @param scratch The buffers of the batch, reused from batch to batch
+   */
+  void AggregateBatch(const std::vector<Tuple> &tuples, SimpleAggregationHashTable *table,
+                      BatchScratch *scratch) const;
+
+  /** Call `task` with every index from 0 to num_tasks - 1, on the workers of the pool when there is one */
+  void ParallelFor(size_t num_tasks, const std::function<void(size_t)> &task);
 
  private:
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table */
-  // TODO(Student): Uncomment 
+  /** Simple aggregation hash table, partitioned when the workers of a parallel aggregation merge into it */
   SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment 
   SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** Whether the single row of an aggregation without groups over no input has been produced */
+  bool empty_output_done_{false};
 };
 }  // namespace bustub
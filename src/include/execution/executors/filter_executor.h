@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "execution/data_chunk.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/filter_plan.h"
@@ -48,6 +49,13 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the filter.
+   * @param[out] batch The next tuples produced by the filter
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -57,5 +65,12 @@ class FilterExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The columnar form of the batch that is being filtered */
+  DataChunk chunk_;
+  /** The tuples of the batch for which the predicate is true */
+  SelectionMask mask_;
+  /** The indexes of the tuples of a batch that pass the filter */
+  SelectionVector selection_;
 };
 }  // namespace bustub
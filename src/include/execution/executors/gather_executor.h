@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "execution/exchange_queue.h"
+#include "execution/exchange_state.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/gather_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * GatherExecutor runs an instance of its child plan on each of its workers, every worker on its own thread, and
+ * produces the tuples of all of them as they arrive through a bounded queue.
+ *
+ * The instances are built by the executor factory like any other executors, in executor contexts that make their
+ * scans and repartitions share the work with the other workers, so that none of the executors needs to know that it
+ * runs in parallel.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new GatherExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The gather plan to be executed
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan);
+
+  /** Stop the workers. */
+  ~GatherExecutor() override;
+
+  /** Build the instances of the child plan, and start the workers */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the gather.
+   * @param[out] tuple The next tuple produced by the workers
+   * @param[out] rid The next tuple RID produced by the workers
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch of tuples from the gather, as one of the workers produced it.
+   * @param[out] batch The next tuples produced by the workers
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema for the gather */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** Run the instance of a worker until its end, or until the gather stops. */
+  void RunWorker(size_t worker);
+
+  /** Stop the workers and the repartitions below, and wait for their threads. */
+  void Stop();
+
+  /** The gather plan node to be executed */
+  const GatherPlanNode *plan_;
+  /** The state shared by the workers */
+  std::unique_ptr<ExchangeState> exchange_;
+  /** The instance of the child plan of every worker */
+  std::vector<std::unique_ptr<AbstractExecutor>> workers_;
+  /** The batches that the workers produced */
+  std::unique_ptr<ExchangeQueue> queue_;
+  /** The threads of the workers */
+  std::vector<std::thread> threads_;
+  /** The first error of a worker, rethrown to the consumer */
+  std::exception_ptr error_;
+  std::mutex error_latch_;
+  /** The batch that Next() produces tuples from */
+  TupleBatch batch_;
+  /** The index of the next tuple in `batch_` */
+  size_t batch_idx_{0};
+};
+
+}  // namespace bustub
@@ -12,18 +12,36 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <utility>
+#include <vector>
 
+#include "container/hash/flat_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes a hash JOIN on two tables.
+ *
+ * The right child is read into a hash table on its join key, and the tuples of the left child probe it one by one.
+ *
+ * A large right child would make every probe a cache miss, so from RADIX_JOIN_MIN_ROWS right tuples on, the join is
+ * radix-partitioned instead: both children are read and split by their key hashes in two passes, into partitions
+ * whose hash tables fit in cache, and every pair of partitions is joined on its own, on the workers of the pool when
+ * the query may run in parallel.
+ *
+ * The children are read within the memory budget of the query. Once a child exceeds it, the join turns into a Grace
+ * hash join: both children are split by their key hashes into partitions spilled to temporary pages, and the pairs of
+ * partitions are joined one at a time, each with a hash table of its right tuples. A partition whose right tuples
+ * still exceed the budget is split again, GRACE_MAX_LEVELS times at most.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -37,6 +55,8 @@ class HashJoinExecutor : public AbstractExecutor {
   HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
 
+  ~HashJoinExecutor() override;
+
   /** Initialize the join */
   void Init() override;
 
@@ -48,12 +68,167 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** A tuple of either child, with its join key and the hash of the key that partitions it */
+  struct RadixTuple {
+    uint64_t hash_;
+    Value key_;
+    Tuple tuple_;
+  };
+
+  /** The tuples of a child, as the workers that read it produced them, one chunk per worker */
+  using RadixChunks = std::vector<std::vector<RadixTuple>>;
+
+  /** The tuples of a child spilled to temporary pages, split by their key hashes */
+  struct SpillPartitions {
+    SpillPartitions(BufferPoolManager *bpm, uint32_t level);
+
+    /** Append a tuple to the partition of its hash. Workers may add tuples at once. */
+    void Add(uint64_t hash, const Tuple &tuple);
+
+    /** Write out the buffered tuples of every partition, so that the partitions can be read. */
+    void Finish();
+
+    /** The partitions, as temporary files */
+    std::vector<std::unique_ptr<TmpTupleFile>> files_;
+    /** The memory that the tuples of every partition take when they are read back */
+    std::vector<size_t> bytes_;
+    /** A latch for every partition */
+    std::vector<std::mutex> latches_;
+    /** The number of times the tuples were split before */
+    uint32_t level_;
+    /** Whether the child exceeded the memory budget, so that all of its tuples go to the partitions */
+    std::atomic<bool> spilling_{false};
+  };
+
+  /** A pair of spilled partitions of the same key hashes, to join with each other */
+  struct GracePartition {
+    std::unique_ptr<TmpTupleFile> left_;
+    std::unique_ptr<TmpTupleFile> right_;
+    /** The memory that the right tuples take when they are read back */
+    size_t right_bytes_{0};
+    /** The number of times the tuples were split */
+    uint32_t level_{0};
+  };
+
+  /** @return The memory that a tuple takes once it is read into the join */
+  static auto MemoryOf(const Tuple &tuple) -> size_t { return sizeof(RadixTuple) + tuple.GetLength(); }
+
+  /**
+   * Read all tuples of a child, with their join keys, on the workers of the pool when it can run in parallel. The
+   * tuples are reserved from the memory budget; once it is exceeded, they are added to the spilled partitions instead.
+   * @param executor The child executor
+   * @param child_plan The plan of the child
+   * @param key_expr The join key of the child
+   * @param skip_null_keys Whether to leave out the tuples with a null key
+   * @param spill The partitions to spill the tuples to
+   * @return The tuples that were not spilled
+   */
+  auto Materialize(AbstractExecutor *executor, const AbstractPlanNodeRef &child_plan,
+                   const AbstractExpression &key_expr, bool skip_null_keys, SpillPartitions *spill) -> RadixChunks;
+
+  /** Join the left and the right tuples partition by partition, into `radix_output_` */
+  void RadixJoin(RadixChunks left, RadixChunks right);
+
+  /**
+   * Split the tuples of all chunks by some bits of their hashes, in parallel over the chunks.
+   * @param chunks The tuples; they are moved out
+   * @param bits The number of hash bits that choose the partition
+   * @param shift The hash bits below the ones that choose the partition
+   * @param[out] out The tuples, ordered by partition
+   * @param[out] bounds The index in `out` of the first tuple of every partition, and then the size of `out`
+   */
+  void PartitionChunks(RadixChunks *chunks, uint32_t bits, uint32_t shift, std::vector<RadixTuple> *out,
+                       std::vector<size_t> *bounds);
+
+  /**
+   * Join a partition of the left tuples with the partition of the right tuples of the same hashes.
+   * @param left The left tuples of the partition
+   * @param left_size The number of left tuples
+   * @param right The right tuples of the partition
+   * @param right_size The number of right tuples
+   * @param bits The number of hash bits that split the partition further, into cache-sized ones
+   * @param shift The hash bits below the ones of the partition
+   * @param[out] output The joined tuples
+   */
+  void JoinPartition(RadixTuple *left, size_t left_size, RadixTuple *right, size_t right_size, uint32_t bits,
+                     uint32_t shift, std::vector<Tuple> *output) const;
+
+  /** Add the tuples of the chunks to the spilled partitions. */
+  static void SpillChunks(RadixChunks *chunks, SpillPartitions *spill);
+
+  /** Give back the memory of the tuples read so far, and join the spilled partitions one pair at a time. */
+  void StartGrace(SpillPartitions *left, SpillPartitions *right);
+
+  /** Queue the pairs of spilled partitions to join. */
+  void PushGracePartitions(SpillPartitions *left, SpillPartitions *right);
+
+  /** Split a pair of spilled partitions again, by the next bits of their hashes. */
+  void Repartition(GracePartition partition);
+
+  /** Read the right tuples of the next pair of spilled partitions into the hash table. @return `false` if none left */
+  auto NextGracePartition() -> bool;
+
+  /** Call `task` with every index from 0 to num_tasks - 1, on the workers of the pool when there is one */
+  void ParallelFor(size_t num_tasks, const std::function<void(size_t)> &task);
+
+  /** Move on to the next left tuple and look up its matches. @return `false` if there are no more left tuples */
+  auto NextLeft() -> bool;
+
+  /** Produce the next joined tuple. @return `false` if the join is done */
+  auto NextJoined(Tuple *tuple) -> bool;
+
+  /** @return The left tuple joined with a right one, or with nulls if there is none */
+  auto MakeOutputTuple(const Tuple &left, const Tuple *right) const -> Tuple;
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The child executor of the probe side */
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  /** The child executor of the build side */
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The right tuples by their join key */
+  FlatHashTable<HashJoinKey, std::vector<Tuple>> ht_;
+  /** The batch of left tuples that is being probed */
+  TupleBatch left_batch_;
+  /** The index of the next left tuple in `left_batch_` */
+  size_t left_idx_{0};
+  /** The index of the left tuple that is being joined in `left_batch_` */
+  size_t cur_left_{0};
+  /** The right tuples with the join key of the left tuple, `nullptr` if there are none */
+  const std::vector<Tuple> *matches_{nullptr};
+  /** The next right tuple in `matches_` */
+  size_t match_idx_{0};
+  /** Whether there is a left tuple being joined */
+  bool has_left_{false};
+  /** The memory reserved from the budget of the query for the tuples that the join holds */
+  size_t memory_reserved_{0};
+  /** Whether the join spilled its children, and joins the pairs of `grace_partitions_` */
+  bool grace_{false};
+  /** The pairs of spilled partitions that are left to join */
+  std::vector<GracePartition> grace_partitions_;
+  /** The pair of spilled partitions that is being joined */
+  GracePartition grace_current_;
+  /** The reader of the left partition that is being joined */
+  std::unique_ptr<TmpTupleFile::Reader> grace_reader_;
+  /** Whether the join was radix-partitioned, and produces the tuples of `radix_output_` */
+  bool radix_{false};
+  /** The joined tuples of every partition of a radix-partitioned join */
+  std::vector<std::vector<Tuple>> radix_output_;
+  /** The partition of `radix_output_` that is being produced */
+  size_t output_partition_{0};
+  /** The next tuple of the partition that is being produced */
+  size_t output_idx_{0};
 };
 
 }  // namespace bustub
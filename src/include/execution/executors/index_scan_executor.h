@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -42,11 +45,34 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** @return the key tuple for a bound of the scan range, if the bound is set */
+  auto MakeKeyTuple(const std::optional<Value> &bound) const -> std::optional<Tuple>;
+  /** @return the b+ tree key for a bound of the scan range, if the bound is set */
+  template <typename KeyType>
+  static auto MakeTreeKey(const std::optional<Tuple> &key_tuple) -> std::optional<KeyType> {
+    if (!key_tuple.has_value()) {
+      return std::nullopt;
+    }
+    KeyType key;
+    key.SetFromKey(*key_tuple);
+    return key;
+  }
+  /** @return an output tuple holding the columns stored in a b+ tree entry, the other columns are null */
+  template <typename KeyType>
+  auto TupleFromEntry(const KeyType &entry) const -> Tuple;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
-  const IndexInfo * index_info_;
-  const TableInfo* table_info_;
-  BPlusTreeIndexForOneIntegerColumn *tree_;
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *table_info_{nullptr};
+  /** Set when scanning a b+ tree index, which is walked lazily through the iterator. */
+  BPlusTreeIndexForOneIntegerColumn *tree_{nullptr};
   BPlusTreeIndexIteratorForOneIntegerColumn iterator_;
+  /** Set when scanning a b+ tree index with included columns instead. */
+  BPlusTreeCoveringIndexForOneIntegerColumn *covering_tree_{nullptr};
+  BPlusTreeCoveringIndexIteratorForOneIntegerColumn covering_iterator_;
+  /** Otherwise (art and hash indexes) the RIDs in range are collected up front. */
+  std::vector<RID> rids_;
+  size_t rid_idx_{0};
 };
 }  // namespace bustub
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -38,6 +40,17 @@ class MockScanExecutor : public AbstractExecutor {
    */
   MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan);
 
+  /**
+   * Construct a new MockScanExecutor instance for one worker of a parallel scan.
+   * @param exec_ctx The executor context
+   * @param plan The mock scan plan to be executed
+   * @param morsels The rows of the table, shared by the workers of the scan
+   */
+  MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, std::shared_ptr<MorselQueue> morsels);
+
+  /** @return A queue over the rows of the table for the workers of a parallel scan, or nullptr if it is shuffled */
+  static auto MakeMorselQueue(const MockScanPlanNode *plan) -> std::shared_ptr<MorselQueue>;
+
   /** Initialize the mock scan. */
   void Init() override;
 
@@ -71,6 +84,12 @@ class MockScanExecutor : public AbstractExecutor {
   /** The cursor for the current mock scan */
   std::size_t cursor_{0};
 
+  /** The row past the rows that the scan may produce, the end of the current morsel for a parallel scan */
+  std::size_t end_{0};
+
+  /** The rows that the workers of a parallel scan take, or nullptr if the scan produces all of them */
+  std::shared_ptr<MorselQueue> morsels_;
+
   /** The table function */
   std::function<Tuple(std::size_t)> func_;
 
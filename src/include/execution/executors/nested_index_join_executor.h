@@ -48,7 +48,29 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Number of outer tuples whose keys are looked up in the index together. */
+  static constexpr size_t BATCH_SIZE = 256;
+
+  /** Pull the next batch of outer tuples and probe the index for all of them at once. */
+  auto FetchBatch() -> bool;
+
+  /** @return the output tuple for `outer` joined with `inner`, or with nulls if `inner` is nullptr */
+  auto MakeOutputTuple(const Tuple &outer, const Tuple *inner) const -> Tuple;
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The outer table. */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *inner_table_info_{nullptr};
+
+  /** The current batch of outer tuples, and the inner RIDs matching each of them. */
+  std::vector<Tuple> outer_tuples_;
+  std::vector<std::vector<RID>> matches_;
+  /** Cursor into the batch: the outer tuple and its next match to join. */
+  size_t outer_idx_{0};
+  size_t match_idx_{0};
+  /** Whether the current outer tuple has been joined with anything yet, for left joins. */
+  bool outer_matched_{false};
 };
 }  // namespace bustub
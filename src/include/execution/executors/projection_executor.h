@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "execution/data_chunk.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/projection_plan.h"
@@ -47,6 +48,13 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the projection.
+   * @param[out] batch The next tuples produced by the projection
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +64,14 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The batch of the child that is being projected */
+  TupleBatch child_batch_;
+  /** Whether the expressions are evaluated on whole batches with AbstractExpression::EvaluateChunk() */
+  bool vectorized_{false};
+  /** The columnar form of the child batch */
+  DataChunk chunk_;
+  /** The value of every expression for the child batch */
+  std::vector<ColumnVector> columns_;
 };
 }  // namespace bustub
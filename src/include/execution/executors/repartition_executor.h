@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_executor.h
+//
+// Identification: src/include/execution/executors/repartition_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "execution/exchange_state.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/repartition_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * RepartitionExecutor produces one partition of the output of its child, the one of the worker of the gather that it
+ * runs on. The producers of the child are shared by the instances on all the workers; see RepartitionExchange.
+ * Outside of a gather, it produces the output of its child as it is.
+ */
+class RepartitionExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new RepartitionExecutor instance for a worker of a gather.
+   * @param exec_ctx The executor context of the worker
+   * @param plan The repartition plan to be executed
+   * @param exchange The exchange shared by the instances of the repartition
+   */
+  RepartitionExecutor(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan, RepartitionExchange *exchange)
+      : AbstractExecutor(exec_ctx), plan_(plan), exchange_(exchange) {}
+
+  /**
+   * Construct a new RepartitionExecutor instance outside of a gather.
+   * @param exec_ctx The executor context
+   * @param plan The repartition plan to be executed
+   * @param child The child executor, whose tuples are passed through
+   */
+  RepartitionExecutor(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan,
+                      std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)) {}
+
+  /** Initialize the repartition. The partition of a worker can only be produced once. */
+  void Init() override;
+
+  /**
+   * Yield the next tuple of the partition.
+   * @param[out] tuple The next tuple of the partition
+   * @param[out] rid The next tuple RID of the partition
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch of the partition.
+   * @param[out] batch The next tuples of the partition
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema for the repartition */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** The repartition plan node to be executed */
+  const RepartitionPlanNode *plan_;
+  /** The exchange of the gather, or nullptr outside of a gather */
+  RepartitionExchange *exchange_{nullptr};
+  /** The child executor outside of a gather */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** The batch that Next() produces tuples from */
+  TupleBatch batch_;
+  /** The index of the next tuple in `batch_` */
+  size_t batch_idx_{0};
+};
+
+}  // namespace bustub
@@ -12,10 +12,14 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <vector>
 
+#include "execution/data_chunk.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -33,6 +37,17 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /**
+   * Construct a new SeqScanExecutor instance for one worker of a parallel scan.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @param morsels The pages of the table, shared by the workers of the scan
+   */
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, std::shared_ptr<MorselQueue> morsels);
+
+  /** @return A queue over the pages of the scanned table, for the workers of a parallel scan */
+  static auto MakeMorselQueue(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) -> std::shared_ptr<MorselQueue>;
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -44,13 +59,44 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The next tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** @return `true` if the scan produced a tuple, before the predicate pushed down into the scan */
+  auto NextTuple(Tuple *tuple) -> bool;
+
+  /** @return `true` if the tuple passes the predicate pushed down into the scan */
+  auto Matches(const Tuple &tuple) const -> bool;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
-  const TableInfo* table_info_;
-  TableIterator iterator_;
+  /** The table that is scanned */
+  const TableInfo *table_info_{nullptr};
+  /** The position of the scan in the table heap */
+  std::optional<TableIterator> iterator_;
+  /** The end of the table heap */
+  std::optional<TableIterator> end_;
+  /** The pages that the workers of a parallel scan take, or nullptr if the scan goes through the iterator */
+  std::shared_ptr<MorselQueue> morsels_;
+  /** The page of the current morsel that is read next, and the page past the morsel */
+  size_t morsel_begin_{0};
+  size_t morsel_end_{0};
+  /** The tuples of the page that a parallel scan reads, and the next one to produce */
+  std::vector<Tuple> page_tuples_;
+  size_t page_cursor_{0};
+  /** The columnar form of the batch that the predicate is evaluated on */
+  DataChunk chunk_;
+  /** The tuples of the batch for which the predicate is true */
+  SelectionMask mask_;
+  /** The indexes of the tuples of a batch that pass the predicate */
+  SelectionVector selection_;
 };
 }  // namespace bustub
@@ -12,19 +12,28 @@
 
 #pragma once
 
+#include <cstring>
 #include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/key_normalizer.h"
+#include "execution/loser_tree.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * Every input tuple gets a normalized key, so that the sort never evaluates an expression or compares a Value twice,
+ * except to break the ties of inexact keys. The keys are radix-sorted in memory within the memory budget of the query.
+ * Once it is exceeded, the sorted tuples are spilled to temporary pages as a run, and at the end the runs are merged
+ * with a loser tree, SORT_MERGE_FAN_IN runs at a time.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -35,6 +44,8 @@ class SortExecutor : public AbstractExecutor {
    */
   SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
 
+  ~SortExecutor() override;
+
   /** Initialize the sort */
   void Init() override;
 
@@ -50,7 +61,72 @@ class SortExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A sorted run being merged, with its next tuple */
+  struct MergeSource {
+    /** Read the next tuple of the run. @return `false` if the run is exhausted */
+    auto Advance(size_t key_size) -> bool;
+
+    std::unique_ptr<TmpTupleFile> run_;
+    std::unique_ptr<TmpTupleFile::Reader> reader_;
+    /** The next tuple of the run with its normalized key, as the run stores it */
+    Tuple record_;
+    /** The next tuple of the run */
+    Tuple tuple_;
+    bool done_{false};
+  };
+
+  /** Orders the merge sources by the keys of their next tuples, with the exhausted ones last */
+  struct SourceLess {
+    auto operator()(size_t lhs, size_t rhs) const -> bool {
+      const auto &left = (*sources_)[lhs];
+      const auto &right = (*sources_)[rhs];
+      if (left.done_ || right.done_) {
+        return !left.done_;
+      }
+      auto result = memcmp(left.record_.GetData(), right.record_.GetData(), normalizer_->KeySize());
+      if (result != 0 || normalizer_->IsExact()) {
+        return result < 0;
+      }
+      return normalizer_->Compare(left.tuple_, right.tuple_) < 0;
+    }
+
+    const std::vector<MergeSource> *sources_;
+    const KeyNormalizer *normalizer_;
+  };
+
+  /** Sort `order_` by the keys of the tuples in memory. */
+  void SortInMemory();
+
+  /** Sort the tuples in memory and spill them as a run, giving back their memory. */
+  void SpillRun();
+
+  /** @return The sources that merge runs, on their first tuples */
+  auto OpenSources(std::vector<std::unique_ptr<TmpTupleFile>> runs) const -> std::vector<MergeSource>;
+
+  /** @return One run with the tuples of all runs */
+  auto MergeRuns(std::vector<std::unique_ptr<TmpTupleFile>> runs) -> std::unique_ptr<TmpTupleFile>;
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  /** The child executor that produces the tuples to sort */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The normalized keys of the ORDER BY */
+  KeyNormalizer normalizer_;
+  /** The normalized keys of the tuples in memory, one after the other */
+  std::vector<char> keys_;
+  /** The tuples in memory */
+  std::vector<Tuple> tuples_;
+  /** The indexes of the tuples in memory, in sorted order once sorted */
+  std::vector<uint32_t> order_;
+  /** The next index of `order_` to produce, when nothing was spilled */
+  size_t next_entry_{0};
+  /** The memory reserved from the budget of the query for the tuples in memory */
+  size_t memory_reserved_{0};
+  /** The runs spilled so far */
+  std::vector<std::unique_ptr<TmpTupleFile>> runs_;
+  /** The runs of the final merge */
+  std::vector<MergeSource> sources_;
+  /** The final merge of `sources_`, or nullptr if the tuples are sorted in memory */
+  std::unique_ptr<LoserTree<SourceLess>> merge_;
 };
 }  // namespace bustub
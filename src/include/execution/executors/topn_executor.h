@@ -13,10 +13,12 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/key_normalizer.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
 #include "storage/table/tuple.h"
@@ -25,6 +27,9 @@ namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * It keeps the first N tuples seen so far in a heap with the last of them on top, ordered by their normalized keys,
+ * so that most input tuples are rejected by one memcmp against the top.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -50,7 +55,24 @@ class TopNExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A tuple with its normalized key */
+  struct TopNEntry {
+    std::string key_;
+    Tuple tuple_;
+  };
+
+  /** @return Whether the left entry comes before the right one */
+  auto Less(const TopNEntry &lhs, const TopNEntry &rhs) const -> bool;
+
   /** The topn plan node to be executed */
   const TopNPlanNode *plan_;
+  /** The child executor that produces the tuples to pick from */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The normalized keys of the ORDER BY */
+  KeyNormalizer normalizer_;
+  /** The first N tuples, as a heap while the input is read, then sorted */
+  std::vector<TopNEntry> entries_;
+  /** The next tuple of `entries_` to produce */
+  size_t next_entry_{0};
 };
 }  // namespace bustub
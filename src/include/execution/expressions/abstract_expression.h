@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/data_chunk.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 
@@ -65,6 +66,33 @@ class AbstractExpression {
   virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluate every row of a chunk at once. Expressions override this with loops over the typed arrays of the columns;
+   * by default every row is evaluated on its own with Evaluate().
+   * @param chunk The rows, in the columnar form of their schema
+   * @param[out] result One value of the return type for each row
+   */
+  virtual void EvaluateChunk(const DataChunk &chunk, ColumnVector *result) const {
+    result->Reset(GetReturnType());
+    result->Resize(chunk.Size());
+    for (size_t row = 0; row < chunk.Size(); row++) {
+      Tuple tuple = chunk.RowTuple(row);
+      result->SetValue(row, Evaluate(&tuple, *chunk.GetSchema()));
+    }
+  }
+
+  /**
+   * Select the rows of a chunk for which this boolean expression is true. Comparisons and logic expressions override
+   * this with SIMD kernels and bitwise operations on the masks; by default the chunk is evaluated with EvaluateChunk().
+   * @param chunk The rows, in the columnar form of their schema
+   * @param[out] mask The rows where the expression is true and not null
+   */
+  virtual void EvaluateMask(const DataChunk &chunk, SelectionMask *mask) const {
+    ColumnVector result;
+    EvaluateChunk(chunk, &result);
+    TrueMask(result, mask);
+  }
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
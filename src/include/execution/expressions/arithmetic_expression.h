@@ -65,6 +65,27 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
+  void EvaluateChunk(const DataChunk &chunk, ColumnVector *result) const override {
+    ColumnVector lhs;
+    ColumnVector rhs;
+    GetChildAt(0)->EvaluateChunk(chunk, &lhs);
+    GetChildAt(1)->EvaluateChunk(chunk, &rhs);
+    result->Reset(TypeId::INTEGER);
+    // The values of null rows are unspecified, so the loops wrap around instead of overflowing.
+    switch (compute_type_) {
+      case ArithmeticType::Plus:
+        return BinaryColumnOp<int32_t, int32_t>(lhs, rhs, result, [](int32_t l, int32_t r) {
+          return static_cast<int32_t>(static_cast<uint32_t>(l) + static_cast<uint32_t>(r));
+        });
+      case ArithmeticType::Minus:
+        return BinaryColumnOp<int32_t, int32_t>(lhs, rhs, result, [](int32_t l, int32_t r) {
+          return static_cast<int32_t>(static_cast<uint32_t>(l) - static_cast<uint32_t>(r));
+        });
+      default:
+        UNREACHABLE("Unsupported arithmetic type.");
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), compute_type_, *GetChildAt(1));
@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/compare_kernels.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
@@ -49,6 +52,16 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateChunk(const DataChunk &chunk, ColumnVector *result) const override {
+    SelectionMask mask;
+    CompareChunk(chunk, &mask, result);
+  }
+
+  void EvaluateMask(const DataChunk &chunk, SelectionMask *mask) const override {
+    ColumnVector result;
+    CompareChunk(chunk, mask, &result);
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), comp_type_, *GetChildAt(1));
@@ -59,6 +72,97 @@ class ComparisonExpression : public AbstractExpression {
   ComparisonType comp_type_;
 
  private:
+  /** @return The comparison with its sides swapped, such that `a op b` is `b Flip(op) a` */
+  static auto Flip(ComparisonType op) -> ComparisonType {
+    switch (op) {
+      case ComparisonType::LessThan:
+        return ComparisonType::GreaterThan;
+      case ComparisonType::LessThanOrEqual:
+        return ComparisonType::GreaterThanOrEqual;
+      case ComparisonType::GreaterThan:
+        return ComparisonType::LessThan;
+      case ComparisonType::GreaterThanOrEqual:
+        return ComparisonType::LessThanOrEqual;
+      default:
+        return op;
+    }
+  }
+
+  /** @return The constant as a value of a fixed-length type, if it converts to it without loss */
+  static auto ConstantAs(const Value &constant, TypeId type) -> std::optional<Value> {
+    if (constant.GetTypeId() == type) {
+      return constant;
+    }
+    auto from = constant.GetTypeId();
+    bool small_integer = from == TypeId::TINYINT || from == TypeId::SMALLINT || from == TypeId::INTEGER;
+    if ((type == TypeId::BIGINT && small_integer) || (type == TypeId::DECIMAL && (small_integer || from == TypeId::BIGINT))) {
+      return constant.CastAs(type);
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * Compare the sides for every row of a chunk. A column compared with a constant, or two columns of the same
+   * fixed-length type, go through the comparison kernels; any other pair of values is compared one row at a time.
+   * @param chunk The rows
+   * @param[out] mask The rows where the comparison is true
+   * @param[out] result The BOOLEAN value of the comparison for every row
+   */
+  void CompareChunk(const DataChunk &chunk, SelectionMask *mask, ColumnVector *result) const {
+    const auto *lhs_constant = dynamic_cast<const ConstantValueExpression *>(GetChildAt(0).get());
+    const auto *rhs_constant = dynamic_cast<const ConstantValueExpression *>(GetChildAt(1).get());
+    ColumnVector lhs;
+    ColumnVector rhs;
+    result->Reset(TypeId::BOOLEAN);
+    result->Resize(chunk.Size());
+
+    if (lhs_constant == nullptr) {
+      GetChildAt(0)->EvaluateChunk(chunk, &lhs);
+    }
+    if (rhs_constant == nullptr) {
+      GetChildAt(1)->EvaluateChunk(chunk, &rhs);
+    }
+    if ((lhs_constant == nullptr) != (rhs_constant == nullptr)) {
+      const auto &column = lhs_constant == nullptr ? lhs : rhs;
+      const auto &constant = lhs_constant == nullptr ? rhs_constant->val_ : lhs_constant->val_;
+      if (auto value = ConstantAs(constant, column.GetType()); value.has_value() && IsFixedType(column.GetType())) {
+        CompareColumnConstant(column, lhs_constant == nullptr ? comp_type_ : Flip(comp_type_), *value, mask);
+        MaskToBoolean(*mask, result);
+        if (value->IsNull()) {
+          result->Broadcast(ValueFactory::GetNullValueByType(TypeId::BOOLEAN), chunk.Size());
+        } else {
+          result->UnionNulls(column, column);
+        }
+        return;
+      }
+    }
+    if (lhs_constant != nullptr) {
+      lhs_constant->EvaluateChunk(chunk, &lhs);
+    }
+    if (rhs_constant != nullptr) {
+      rhs_constant->EvaluateChunk(chunk, &rhs);
+    }
+
+    if (lhs.GetType() == rhs.GetType() && IsFixedType(lhs.GetType())) {
+      CompareColumns(lhs, comp_type_, rhs, mask);
+      MaskToBoolean(*mask, result);
+      result->UnionNulls(lhs, rhs);
+      return;
+    }
+    for (size_t row = 0; row < chunk.Size(); row++) {
+      result->SetValue(row, ValueFactory::GetBooleanValue(PerformComparison(lhs.GetValue(row), rhs.GetValue(row))));
+    }
+    TrueMask(*result, mask);
+  }
+
+  /** Set the values of a BOOLEAN result to the bits of a mask. */
+  static void MaskToBoolean(const SelectionMask &mask, ColumnVector *result) {
+    int8_t *out = result->Data<int8_t>();
+    for (size_t row = 0; row < result->Size(); row++) {
+      out[row] = static_cast<int8_t>(mask[row / 64] >> (row % 64) & 1);
+    }
+  }
+
   auto PerformComparison(const Value &lhs, const Value &rhs) const -> CmpBool {
     switch (comp_type_) {
       case ComparisonType::Equal:
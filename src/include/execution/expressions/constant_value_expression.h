@@ -34,6 +34,15 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  void EvaluateChunk(const DataChunk &chunk, ColumnVector *result) const override {
+    if (!IsFixedType(val_.GetTypeId()) && val_.GetTypeId() != TypeId::VARCHAR) {
+      AbstractExpression::EvaluateChunk(chunk, result);
+      return;
+    }
+    result->Reset(val_.GetTypeId());
+    result->Broadcast(val_, chunk.Size());
+  }
+
   /** @return the string representation of the plan node and its children */
   auto ToString() const -> std::string override { return val_.ToString(); }
 
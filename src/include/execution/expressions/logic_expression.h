@@ -57,6 +57,39 @@ class LogicExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComputation(lhs, rhs));
   }
 
+  void EvaluateChunk(const DataChunk &chunk, ColumnVector *result) const override {
+    ColumnVector lhs;
+    ColumnVector rhs;
+    GetChildAt(0)->EvaluateChunk(chunk, &lhs);
+    GetChildAt(1)->EvaluateChunk(chunk, &rhs);
+    result->Reset(TypeId::BOOLEAN);
+    result->Resize(chunk.Size());
+    const int8_t *l = lhs.Data<int8_t>();
+    const int8_t *r = rhs.Data<int8_t>();
+    int8_t *out = result->Data<int8_t>();
+    bool is_and = logic_type_ == LogicType::And;
+    for (size_t row = 0; row < chunk.Size(); row++) {
+      bool l_null = lhs.IsNull(row);
+      bool r_null = rhs.IsNull(row);
+      bool l_true = !l_null && l[row] != 0;
+      bool r_true = !r_null && r[row] != 0;
+      // A false side decides AND and a true side decides OR, even if the other side is null.
+      bool decided = is_and ? (!l_null && !l_true) || (!r_null && !r_true) : l_true || r_true;
+      out[row] = static_cast<int8_t>(is_and ? l_true && r_true : l_true || r_true);
+      result->SetNull(row, !decided && (l_null || r_null));
+    }
+  }
+
+  void EvaluateMask(const DataChunk &chunk, SelectionMask *mask) const override {
+    // A row is true for AND if it is true on both sides, and for OR if it is true on either, whatever the nulls.
+    SelectionMask rhs;
+    GetChildAt(0)->EvaluateMask(chunk, mask);
+    GetChildAt(1)->EvaluateMask(chunk, &rhs);
+    for (size_t i = 0; i < mask->size(); i++) {
+      (*mask)[i] = logic_type_ == LogicType::And ? (*mask)[i] & rhs[i] : (*mask)[i] | rhs[i];
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), logic_type_, *GetChildAt(1));
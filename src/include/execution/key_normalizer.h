@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_normalizer.h
+//
+// Identification: src/include/execution/key_normalizer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * KeyNormalizer encodes the ORDER BY values of a tuple, once, into a normalized key: a byte string of a fixed width
+ * that memcmp orders as the ORDER BY orders the tuples, so that sorts and merges compare raw bytes instead of
+ * evaluating expressions and comparing Values.
+ *
+ * Every column takes a null byte, which puts NULLs first, then its value in big-endian with the sign bit flipped
+ * (and all bits of a negative DECIMAL). A DESC column has all its bytes flipped, which puts its NULLs last. A VARCHAR
+ * takes its first NORMALIZED_VARCHAR_PREFIX bytes, padded with zeros; two keys that differ order their tuples, but
+ * two equal keys with a VARCHAR column may still come from different strings, so the key is not exact and the tie is
+ * broken with Compare. The columns after a VARCHAR are left out of the key, as a tie on its prefix would order the
+ * tuples by them before the rest of the string.
+ */
+class KeyNormalizer {
+ public:
+  /**
+   * @param order_bys The ORDER BY of the keys
+   * @param schema The schema of the tuples that the ORDER BY expressions evaluate
+   */
+  KeyNormalizer(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys, const Schema &schema);
+
+  /** @return The size of a normalized key in bytes */
+  auto KeySize() const -> size_t { return key_size_; }
+
+  /** @return Whether two equal keys always come from tuples that the ORDER BY considers equal */
+  auto IsExact() const -> bool { return exact_; }
+
+  /**
+   * Encode the normalized key of a tuple.
+   * @param tuple The tuple
+   * @param[out] key Where to write the KeySize() bytes of the key
+   */
+  void Normalize(const Tuple &tuple, char *key) const;
+
+  /** @return The normalized key of a tuple */
+  auto Normalize(const Tuple &tuple) const -> std::string;
+
+  /**
+   * Compare two tuples by their ORDER BY values, for tuples whose normalized keys are equal but not exact.
+   * @return A negative number, zero or a positive number if the left tuple comes first, ties or comes last
+   */
+  auto Compare(const Tuple &lhs, const Tuple &rhs) const -> int;
+
+ private:
+  /** A column of the key */
+  struct KeyColumn {
+    bool desc_;
+    AbstractExpressionRef expr_;
+    TypeId type_;
+    /** The offset of the null byte of the column in the key */
+    size_t offset_;
+    /** The size of the value of the column, after its null byte */
+    size_t size_;
+  };
+
+  const Schema &schema_;
+  std::vector<KeyColumn> columns_;
+  /** The number of leading columns of `columns_` that the key encodes */
+  size_t num_key_columns_{0};
+  size_t key_size_{0};
+  bool exact_{true};
+};
+
+/**
+ * Sort the rows of normalized keys by a most-significant-digit radix sort, a byte at a time, with memcmp comparisons
+ * for ranges of fewer than RADIX_SORT_MIN_ROWS rows.
+ * @param keys The keys, one after the other, `key_size` bytes each
+ * @param key_size The size of a key
+ * @param[in,out] rows The indexes of the keys to sort
+ */
+void RadixSortKeys(const char *keys, size_t key_size, std::vector<uint32_t> *rows);
+
+}  // namespace bustub
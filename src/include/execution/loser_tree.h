@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree merges k sorted sources. It is a tournament tree over the heads of the sources whose inner nodes keep the
+ * loser of the match played there, so that once the winner's source moves on to its next head, only the matches on
+ * the path from that source to the root are replayed: log2(k) comparisons per tuple, against the losers along the
+ * path, with no sibling to look up as in a heap.
+ *
+ * @tparam Less Compares the heads of two sources by their indexes; the head of an exhausted source must compare
+ * larger than any other
+ */
+template <typename Less>
+class LoserTree {
+ public:
+  /**
+   * Creates a tree over sources that already have their first heads.
+   * @param num_sources The number of sources, at least 1
+   * @param less Compares the heads of two sources
+   */
+  LoserTree(size_t num_sources, Less less) : num_sources_(num_sources), less_(std::move(less)), tree_(num_sources) {
+    tree_[0] = num_sources_ == 1 ? 0 : Play(1);
+  }
+
+  /** @return The source with the smallest head */
+  auto Top() const -> size_t { return tree_[0]; }
+
+  /**
+   * Replay the matches of a source once its head changed.
+   * @param source The source that moved on, usually the last top
+   */
+  void Replay(size_t source) {
+    auto winner = source;
+    for (auto node = (source + num_sources_) / 2; node > 0; node /= 2) {
+      if (less_(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  /** Play the matches below an inner node, keeping their losers. @return The winner */
+  auto Play(size_t node) -> size_t {
+    if (node >= num_sources_) {
+      return node - num_sources_;
+    }
+    auto left = Play(2 * node);
+    auto right = Play(2 * node + 1);
+    if (less_(right, left)) {
+      tree_[node] = left;
+      return right;
+    }
+    tree_[node] = right;
+    return left;
+  }
+
+  size_t num_sources_;
+  Less less_;
+  /** The winner at index 0, then the loser of every inner node; the sources are the leaves, from index k on */
+  std::vector<size_t> tree_;
+};
+
+}  // namespace bustub
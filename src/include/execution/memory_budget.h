@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_budget.h
+//
+// Identification: src/include/execution/memory_budget.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * MemoryBudget is the memory that the executors of a query may hold at once in their hash tables and buffers. An
+ * executor reserves memory before it holds more tuples, and spills them to temporary pages when the reservation
+ * fails. The workers of a query share its budget.
+ */
+class MemoryBudget {
+ public:
+  /** @param limit The memory of the budget, in bytes */
+  explicit MemoryBudget(size_t limit = DEFAULT_QUERY_MEMORY_BUDGET) : limit_(limit) {}
+
+  DISALLOW_COPY_AND_MOVE(MemoryBudget);
+
+  /** @param limit The memory of the budget, in bytes */
+  void SetLimit(size_t limit) { limit_ = limit; }
+
+  /** @return The memory of the budget, in bytes */
+  auto GetLimit() const -> size_t { return limit_; }
+
+  /** @return The memory reserved, in bytes */
+  auto GetReserved() const -> size_t { return reserved_; }
+
+  /**
+   * Reserve memory, unless the budget would be exceeded.
+   * @param bytes The memory to reserve
+   * @return `false` if nothing was reserved
+   */
+  auto Reserve(size_t bytes) -> bool {
+    auto reserved = reserved_.load();
+    do {
+      if (reserved + bytes > limit_) {
+        return false;
+      }
+    } while (!reserved_.compare_exchange_weak(reserved, reserved + bytes));
+    return true;
+  }
+
+  /** Reserve memory even beyond the budget, for an executor that has no way to spill it. */
+  void ForceReserve(size_t bytes) { reserved_ += bytes; }
+
+  /** Give back memory that was reserved. */
+  void Release(size_t bytes) { reserved_ -= bytes; }
+
+ private:
+  std::atomic<size_t> limit_;
+  std::atomic<size_t> reserved_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/morsel_queue.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * MorselQueue splits the input of a parallel scan into morsels: ranges of consecutive units of the input, the pages
+ * of a table heap or the rows of a mock table. The workers of the scan take morsels from the queue until it is empty,
+ * so that a worker that is done early takes more of them.
+ */
+class MorselQueue {
+ public:
+  /**
+   * Create a queue over rows.
+   * @param num_rows The number of rows of the input
+   * @param morsel_size The number of rows of a morsel
+   */
+  MorselQueue(size_t num_rows, size_t morsel_size) : num_units_(num_rows), morsel_size_(morsel_size) {}
+
+  /**
+   * Create a queue over the pages of a table heap.
+   * @param page_ids The pages of the table heap, in order
+   * @param morsel_size The number of pages of a morsel
+   */
+  MorselQueue(std::vector<page_id_t> page_ids, size_t morsel_size)
+      : num_units_(page_ids.size()), morsel_size_(morsel_size), page_ids_(std::move(page_ids)) {}
+
+  /** @return The number of morsels of the input */
+  auto NumMorsels() const -> size_t { return (num_units_ + morsel_size_ - 1) / morsel_size_; }
+
+  /**
+   * Take the next morsel. Safe to call from many workers at once.
+   * @param[out] begin The first unit of the morsel
+   * @param[out] end The unit past the last one of the morsel
+   * @return `false` if every morsel was taken
+   */
+  auto Next(size_t *begin, size_t *end) -> bool {
+    size_t first = next_.fetch_add(morsel_size_);
+    if (first >= num_units_) {
+      return false;
+    }
+    *begin = first;
+    *end = std::min(first + morsel_size_, num_units_);
+    return true;
+  }
+
+  /** @return The page of a queue over a table heap */
+  auto PageAt(size_t unit) const -> page_id_t { return page_ids_[unit]; }
+
+ private:
+  const size_t num_units_;
+  const size_t morsel_size_;
+  std::vector<page_id_t> page_ids_;
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace bustub
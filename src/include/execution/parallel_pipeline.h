@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.h
+//
+// Identification: src/include/execution/parallel_pipeline.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * ParallelPipeline runs the executors of a plan on many workers at once, for the executor that consumes the plan and
+ * breaks the pipeline: an aggregation or the build side of a hash join.
+ *
+ * Every worker has its own copy of the executors, down to a scan that takes morsels of the input from a queue shared
+ * by all the workers, so together the workers produce each tuple of the plan exactly once, in no particular order.
+ * Only filters and projections over a sequential or mock scan run in parallel.
+ */
+class ParallelPipeline {
+ public:
+  /**
+   * Create the executors of the workers of a plan.
+   * @param exec_ctx The executor context, whose worker pool runs the workers
+   * @param plan The plan
+   * @return The pipeline, or nullptr if the plan cannot run in parallel or would run on one worker anyway
+   */
+  static auto Create(ExecutorContext *exec_ctx, const AbstractPlanNode *plan) -> std::unique_ptr<ParallelPipeline>;
+
+  /** @return The number of workers */
+  auto NumWorkers() const -> size_t { return executors_.size(); }
+
+  /**
+   * Initialize the executors, and run every worker on the pool until all of them are done.
+   * @param consume Called on each worker with the index of the worker and its executor, which it drains
+   */
+  void Run(const std::function<void(size_t, AbstractExecutor *)> &consume);
+
+ private:
+  ParallelPipeline(ExecutorContext *exec_ctx, std::vector<std::unique_ptr<AbstractExecutor>> executors)
+      : exec_ctx_(exec_ctx), executors_(std::move(executors)) {}
+
+  /** @return The executor of one worker, with a scan that takes morsels from the queue */
+  static auto CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                             const std::shared_ptr<MorselQueue> &morsels) -> std::unique_ptr<AbstractExecutor>;
+
+  ExecutorContext *exec_ctx_;
+  std::vector<std::unique_ptr<AbstractExecutor>> executors_;
+};
+
+}  // namespace bustub
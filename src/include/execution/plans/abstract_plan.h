@@ -47,7 +47,9 @@ enum class PlanType {
   Projection,
   Sort,
   TopN,
-  MockScan
+  MockScan,
+  Gather,
+  Repartition
 };
 
 class AbstractPlanNode;
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_plan.h
+//
+// Identification: src/include/execution/plans/gather_plan.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "execution/plans/abstract_plan.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * The GatherPlanNode runs its child on many workers at once and merges their outputs into one stream, in no
+ * particular order.
+ *
+ * Every worker runs its own instance of the child plan. The scans of the instances split their tables between them,
+ * and the instances of a RepartitionPlanNode each receive one partition of its input, so that together the workers
+ * produce the output of the child exactly once.
+ */
+class GatherPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new GatherPlanNode instance.
+   * @param output The output schema of the gather, the one of its child
+   * @param child The child plan, run by every worker
+   * @param num_workers The number of workers
+   */
+  GatherPlanNode(SchemaRef output, AbstractPlanNodeRef child, size_t num_workers)
+      : AbstractPlanNode(std::move(output), {std::move(child)}), num_workers_{num_workers} {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::Gather; }
+
+  /** @return The number of workers */
+  auto GetNumWorkers() const -> size_t { return num_workers_; }
+
+  /** @return The child plan node */
+  auto GetChildPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Gather should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(GatherPlanNode);
+
+  /** The number of workers */
+  size_t num_workers_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    return fmt::format("Gather {{ workers={} }}", num_workers_);
+  }
+};
+
+}  // namespace bustub
@@ -12,12 +12,14 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "type/value.h"
 
 namespace bustub {
 /**
@@ -33,6 +35,24 @@ class IndexScanPlanNode : public AbstractPlanNode {
   IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
       : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
 
+  /**
+   * Creates a new index scan plan node that only visits the keys within a range.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to be scanned
+   * @param lower_bound the smallest key to visit, unbounded if not set
+   * @param lower_inclusive whether a key equal to `lower_bound` is visited
+   * @param upper_bound the largest key to visit, unbounded if not set
+   * @param upper_inclusive whether a key equal to `upper_bound` is visited
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::optional<Value> lower_bound, bool lower_inclusive,
+                    std::optional<Value> upper_bound, bool upper_inclusive)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        lower_bound_(std::move(lower_bound)),
+        lower_inclusive_(lower_inclusive),
+        upper_bound_(std::move(upper_bound)),
+        upper_inclusive_(upper_inclusive) {}
+
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
@@ -43,11 +63,28 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The range of keys to scan, a missing bound leaves that side open. */
+  std::optional<Value> lower_bound_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_bound_;
+  bool upper_inclusive_{true};
+
+  /**
+   * Build the output tuples from the index entries instead of fetching them from the table, set when the columns read
+   * above the scan are all stored in the index. The other columns of the output are null.
+   */
+  bool index_only_{false};
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    const auto *index_only = index_only_ ? ", index_only=true" : "";
+    if (!lower_bound_.has_value() && !upper_bound_.has_value()) {
+      return fmt::format("IndexScan {{ index_oid={}{} }}", index_oid_, index_only);
+    }
+    return fmt::format("IndexScan {{ index_oid={}, range={}{}, {}{}{} }}", index_oid_, lower_inclusive_ ? "[" : "(",
+                       lower_bound_.has_value() ? lower_bound_->ToString() : "-inf",
+                       upper_bound_.has_value() ? upper_bound_->ToString() : "+inf", upper_inclusive_ ? "]" : ")",
+                       index_only);
   }
 };
 
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_plan.h
+//
+// Identification: src/include/execution/plans/repartition_plan.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * The RepartitionPlanNode splits the output of its child by the hash of the partition keys, for the workers of the
+ * GatherPlanNode above it: every worker receives the tuples of one partition, so all tuples with equal keys go to the
+ * same worker. Joins and aggregations on the keys can then run on every worker independently.
+ *
+ * The child runs on as many producers as there are partitions, and its scans split their tables between them.
+ * Outside of a gather, the node passes the output of its child through.
+ */
+class RepartitionPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new RepartitionPlanNode instance.
+   * @param output The output schema of the repartition, the one of its child
+   * @param child The child plan
+   * @param partition_keys The expressions whose values choose the partition of a tuple
+   * @param num_partitions The number of partitions, the number of workers of the gather above
+   */
+  RepartitionPlanNode(SchemaRef output, AbstractPlanNodeRef child, std::vector<AbstractExpressionRef> partition_keys,
+                      size_t num_partitions)
+      : AbstractPlanNode(std::move(output), {std::move(child)}),
+        partition_keys_{std::move(partition_keys)},
+        num_partitions_{num_partitions} {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::Repartition; }
+
+  /** @return The expressions whose values choose the partition of a tuple */
+  auto GetPartitionKeys() const -> const std::vector<AbstractExpressionRef> & { return partition_keys_; }
+
+  /** @return The number of partitions */
+  auto GetNumPartitions() const -> size_t { return num_partitions_; }
+
+  /** @return The child plan node */
+  auto GetChildPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Repartition should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(RepartitionPlanNode);
+
+  /** The expressions whose values choose the partition of a tuple */
+  std::vector<AbstractExpressionRef> partition_keys_;
+
+  /** The number of partitions */
+  size_t num_partitions_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override;
+};
+
+}  // namespace bustub
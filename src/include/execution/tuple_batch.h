@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch is the unit of work that executors hand to each other in NextBatch(): the tuples and RIDs of up to
+ * `capacity` rows. A batch keeps its vectors between calls, so a consumer that reuses one batch allocates them once.
+ */
+class TupleBatch {
+ public:
+  /**
+   * Construct a new, empty TupleBatch.
+   * @param capacity The number of tuples that the batch holds at most
+   */
+  explicit TupleBatch(size_t capacity = EXECUTION_BATCH_SIZE) : capacity_(capacity) {
+    tuples_.reserve(capacity);
+    rids_.reserve(capacity);
+  }
+
+  /** @return The number of tuples in the batch */
+  auto Size() const -> size_t { return tuples_.size(); }
+
+  /** @return The number of tuples that the batch holds at most */
+  auto Capacity() const -> size_t { return capacity_; }
+
+  /** @return `true` if the batch has no tuples */
+  auto IsEmpty() const -> bool { return tuples_.empty(); }
+
+  /** @return `true` if no more tuples fit into the batch */
+  auto IsFull() const -> bool { return tuples_.size() >= capacity_; }
+
+  /** Append a tuple and its RID to the batch. */
+  void Append(Tuple tuple, RID rid) {
+    tuples_.push_back(std::move(tuple));
+    rids_.push_back(rid);
+  }
+
+  /** @return The i-th tuple of the batch */
+  auto TupleAt(size_t i) -> Tuple & { return tuples_[i]; }
+  auto TupleAt(size_t i) const -> const Tuple & { return tuples_[i]; }
+
+  /** @return The RID of the i-th tuple of the batch */
+  auto RidAt(size_t i) const -> RID { return rids_[i]; }
+
+  /** @return All tuples of the batch */
+  auto GetTuples() -> std::vector<Tuple> & { return tuples_; }
+
+  /**
+   * Keep only the tuples whose index is in `selection`, in that order.
+   * @param selection The indexes of the tuples to keep, ascending
+   */
+  void Select(const std::vector<uint32_t> &selection) {
+    for (size_t i = 0; i < selection.size(); i++) {
+      if (selection[i] != i) {
+        tuples_[i] = std::move(tuples_[selection[i]]);
+        rids_[i] = rids_[selection[i]];
+      }
+    }
+    tuples_.resize(selection.size());
+    rids_.resize(selection.size());
+  }
+
+  /** Remove all tuples from the batch. */
+  void Clear() {
+    tuples_.clear();
+    rids_.clear();
+  }
+
+ private:
+  size_t capacity_;
+  std::vector<Tuple> tuples_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
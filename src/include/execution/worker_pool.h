@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.h
+//
+// Identification: src/include/execution/worker_pool.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * WorkerPool is a fixed set of threads that run the workers of parallel pipelines.
+ *
+ * A thread that waits in Run() runs the tasks that are still queued instead of blocking, so a task may call Run()
+ * itself without exhausting the pool.
+ */
+class WorkerPool {
+ public:
+  /**
+   * Start the threads of the pool.
+   * @param num_threads The number of threads
+   */
+  explicit WorkerPool(size_t num_threads);
+
+  /** Wait for the queued tasks, and stop the threads. */
+  ~WorkerPool();
+
+  DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  /** @return The number of threads of the pool */
+  auto Size() const -> size_t { return threads_.size(); }
+
+  /**
+   * Run `num_tasks` tasks, the first one on the calling thread and the others on the pool, and wait for all of them.
+   * If tasks throw, the first exception is rethrown once all of them are done.
+   * @param num_tasks The number of tasks
+   * @param task Called with the index of each task, from 0 to num_tasks - 1
+   */
+  void Run(size_t num_tasks, const std::function<void(size_t)> &task);
+
+ private:
+  /** Take tasks from the queue until the pool stops. */
+  void WorkerLoop();
+
+  std::vector<std::thread> threads_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  bool stopped_{false};
+};
+
+}  // namespace bustub
@@ -16,13 +16,15 @@
 
 namespace bustub {
 
+class NestedLoopJoinPlanNode;
+
 /**
  * The optimizer takes an `AbstractPlanNode` and outputs an optimized `AbstractPlanNode`.
  */
 class Optimizer {
  public:
-  explicit Optimizer(const Catalog &catalog, bool force_starter_rule)
-      : catalog_(catalog), force_starter_rule_(force_starter_rule) {}
+  explicit Optimizer(const Catalog &catalog, bool force_starter_rule, size_t max_parallel_workers = 1)
+      : catalog_(catalog), force_starter_rule_(force_starter_rule), max_parallel_workers_(max_parallel_workers) {}
 
   auto Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -55,6 +57,13 @@ class Optimizer {
    */
   auto OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief turn an inner join into an index join that probes the index of its left table instead of the right one,
+   * if the right table has no index on its join column or is the smaller one by the table statistics.
+   * @return the index join under a projection that restores the column order, nullptr to keep the sides as they are
+   */
+  auto SwapJoinSidesForIndexJoin(const NestedLoopJoinPlanNode &nlj_plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief eliminate always true filter
    */
@@ -85,8 +94,23 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
-  auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
+  /**
+   * @brief optimize a filter over a seq scan as an index range scan, if the filter compares an indexed column
+   * against constants, e.g. `WHERE x BETWEEN 1 AND 10` or `WHERE x > 5 AND x <= 7`.
+   */
+  auto OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief let an index scan under a projection or an aggregation skip the table, if every column they (and any
+   * filter in between) read is stored in the b+ tree index, either as the key or as an included column.
+   */
+  auto OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief check if the index can be matched. Hash indexes answer equality lookups with the fewest page reads and
+   * are preferred, unless `ordered` asks for an index that keeps its keys in order, for range scans.
+   */
+  auto MatchIndex(const std::string &table_name, uint32_t index_key_idx, bool ordered = false)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
   /**
@@ -95,8 +119,24 @@ class Optimizer {
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief run large scans on the workers of a gather, when the session allows more than one worker. A hash join of
+   * two large pipelines is split by its join keys, so that every worker joins one partition of both sides. Any other
+   * large pipeline of filters and projections over a scan is gathered as it is, unless its consumer is an aggregation
+   * or the build side of a hash join, which run their child on morsel-driven workers by themselves.
+   */
+  auto OptimizeParallelExchange(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief get the estimated number of rows scanned by a pipeline of filters and projections over a sequential or
+   * mock scan, whose scan the workers of a gather can split.
+   * @return std::nullopt if the plan is not such a pipeline, or the size of its table is unknown
+   */
+  auto EstimatedPipelineRows(const AbstractPlanNode &plan) -> std::optional<size_t>;
+
+  /**
+   * @brief get the estimated cardinality for a table. Useful when join reordering. The row count collected by the
+   * last ANALYZE of one of the table's indexes is used if there is one, otherwise the size is guessed from the
+   * suffix of the table name.
    *
    * @param table_name
    * @return std::optional<size_t>
@@ -109,6 +149,9 @@ class Optimizer {
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  /** The number of workers that a query may run on */
+  const size_t max_parallel_workers_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "container/art/art.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/**
+ * ArtIndex is an in-memory index backed by an adaptive radix tree. Unlike BPlusTreeIndex it does not go
+ * through the buffer pool, and lookups, inserts and deletes from many threads proceed without taking any shared
+ * latch, so point lookups keep scaling with the number of worker threads.
+ *
+ * Key columns may be integers or strings, they are encoded so that the byte order of the encoded keys matches the
+ * order of the values. The tree maps every key to one RID, so a unique index keeps the first tuple of a key, while the
+ * entries of a non-unique index end with the RID of their tuple, and the tuples of a key are the entries in between
+ * the smallest and the largest RID suffix. The index is not persisted and must be rebuilt after a restart.
+ */
+class ArtIndex : public Index {
+ public:
+  explicit ArtIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  ~ArtIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /**
+   * @brief Collect the RIDs of the keys between `low` and `high` in key order, an unset bound leaves that side of the
+   * range open.
+   */
+  void ScanRange(const std::optional<Tuple> &low, bool low_inclusive, const std::optional<Tuple> &high,
+                 bool high_inclusive, std::vector<RID> *result, Transaction *transaction);
+
+ private:
+  /** Concatenate the binary-comparable encodings of all key columns. */
+  auto EncodeKey(const Tuple &key) const -> ArtKey;
+
+  /** @return The key of the entry of a tuple in the tree, which ends with its RID if the index is not unique */
+  auto EncodeEntry(const Tuple &key, RID rid) const -> ArtKey;
+
+  /** @return A key that sorts before all entries of `key`, or after all of them if `after_all_rids` is set */
+  auto EncodeBound(const Tuple &key, bool after_all_rids) const -> ArtKey;
+
+  // container
+  AdaptiveRadixTree container_;
+};
+
+}  // namespace bustub
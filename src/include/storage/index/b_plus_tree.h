@@ -10,50 +10,133 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/**
+ * Statistics of a B+ tree, see BPlusTree::CollectStats(). The leaf level is
+ * sampled, so the counts that depend on it are estimates unless every leaf
+ * was read.
+ */
+template <typename KeyType>
+struct BPlusTreeStats {
+  /** Number of levels, 1 for a tree whose root is a leaf and 0 for an empty tree */
+  int height_{0};
+  int internal_page_count_{0};
+  int leaf_page_count_{0};
+  /** Average share of a leaf's capacity that is in use */
+  double leaf_fill_{0};
+  /** Number of distinct keys, which is the number of leaf entries */
+  uint64_t distinct_keys_{0};
+  /** Number of values, more than the distinct keys only if the tree keeps posting lists */
+  uint64_t num_values_{0};
+  /**
+   * Equi-depth histogram of the keys: the first bound is the smallest key, every following one ends a bucket that
+   * holds about the same number of values.
+   */
+  std::vector<KeyType> histogram_;
+};
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique unless the tree is created as non-unique, in which case
+ * the values of a key that has more than one are kept in a posting list
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Writers follow latch crabbing: a descent latches pages top-down and
+ * releases the ancestors as soon as a page is safe for the operation. The
+ * root page id is protected by `root_latch_`, which takes part in crabbing as
+ * if it were the parent of the root.
+ *
+ * Readers follow the B-link tree of Lehman and Yao: every page carries the
+ * fence keys of its key range and a right link to the next page on its level,
+ * so a reader never holds a parent latch while it latches a child and can
+ * still find keys that a concurrent split moved to the right.
+ *
+ * The fill factor is the share of a page that the rightmost page of a level
+ * keeps when it is split, so ascending inserts leave pages that full instead of
+ * half empty, and the share Rebuild() fills every page to.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
+  friend class INDEXITERATOR_TYPE;
+
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool unique = true, int fill_factor = BPLUSTREE_DEFAULT_FILL_FACTOR);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
-  // Insert a key-value pair into this B+ tree.
+  // Insert a key-value pair into this B+ tree. Returns false if the key exists. A non-unique tree only rejects a
+  // pair equal to the key's single value: the values are table RIDs, which are never inserted twice for a key.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and all its values from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove one key-value pair from this B+ tree, the key stays as long as it has other values.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // return the values associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  /**
+   * Look up a batch of keys in one pass over the tree. The keys are visited in sorted order, so every internal node
+   * and leaf on the way is fetched once for all the keys below it rather than once per key.
+   * @param result resized to the number of keys, `(*result)[i]` receives the value of `keys[i]` if it exists
+   */
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                 Transaction *transaction = nullptr);
+
+  /**
+   * Copy the tree into freshly allocated pages, filled to the fill factor and laid out level by level from the leaves
+   * up, so that the leaf chain is physically contiguous again, then switch over to the copy and free the old pages.
+   * Readers keep going during the rebuild; a reader in the old tree restarts from the new root once it runs into a
+   * freed page. Writers wait until the copy has been switched in.
+   */
+  void Rebuild();
+
+  /**
+   * Rebuild() the tree if its leaves are sparse, i.e. a rebuild would need fewer leaves, or if the leaf chain is not
+   * in ascending page order any more.
+   * @return true if the tree was rebuilt
+   */
+  auto Defragment() -> bool;
+
+  /**
+   * Count the pages of every internal level and read a sample of evenly spaced leaves to estimate the number of keys
+   * and values, how full the leaves are, and an equi-depth histogram of the keys. Runs alongside readers and writers,
+   * holding one latch at a time on each level, so the result is a snapshot that concurrent writes can blur.
+   * @param sample_leaves the number of leaves to read
+   * @param num_buckets the number of buckets in the histogram
+   */
+  auto CollectStats(int sample_leaves = BPLUSTREE_STATS_SAMPLE_LEAVES,
+                    int num_buckets = BPLUSTREE_STATS_HISTOGRAM_BUCKETS) -> BPlusTreeStats<KeyType>;
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -62,41 +145,17 @@ class BPlusTree {
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
 
-  //add zjx
-  //Insert part
-  auto FindLeafPage(const KeyType &key, const OperationType operation,Transaction* transaction = nullptr,int location = 0)->B_PLUS_TREE_LEAF_PAGE_TYPE*;
-  auto NewTree()->B_PLUS_TREE_LEAF_PAGE_TYPE*;
-  auto SplitPage(LeafPage * page)->LeafPage *;
-  auto SplitPage(InternalPage *page)->InternalPage *;
-  template <typename Page_type> Page_type *SplitPage(Page_type *node);
-  auto InsertIntoLeaf(LeafPage *leaf_page,const KeyType &key, const ValueType &value, Transaction *transaction)->bool;
-  auto InsertIntoLeafs( 
-    LeafPage *new_leaf, 
-    LeafPage *leaf,
-    const KeyType &key, 
-    const ValueType &value, 
-    Transaction *transaction)->bool;
-  auto InsertIntoInters( 
-    InternalPage *new_inter, 
-    InternalPage *inter,
-    const ValueType &old_value,
-    const KeyType &key, 
-    const ValueType &value, 
-    Transaction *transaction)->bool;
-  auto InsertIntoParent(BPlusTreePage* page)->bool;
-  auto InsertIntoParent(BPlusTreePage* leaf, const KeyType &key, BPlusTreePage* new_leaf, Transaction *transaction)->bool;
-
-  //Move part
-  auto AjustRoot(BPlusTreePage* leaf_page,Transaction *transaction)->bool;
-  template <typename Page_type> auto FindSibling(Page_type *node, bool &isLeftSibling,Transaction* transaction)->Page_type*;
-  template <typename Page_type> auto MergeOrRedistribute(Page_type* page, Transaction* transaction)->bool;
-  template <typename Page_type> auto Merge(Page_type* page, Page_type* sibling_page,bool isLeft)->bool;
-  template <typename Page_type> auto Redistribute(Page_type* page, Page_type* sibling_page,InternalPage* parent_page,bool isLeft)->bool;
-  
-
-  //unlatch the pinned page and unpin the page in buffer pool
-  void UnLatchAndUnpinPageSet(Transaction* transaction, const OperationType operation,bool flush = true);
-  
+  // reverse index iterator, operator++ moves towards smaller keys
+  auto RBegin() -> INDEXITERATOR_TYPE;
+  auto RBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
+
+  /**
+   * Iterate over the keys between `low` and `high`. A missing bound leaves that side of the range open. Forward scans
+   * start at `low` and stop after `high`, reverse scans go the other way round.
+   */
+  auto BeginRange(const std::optional<KeyType> &low, bool low_inclusive, const std::optional<KeyType> &high,
+                  bool high_inclusive, bool reverse = false) -> INDEXITERATOR_TYPE;
+
   // print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -110,8 +169,103 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
+  /**
+   * Descend to the leaf that may contain `key`.
+   * GET descends B-link style, see FindLeafPageRead(); the returned leaf is read latched and pinned and nothing else
+   * is held, the caller releases it with ReleaseReadPage(). INSERT/DELETE crab latches on the way down, and every
+   * page still latched (and the root latch, as a nullptr entry) is in the transaction's page set.
+   * @param location -1 to descend to the leftmost leaf, 1 for the rightmost leaf, 0 to search for `key`
+   * @return the leaf page, or nullptr if the tree is empty
+   */
+  auto FindLeafPage(const KeyType &key, OperationType operation, Transaction *transaction = nullptr,
+                    int location = 0) -> Page *;
+
+  /**
+   * Read-only descent that holds at most one page latch at a time. A page whose range ends at or before `key` was
+   * split after its parent was read, and the reader follows its right link. A reader that lands left of a page's
+   * range or on a deleted page starts over from the root.
+   */
+  auto FindLeafPageRead(const KeyType &key, int location) -> Page *;
+
+  /**
+   * @return where `key` lies relative to the fence keys of `node`: -1 left of its range, 1 right of it, 0 inside
+   * @param location as for FindLeafPage(), a nonzero location stands for a key below or above all keys
+   */
+  auto KeyRangePosition(const BPlusTreePage *node, const KeyType &key, int location = 0) const -> int;
+
+  /** Unlatch and unpin a page taken by a reader, and free it if a merge deleted it while the reader held a pin. */
+  void ReleaseReadPage(Page *page);
+
+  /**
+   * Look up `keys[order[begin..end)]`, which were routed to `page`, and release `page` afterwards. The page is read
+   * latched and pinned; its latch is dropped while a child is visited, so keys that no longer fall under the page
+   * when it is latched again are added to `retry` instead.
+   */
+  void GetValuesBelow(Page *page, const std::vector<KeyType> &keys, const std::vector<size_t> &order, size_t begin,
+                      size_t end, std::vector<std::vector<ValueType>> *result, std::vector<size_t> *retry);
+
+  /** Remove `key` with the single value `value`, or with all its values if `value` is nullptr. */
+  void RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  // posting list helpers, called with the leaf holding the entry at `index` latched
+  auto IsPostingListEntry(const ValueType &value) const -> bool { return !unique_ && IsPostingList(value); }
+  auto AddToPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool;
+  auto RemoveFromPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool;
+  void FreePostingList(page_id_t head_id);
+  auto NewPostingPage(page_id_t *page_id) -> BPlusTreePostingPage *;
+  /** Append the values of a leaf entry to `result`, following its posting list if it has one. */
+  void CollectValues(const ValueType &value, std::vector<ValueType> *result);
+
+  // insertion helpers
+  void NewTree(const KeyType &key, const ValueType &value);
+  auto InsertIntoLeaf(Page *leaf_page, const KeyType &key, const ValueType &value, Transaction *transaction) -> bool;
+  auto SplitLeaf(LeafPage *leaf) -> LeafPage *;
+  auto SplitInternal(InternalPage *node) -> InternalPage *;
+  /** @return how many entries of the full page `node` stay in it when it is split */
+  template <typename N>
+  auto SplitPoint(const N *node) const -> int;
+  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+                        Transaction *transaction);
+
+  // deletion helpers
+  template <typename N>
+  void MergeOrRedistribute(N *node, Transaction *transaction);
+  template <typename N>
+  void Merge(N *neighbor_node, N *node, InternalPage *parent, int index, Transaction *transaction);
+  template <typename N>
+  void Redistribute(N *neighbor_node, N *node, InternalPage *parent, int index);
+  void AdjustRoot(BPlusTreePage *old_root_node, Transaction *transaction);
+
+  /**
+   * Walk the internal level that starts at the read latched and pinned `page` and release it.
+   * @param[out] children the number of children of the level
+   * @return the number of pages of the level
+   */
+  auto CountLevel(Page *page, int *children) -> int;
+  /**
+   * Read `count` evenly spaced ones of the `leaf_count` leaves below the lowest internal level, which starts at the
+   * read latched and pinned `page`, and release it.
+   * @return the number of leaves read
+   */
+  auto SampleLeaves(Page *page, int leaf_count, int count, std::vector<std::pair<KeyType, size_t>> *sample) -> int;
+  /** Append the keys of `leaf` to `sample`, each with the number of its values. */
+  void SampleLeaf(LeafPage *leaf, std::vector<std::pair<KeyType, size_t>> *sample);
+
+  // rebuild helpers
+  /** @return the sizes of the pages that hold `count` entries on one level of a rebuilt tree */
+  auto LevelPageSizes(int count, bool leaf_level) const -> std::vector<int>;
+  /** Copy the leaf chain starting at `first_leaf` into new leaves, appending each one's first key and id to `level`. */
+  void RebuildLeaves(page_id_t first_leaf, int count, std::vector<std::pair<KeyType, page_id_t>> *level);
+  /** Build one level of new internal pages above `level` and replace `level` with it. */
+  void RebuildInternalLevel(std::vector<std::pair<KeyType, page_id_t>> *level);
+
+  // unlatch and unpin every page in the transaction's page set, then drop the pages deleted by this operation
+  void UnLatchAndUnpinPageSet(Transaction *transaction, OperationType operation, bool dirty = true);
+
+  // fetch a page that must exist
+  auto FetchPage(page_id_t page_id) -> Page *;
+
   void UpdateRootPageId(int insert_record = 0);
-  void DeleteRootPageId();
 
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
@@ -125,7 +279,11 @@ class BPlusTree {
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
-  std::mutex root_id_mutex_;
+  bool unique_;
+  int fill_factor_;
+  ReaderWriterLatch root_latch_;
+  /** Held shared by every writer for its whole operation and exclusively by Rebuild(), readers do not take it. */
+  ReaderWriterLatch rebuild_latch_;
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -35,12 +36,31 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                Transaction *transaction) override;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /**
+   * @brief Iterate over the keys between `low` and `high`, an unset bound leaves that side of the range open.
+   * @param reverse walk from `high` down to `low`
+   */
+  auto GetRangeIterator(const std::optional<KeyType> &low, bool low_inclusive, const std::optional<KeyType> &high,
+                        bool high_inclusive, bool reverse = false) -> INDEXITERATOR_TYPE;
+
+  /** @brief Copy the tree into contiguous pages filled to the fill factor, see BPlusTree::Rebuild(). */
+  void Rebuild();
+
+  /** @brief Rebuild the tree if its leaves are sparse or out of order, see BPlusTree::Defragment(). */
+  auto Defragment() -> bool;
+
+  /** @brief Sample the tree, see BPlusTree::CollectStats(), and describe its first key column. */
+  auto CollectStats() -> std::optional<IndexStats> override;
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -59,4 +79,17 @@ using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/**
+ * An integer index with included columns stores them in the key bytes after the integer. The comparator only looks
+ * at the key schema, so they do not take part in the ordering.
+ */
+constexpr static const auto COVERING_KEY_SIZE = 16;
+using CoveringKeyType = GenericKey<COVERING_KEY_SIZE>;
+using CoveringComparatorType = GenericComparator<COVERING_KEY_SIZE>;
+using BPlusTreeCoveringIndexForOneIntegerColumn =
+    BPlusTreeIndex<CoveringKeyType, IntegerValueType, CoveringComparatorType>;
+using BPlusTreeCoveringIndexIteratorForOneIntegerColumn =
+    IndexIterator<CoveringKeyType, IntegerValueType, CoveringComparatorType>;
+using CoveringHashFunctionType = HashFunction<CoveringKeyType>;
+
 }  // namespace bustub
@@ -25,6 +25,11 @@ namespace bustub {
 
 #define HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * ExtendibleHashTableIndex keeps its keys in a DiskExtendibleHashTable. A key is found through the header page, one
+ * directory page and one bucket page, whatever the size of the table, but the keys are in no order, so the index only
+ * answers equality lookups.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTableIndex : public Index {
  public:
@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/config.h"
+#include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,11 +47,23 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param is_unique Whether a key may map to at most one tuple
+   * @param include_attrs The base table columns stored next to the key without being part of it
+   * @param fill_factor How full, in percent, a b+ tree index packs its pages
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = false, std::vector<uint32_t> include_attrs = {},
+                int fill_factor = BPLUSTREE_DEFAULT_FILL_FACTOR)
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(std::move(include_attrs)),
+        is_unique_(is_unique),
+        fill_factor_(fill_factor) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, entry_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +88,21 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return The base table columns stored next to the key, given with `include` */
+  inline auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return include_attrs_; }
+
+  /** @return The base table columns of an index entry, the key columns followed by the included ones */
+  inline auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return entry_attrs_; }
+
+  /** @return A schema object pointer that represents an index entry, the key schema if nothing is included */
+  inline auto GetEntrySchema() const -> Schema * { return entry_schema_.get(); }
+
+  /** @return true if a key may map to at most one tuple */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
+  /** @return How full, in percent, a b+ tree index packs its pages */
+  inline auto GetFillFactor() const -> int { return fill_factor_; }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -92,8 +123,91 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** The base table columns stored next to the key */
+  const std::vector<uint32_t> include_attrs_;
+  /** The key columns followed by the included columns */
+  std::vector<uint32_t> entry_attrs_;
+  /** Whether a key may map to at most one tuple */
+  bool is_unique_;
+  /** How full a b+ tree index packs its pages */
+  int fill_factor_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** The schema of an index entry */
+  std::shared_ptr<Schema> entry_schema_;
+};
+
+/**
+ * IndexStats describes the size of an index and the distribution of its first key column, so that the optimizer can
+ * estimate how many rows a predicate matches. They are collected by `ANALYZE` and kept in the catalog.
+ */
+struct IndexStats {
+  /** Number of levels of the index */
+  uint32_t height_{0};
+  /** Number of pages, leaves included */
+  uint32_t page_count_{0};
+  uint32_t leaf_page_count_{0};
+  /** Average share of a leaf's capacity that is in use */
+  double leaf_fill_{0};
+  uint64_t distinct_keys_{0};
+  /** Number of indexed rows */
+  uint64_t num_rows_{0};
+  /**
+   * Equi-depth histogram of the first key column: the smallest value, then the upper bound of each bucket, and every
+   * bucket holds about the same number of rows.
+   */
+  std::vector<Value> histogram_;
+
+  /**
+   * @return the estimated share of the rows whose first key column lies between `low` and `high`, an unset bound
+   * leaves that side open. Positions within a bucket are interpolated for numeric columns.
+   */
+  auto EstimateSelectivity(const std::optional<Value> &low, bool low_inclusive, const std::optional<Value> &high,
+                           bool high_inclusive) const -> double {
+    if (num_rows_ == 0) {
+      return 0;
+    }
+    // a range, even one that is a single key, matches at least the rows of an average key
+    double min_selectivity = 1.0 / static_cast<double>(std::max<uint64_t>(distinct_keys_, 1));
+    if (histogram_.size() < 2) {
+      return low.has_value() || high.has_value() ? min_selectivity : 1.0;
+    }
+    double below_high = high.has_value() ? ShareBelow(*high, high_inclusive) : 1.0;
+    double below_low = low.has_value() ? ShareBelow(*low, !low_inclusive) : 0.0;
+    if (low.has_value() && high.has_value() && low->CompareGreaterThan(*high) == CmpBool::CmpTrue) {
+      return 0;
+    }
+    return std::clamp(below_high - below_low, min_selectivity, 1.0);
+  }
+
+  auto ToString() const -> std::string {
+    return fmt::format("height={}, pages={}, leaves={}, leaf_fill={:.2f}, distinct_keys={}, rows={}", height_,
+                       page_count_, leaf_page_count_, leaf_fill_, distinct_keys_, num_rows_);
+  }
+
+ private:
+  /** @return the estimated share of the rows whose first key column is below (or at, if `inclusive`) `value` */
+  auto ShareBelow(const Value &value, bool inclusive) const -> double {
+    auto buckets = static_cast<double>(histogram_.size() - 1);
+    if (value.CompareLessThan(histogram_.front()) == CmpBool::CmpTrue ||
+        (!inclusive && value.CompareEquals(histogram_.front()) == CmpBool::CmpTrue)) {
+      return 0;
+    }
+    for (size_t i = 1; i < histogram_.size(); i++) {
+      if (value.CompareGreaterThan(histogram_[i]) == CmpBool::CmpTrue) {
+        continue;
+      }
+      double position = 0.5;
+      if (value.CheckInteger() || value.GetTypeId() == TypeId::DECIMAL) {
+        auto from = histogram_[i - 1].CastAs(TypeId::DECIMAL).GetAs<double>();
+        auto to = histogram_[i].CastAs(TypeId::DECIMAL).GetAs<double>();
+        auto at = value.CastAs(TypeId::DECIMAL).GetAs<double>();
+        position = to > from ? std::clamp((at - from) / (to - from), 0.0, 1.0) : 1.0;
+      }
+      return (static_cast<double>(i - 1) + position) / buckets;
+    }
+    return 1;
+  }
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +253,12 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return The index entry schema, the key schema followed by the included columns */
+  auto GetEntrySchema() const -> Schema * { return metadata_->GetEntrySchema(); }
+
+  /** @return The index entry attributes */
+  auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetEntryAttrs(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,7 +273,7 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index entry, i.e. the key followed by the included columns, see GetEntrySchema()
    * @param rid The RID associated with the key
    * @param transaction The transaction context
    */
@@ -175,6 +295,27 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Search the index for a batch of keys. Indexes that can share work between the probes (e.g. the B+ tree, which
+   * visits each node once for the whole batch) override this, the default probes the keys one by one.
+   * @param keys The index keys
+   * @param result Resized to the number of keys, `(*result)[i]` is populated with the RIDs matching `keys[i]`
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                        Transaction *transaction) {
+    result->assign(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*result)[i], transaction);
+    }
+  }
+
+  /**
+   * Collect statistics of the index for the optimizer.
+   * @return the statistics, or nothing if this kind of index does not keep any
+   */
+  virtual auto CollectStats() -> std::optional<IndexStats> { return std::nullopt; }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
@@ -13,34 +13,108 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <future>  // NOLINT
+#include <optional>
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * IndexIterator walks the leaf level of a B+ tree, forwards or backwards, and optionally stops at a bound key.
+ *
+ * The iterator never holds a latch between calls. When it lands on a leaf it copies the entries out under a read
+ * latch and starts fetching the neighbouring leaf in the scan direction in the background, so the I/O for the next
+ * hop overlaps with consuming the current one. On a hop the neighbour is validated against the leaf it was reached
+ * from (sibling link, key order, not emptied by a merge); if a concurrent split or merge got in the way, the
+ * iterator re-descends from the root using the last key it returned.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using TreeType = BPlusTree<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator(LeafPage* leaf_page, int index, BufferPoolManager* buffer_pool_manager);
+  /** Creates an end iterator. */
+  IndexIterator() = default;
+
+  /**
+   * Creates an iterator positioned on the first entry of a range.
+   * @param tree the tree to scan
+   * @param start where to start, the first/last key of the tree if not set
+   * @param start_inclusive whether an entry equal to `start` is part of the range
+   * @param stop where to stop, the end of the tree if not set
+   * @param stop_inclusive whether an entry equal to `stop` is part of the range
+   * @param reverse iterate from large to small keys
+   */
+  IndexIterator(TreeType *tree, const std::optional<KeyType> &start, bool start_inclusive,
+                const std::optional<KeyType> &stop, bool stop_inclusive, bool reverse);
+
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
   ~IndexIterator();  // NOLINT
 
-  auto IsEnd() -> bool;
+  auto IsEnd() const -> bool;
 
   auto operator*() -> const MappingType &;
 
+  /** Advance in the scan direction, i.e. towards smaller keys for a reverse iterator. */
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool {
+    if (IsEnd() || itr.IsEnd()) {
+      return IsEnd() && itr.IsEnd();
+    }
+    return page_id_ == itr.page_id_ && index_ == itr.index_ && reverse_ == itr.reverse_;
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
-  BPlusTreeLeafPage* leaf_page_;
-  int index_;
-  BufferPoolManager* buffer_pool_manager_;
+  /** Position on the first entry at or after (before, if reverse) `key`. */
+  void Seek(const std::optional<KeyType> &key, bool inclusive);
+  /** Copy the entries of a read latched and pinned leaf, release it, and start prefetching its neighbour. */
+  void LoadLeaf(Page *page, int index);
+  /** Move to the neighbouring leaf until the cursor points at an entry, or the scan is exhausted. */
+  void Settle();
+  /**
+   * @return true if the neighbour we hopped to still links back to the leaf we came from and its key range still
+   * starts where the copied one ended, i.e. no entries moved between the two leaves meanwhile
+   */
+  auto IsValidNeighbour(const LeafPage *leaf) const -> bool;
+  /** @return true if the entry under the cursor lies beyond the stop key */
+  auto PastStop() const -> bool;
+
+  void Prefetch(page_id_t page_id);
+  auto TakePrefetched(page_id_t page_id) -> Page *;
+  void DropPrefetch();
+  void SetEnd();
+
+  TreeType *tree_{nullptr};
+  bool reverse_{false};
+  std::optional<KeyType> stop_;
+  bool stop_inclusive_{true};
+
+  /** The leaf the cursor is on and a copy of its entries. */
+  page_id_t page_id_{INVALID_PAGE_ID};
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  page_id_t prev_page_id_{INVALID_PAGE_ID};
+  std::optional<KeyType> low_key_;
+  std::optional<KeyType> high_key_;
+  std::vector<MappingType> entries_;
+  int index_{0};
+
+  /** The pinned neighbour that is being fetched in the background. */
+  page_id_t prefetch_page_id_{INVALID_PAGE_ID};
+  std::future<Page *> prefetch_;
 };
 
 }  // namespace bustub
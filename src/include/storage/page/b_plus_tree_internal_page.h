@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <queue>
 
 #include "storage/page/b_plus_tree_page.h"
@@ -17,7 +18,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_HEADER_SIZE (32 + 2 * sizeof(KeyType))
 #define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -27,10 +28,22 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
+ * Like leaves, internal pages carry B-link fence keys and a right link to the
+ * next page on the same level. A reader whose key is not below the high key
+ * follows the right link instead of the child pointers.
+ *
  * Internal page format (keys are stored in increasing order):
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 32 + 2 * sizeof(KeyType) bytes in total):
+ *  ---------------------------------------------------------------------------------------
+ * | BPlusTreePage header (24) | RightPageId (4) | HasLowKey (1) | HasHighKey (1) |
+ *  ---------------------------------------------------------------------------------------
+ *  ----------------------------------------------------
+ * | LowKey | HighKey | padding to 4 bytes (2) |
+ *  ----------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -41,28 +54,46 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  auto GetRightPageId() const -> page_id_t;
+  void SetRightPageId(page_id_t right_page_id);
+
+  // fence keys, the subtree holds the keys in [low key, high key) and an unset fence leaves that side open
+  auto GetLowKey() const -> std::optional<KeyType>;
+  void SetLowKey(const std::optional<KeyType> &key);
+  auto GetHighKey() const -> std::optional<KeyType>;
+  void SetHighKey(const std::optional<KeyType> &key);
+  /** @return -1 if `key` is below the low key, 1 if it is not below the high key, 0 if it belongs in this subtree */
+  auto KeyRangePosition(const KeyType &key, const KeyComparator &comparator) const -> int;
 
-  //add zjx
-  auto ValueIndex(const ValueType &value) const->int;
-  auto Lookup(const KeyType &key,const KeyComparator &comparator) const->ValueType;
-  void Remove(const ValueType &value,const KeyComparator &comparator);
-  auto Insert(
-    const KeyType &key, 
-    const ValueType & new_leaf_id, 
-    const KeyComparator& comparator)->bool;
-  auto InsertByIndex(
-    const int index,
-    const KeyType &key, 
-    const ValueType & new_leaf_id)->bool;
-  void MoveData(const int mid,const int distance);
-  void MoveHalfTo(BPlusTreeInternalPage* new_page);
-  void MoveToLast(BPlusTreeInternalPage* sibling_page);
-  void MoveToFirst(BPlusTreeInternalPage* sibling_page);
-  void MoveLastToFirst(BPlusTreeInternalPage* page);
-  void MoveFirstToLast(BPlusTreeInternalPage* page);
-  MappingType* GetArray();
+  /** @return the child pointer whose subtree may contain `key` */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  // insertion and removal of child pointers
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  auto InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) -> int;
+  void Remove(int index);
+  auto RemoveAndReturnOnlyChild() -> ValueType;
+
+  // split and merge utility methods, these also re-parent the moved children
+  void MoveTailTo(BPlusTreeInternalPage *recipient, int keep, BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
 
  private:
+  void CopyNFrom(const MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+  void AdoptChild(const ValueType &child, BufferPoolManager *buffer_pool_manager);
+
+  page_id_t right_page_id_;
+  bool has_low_key_;
+  bool has_high_key_;
+  KeyType low_key_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
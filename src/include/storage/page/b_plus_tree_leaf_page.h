@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -18,54 +19,84 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_HEADER_SIZE (36 + 2 * sizeof(KeyType))
 #define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys are unique within a leaf, a non-unique tree stores the values of
+ * a duplicated key in a posting list that the entry's value points to.
+ *
+ * Leaves form a doubly linked list through NextPageId/PrevPageId so that range
+ * scans can walk them in either direction. The next page id doubles as the
+ * B-link right link: together with the low and high fence keys it lets a reader
+ * that raced with a split find keys that moved to the right sibling.
  *
  * Leaf page format (keys are stored in order):
  *  ----------------------------------------------------------------------
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 36 + 2 * sizeof(KeyType) bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ----------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4) |
+ *  ----------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------
+ * | HasLowKey (1) | HasHighKey (1) | LowKey | HighKey | padding to 4 bytes (2) |
+ *  ----------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID,page_id_t next_page_id = INVALID_PAGE_ID,int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+
+  // fence keys, the page holds the keys in [low key, high key) and an unset fence leaves that side open
+  auto GetLowKey() const -> std::optional<KeyType>;
+  void SetLowKey(const std::optional<KeyType> &key);
+  auto GetHighKey() const -> std::optional<KeyType>;
+  void SetHighKey(const std::optional<KeyType> &key);
+  /** @return -1 if `key` is below the low key, 1 if it is not below the high key, 0 if it belongs on this page */
+  auto KeyRangePosition(const KeyType &key, const KeyComparator &comparator) const -> int;
+
   auto KeyAt(int index) const -> KeyType;
-  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const->int;
-  auto GetItem(int index)-> MappingType ;
+  auto ValueAt(int index) const -> ValueType;
+  void SetValueAt(int index, const ValueType &value);
+  auto GetItem(int index) const -> const MappingType &;
 
-  //add zjx
-  bool LookUp(const KeyType &key, ValueType& result,const KeyComparator& comparator) const;
-  bool Insert(const KeyType &key, ValueType& value,const KeyComparator& comparator) const;
-  void Remove(const KeyType &key, const KeyComparator& comparator) const;
-  void MoveData(const int mid,const int distance);
-  void MoveHalfTo(BPlusTreeLeafPage* new_page);
-  void MoveToLast(BPlusTreeLeafPage* sibling_page);
-  void MoveToFirst(BPlusTreeLeafPage* sibling_page);
-  void MoveLastToFirst(BPlusTreeLeafPage* page);
-  void MoveFirstToLast(BPlusTreeLeafPage* page);
-  MappingType* GetArray();
+  /** @return the index of the first key that is not less than `key`, GetSize() if there is none */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // insertion, lookup and removal of single entries
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+  auto RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> bool;
+
+  // split and merge utility methods, sibling links are maintained by the caller
+  void MoveTailTo(BPlusTreeLeafPage *recipient, int keep);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
+  void CopyNFrom(const MappingType *items, int size);
+
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  bool has_low_key_;
+  bool has_high_key_;
+  KeyType low_key_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
@@ -24,7 +24,8 @@ namespace bustub {
 
 #define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType, typename KeyComparator>
 
-enum class OperationType{INVALID_OPERATION = -1,GET,DELETE,INSERT};
+/** The kind of tree operation a descent is performed for; decides which latches may be released early. */
+enum class OperationType { INVALID_OPERATION = -1, GET, DELETE, INSERT };
 
 // define page type enum
 enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
@@ -48,6 +49,13 @@ class BPlusTreePage {
   auto IsRootPage() const -> bool;
   void SetPageType(IndexPageType page_type);
 
+  /**
+   * A page unlinked from the tree by a merge is marked deleted instead of being freed while readers still hold a pin
+   * on it. Readers that land on it start over from the root.
+   */
+  auto IsDeleted() const -> bool;
+  void MarkDeleted();
+
   auto GetSize() const -> int;
   void SetSize(int size);
   void IncreaseSize(int amount);
@@ -62,13 +70,18 @@ class BPlusTreePage {
   auto GetPageId() const -> page_id_t;
   void SetPageId(page_id_t page_id);
 
-  // void SetLSN(lsn_t lsn = INVALID_LSN);
-  bool IsSafe(OperationType op);
+  void SetLSN(lsn_t lsn = INVALID_LSN);
+
+  /**
+   * @return true if applying one `op` to this page can not split or underflow it, so that the latches held on its
+   * ancestors can be released during a descent
+   */
+  auto IsSafe(OperationType op) const -> bool;
 
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_;
-  // lsn_t lsn_;
+  lsn_t lsn_;
   int size_;
   int max_size_;
   page_id_t parent_page_id_;
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_posting_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 16
+#define POSTING_PAGE_SIZE ((BUSTUB_PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(RID))
+
+/**
+ * In a non-unique B+ tree, a leaf entry whose key has more than one record points to a posting list instead of a
+ * record: its value is RID(id of the first posting page, POSTING_LIST_SLOT). No table page has that many slots.
+ */
+static constexpr uint32_t POSTING_LIST_SLOT = std::numeric_limits<uint32_t>::max();
+
+/** @return true if the value of a leaf entry refers to a posting list */
+inline auto IsPostingList(const RID &value) -> bool {
+  return value.GetSlotNum() == POSTING_LIST_SLOT && value.GetPageId() != INVALID_PAGE_ID;
+}
+
+/**
+ * A posting list stores the RIDs of one key of a non-unique B+ tree, in a chain of overflow pages linked through
+ * NextPageId. The list is kept dense: a removed RID is replaced by the last RID of the chain, so every page but the
+ * last one is full. The head page also records the last page of the chain so appends do not walk it. The pages
+ * belong to the leaf entry that points to them and are only accessed under its latch.
+ *
+ * Posting page format:
+ *  ---------------------------------------------------------------------------------------
+ * | PageId (4) | NextPageId (4) | TailPageId (4) | CurrentSize (4) | RID(1) | ... | RID(n) |
+ *  ---------------------------------------------------------------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  // must call initialize method after "create" a new posting page
+  void Init(page_id_t page_id);
+
+  auto GetPageId() const -> page_id_t;
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  // only maintained on the head page of a chain
+  auto GetTailPageId() const -> page_id_t;
+  void SetTailPageId(page_id_t tail_page_id);
+  auto GetSize() const -> int;
+  auto IsFull() const -> bool;
+
+  auto RidAt(int index) const -> RID;
+  void SetRidAt(int index, const RID &rid);
+  /** @return the index of `rid` on this page, -1 if it is not here */
+  auto Find(const RID &rid) const -> int;
+
+  // RIDs are appended to and taken from the end of the page
+  void Append(const RID &rid);
+  auto PopBack() -> RID;
+
+ private:
+  page_id_t page_id_;
+  page_id_t next_page_id_;
+  page_id_t tail_page_id_;
+  int size_;
+  // Flexible array member for page data.
+  RID rids_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_header_page.h
+//
+// Identification: src/include/storage/page/extendible_hash_table_header_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for extendible hash table.
+ *
+ * The header is the first level of the directory. It maps the top global_depth
+ * bits of a hash to one of the directory pages, which map the low bits of the
+ * hash to buckets. The header is an extendible directory itself: a directory
+ * page with local depth d is shared by the 2^(GD - d) consecutive slots that
+ * agree on the top d bits, and it is split in two by the next bit once it
+ * cannot grow any more.
+ *
+ * Header format (size in byte):
+ * --------------------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | MaxDepth(4) | LocalDepths(512) | DirectoryPageIds(2048) | Free(1520)
+ * --------------------------------------------------------------------------------------------------------
+ */
+class ExtendibleHashTableHeaderPage {
+ public:
+  /**
+   * Initializes a new header page that points at a single directory page.
+   *
+   * @param page_id the page id of this page
+   * @param directory_page_id the page id of the first directory page
+   * @param max_depth the largest global depth the header may grow to
+   */
+  void Init(page_id_t page_id, page_id_t directory_page_id, uint32_t max_depth = HEADER_MAX_DEPTH);
+
+  /**
+   * @return the page ID of this page
+   */
+  auto GetPageId() const -> page_id_t;
+
+  /**
+   * @return the lsn of this page
+   */
+  auto GetLSN() const -> lsn_t;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number to which to set the lsn field
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * Maps a hash to a header slot by its top global_depth bits.
+   *
+   * @param hash the hash of a key
+   * @return the header index of the directory page of the key
+   */
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+
+  /**
+   * @param directory_idx the index in the header to lookup
+   * @return the directory page_id at directory_idx
+   */
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+
+  /**
+   * @param directory_idx the index in the header to update
+   * @param directory_page_id the directory page_id to store
+   */
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+  /**
+   * @return the number of top hash bits the header looks at
+   */
+  auto GetGlobalDepth() const -> uint32_t;
+
+  /**
+   * @return the largest global depth the header may grow to
+   */
+  auto GetMaxDepth() const -> uint32_t;
+
+  /**
+   * Doubles the header. Since slots are picked by the top bits of a hash, slot
+   * i turns into slots 2i and 2i + 1, which both keep its directory page.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * @return the current header size
+   */
+  auto Size() const -> uint32_t;
+
+  /**
+   * @param directory_idx the header index to lookup
+   * @return the number of top hash bits the keys of the directory at directory_idx agree on
+   */
+  auto GetLocalDepth(uint32_t directory_idx) const -> uint32_t;
+
+  /**
+   * @param directory_idx header index to increment
+   */
+  void IncrLocalDepth(uint32_t directory_idx);
+
+  /**
+   * Verify the following invariants:
+   * (1) All LD <= GD <= MaxDepth.
+   * (2) Each directory has precisely 2^(GD - LD) consecutive slots pointing to it.
+   */
+  void VerifyIntegrity() const;
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint32_t max_depth_;
+  uint8_t local_depths_[HEADER_ARRAY_SIZE];
+  page_id_t directory_page_ids_[HEADER_ARRAY_SIZE];
+};
+
+}  // namespace bustub
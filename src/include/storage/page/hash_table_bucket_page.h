@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -31,7 +32,11 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *  The above format omits the space required for the occupied_ and
- *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
+ *  readable_ arrays, and for the fingerprints_ array, which holds one byte of
+ *  the hash of each key. Lookups compare the fingerprints a vector register at
+ *  a time and only compare the keys whose fingerprint matches, so most probes
+ *  for an absent key never compare a key at all. More information is in
+ *  storage/page/hash_table_page_defs.h.
  *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -138,10 +143,28 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  /**
+   * @return the byte of the hash of a key kept in fingerprints_. It is taken
+   * from the bits of the hash that the table does not pick buckets by, so the
+   * keys of one bucket still spread over all of its values.
+   */
+  static auto Fingerprint(const KeyType &key) -> uint8_t;
+
+  /**
+   * Calls visit(bucket_idx) on each readable slot whose fingerprint matches,
+   * in slot order, until visit returns true.
+   *
+   * @return whether visit returned true
+   */
+  template <typename Visitor>
+  auto FindMatching(uint8_t fingerprint, Visitor &&visit) const -> bool;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // One byte of the hash of the key in each slot, see Fingerprint().
+  uint8_t fingerprints_[BUCKET_ARRAY_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
@@ -167,7 +167,7 @@ class HashTableDirectoryPage {
    * is helpful for finding the pair, or "split image", of a bucket.
    *
    * @param bucket_idx bucket index to lookup
-   * @return the high bit corresponding to the bucket's local depth
+   * @return the highest bit of the bucket's local depth mask, 0 for local depth 0
    */
   auto GetLocalHighBit(uint32_t bucket_idx) -> uint32_t;
 
@@ -26,10 +26,16 @@ namespace bustub {
  *
  * Header Page for linear probing hash table.
  *
- * Header format (size in byte, 16 bytes in total):
- * -------------------------------------------------------------
- * | LSN (4) | Size (4) | PageId(4) | NextBlockIndex(4)
- * -------------------------------------------------------------
+ * While the table is being resized, the header of the new table also points
+ * at the header of the old one, and counts the blocks of the old table whose
+ * pairs were moved over already.
+ *
+ * Header format (size in byte, 56 bytes in total, padding included):
+ * ------------------------------------------------------------------------------------------------------------
+ * | LSN (4) | Size (8) | PageId(4) | NextBlockIndex(8) | NumOccupied(8) | OldHeaderPageId(4) | MigratedBlocks(8)
+ * ------------------------------------------------------------------------------------------------------------
+ * | BlockPageIds
+ * ------------------------------------------------------------------------------------------------------------
  */
 class HashTableHeaderPage {
  public:
@@ -72,7 +78,7 @@ class HashTableHeaderPage {
   /**
    * Adds a block page_id to the end of header page
    *
-   * @param page_id page_id to be added
+   * @param page_id page_id to be added, INVALID_PAGE_ID for a block that is not allocated yet
    */
   void AddBlockPageId(page_id_t page_id);
 
@@ -80,22 +86,68 @@ class HashTableHeaderPage {
    * Returns the page_id of the index-th block
    *
    * @param index the index of the block
-   * @return the page_id for the block.
+   * @return the page_id for the block, INVALID_PAGE_ID if it is not allocated yet
    */
   auto GetBlockPageId(size_t index) -> page_id_t;
 
+  /**
+   * Sets the page_id of the index-th block
+   *
+   * @param index the index of the block
+   * @param page_id the page_id for the block
+   */
+  void SetBlockPageId(size_t index, page_id_t page_id);
+
   /**
    * @return the number of blocks currently stored in the header page
    */
   auto NumBlocks() -> size_t;
 
+  /**
+   * @return the largest number of blocks a header page has room for
+   */
+  static auto MaxNumBlocks() -> size_t;
+
+  /**
+   * @return the number of occupied slots, tombstones included
+   */
+  auto GetNumOccupied() const -> size_t;
+
+  /**
+   * @param num_occupied the number of occupied slots, tombstones included
+   */
+  void SetNumOccupied(size_t num_occupied);
+
+  /**
+   * @return the header page of the table this one is resized from, INVALID_PAGE_ID if there is none
+   */
+  auto GetOldHeaderPageId() const -> page_id_t;
+
+  /**
+   * @param page_id the header page of the table this one is resized from
+   */
+  void SetOldHeaderPageId(page_id_t page_id);
+
+  /**
+   * @return the number of leading blocks of the old table that were moved to this one
+   */
+  auto GetMigratedBlocks() const -> size_t;
+
+  /**
+   * @param migrated_blocks the number of leading blocks of the old table that were moved to this one
+   */
+  void SetMigratedBlocks(size_t migrated_blocks);
+
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
+  size_t num_occupied_;
+  page_id_t old_header_page_id_;
+  size_t migrated_blocks_;
   // Flexible array member for page data.
-  __attribute__((unused)) page_id_t block_page_ids_[1];
+  page_id_t block_page_ids_[1];
 };
 
 }  // namespace bustub
@@ -35,16 +35,25 @@
 
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * The computation is the same as the above BLOCK_ARRAY_SIZE, except that a bucket keeps one more byte per pair, the
+ * fingerprint of its key. Blocks and buckets have different implementations of search, insertion, removal, and
+ * helper methods.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * (sizeof(MappingType) + 1) + 1))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
  * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
- * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
- * implementation.
+ * A table spans more than one directory page through its header page, see below.
  */
 #define DIRECTORY_ARRAY_SIZE 512
+#define DIRECTORY_MAX_DEPTH 9
+
+/**
+ * HEADER_ARRAY_SIZE is the number of directory page_ids that can fit in the header page of an extendible hash index,
+ * which is 512 for the same reason as above. A full header and full directories address 2^18 buckets, which is
+ * 66M (key, RID) pairs with 8-byte keys.
+ */
+#define HEADER_ARRAY_SIZE 512
+#define HEADER_MAX_DEPTH 9
@@ -66,36 +66,26 @@ class Page {
   /** Sets the page LSN. */
   inline void SetLSN(lsn_t lsn) { memcpy(GetData() + OFFSET_LSN, &lsn, sizeof(lsn_t)); }
 
+  /*
+   * Pin count and dirty flag are protected by the buffer pool latch, not by the page latch: a page may be fetched or
+   * unpinned while another thread holds its latch.
+   */
+
   /** Set the is_dirty. */
-  inline void SetIsDirty(bool is_dirty){ 
-    WLatch();
-    is_dirty_ = is_dirty;
-    WUnlatch();
-  }
+  inline void SetIsDirty(bool is_dirty) { is_dirty_ = is_dirty; }
 
   /** Decrese the pin_count. */
-  inline void DecPinCnt(){ 
-    WLatch();
-    pin_count_--;
-    WUnlatch();
-  }
+  inline void DecPinCnt() { pin_count_--; }
 
   /** Increase the pin_count. */
-  inline void IncPinCnt(){ 
-    WLatch();
-    pin_count_++;
-    WUnlatch();
-  }
+  inline void IncPinCnt() { pin_count_++; }
 
   /** Reset the page . */
-  inline void Reset(page_id_t page_id) { 
-    WLatch();
+  inline void Reset(page_id_t page_id) {
     ResetMemory();
     pin_count_ = 0;
     is_dirty_ = false;
     SetPageId(page_id);
-    WUnlatch();
-
   }
 
  protected:
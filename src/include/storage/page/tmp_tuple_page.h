@@ -1,15 +1,13 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
  * TmpTuplePage format:
  *
@@ -17,20 +15,61 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ *
+ * The tuples are appended from the end of the page towards its header, so reading from the free space pointer to the
+ * end of the page visits them from the last inserted to the first.
  */
 class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetFreeSpacePointer(page_size);
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  void SetTablePageId(page_id_t page_id) { memcpy(GetData(), &page_id, sizeof(page_id_t)); }
+
+  /** @return The offset of the tuple inserted last, or the size of the page if it is empty */
+  auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /**
+   * Insert a tuple into the page.
+   * @param tuple The tuple
+   * @param[out] out Where the tuple was inserted
+   * @return `false` if the page has no room for the tuple
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    auto free_space = GetFreeSpacePointer();
+    auto size = static_cast<uint32_t>(sizeof(uint32_t) + tuple.GetLength());
+    if (free_space < SIZE_HEADER + size) {
+      return false;
+    }
+    free_space -= size;
+    tuple.SerializeTo(GetData() + free_space);
+    SetFreeSpacePointer(free_space);
+    *out = TmpTuple(GetTablePageId(), free_space);
+    return true;
+  }
+
+  /**
+   * Read the tuple at an offset of the page.
+   * @param offset The offset of the tuple, as given by Insert
+   * @param[out] tuple The tuple
+   * @return The offset of the tuple inserted before it, or the size of the page if it was the first
+   */
+  auto Get(size_t offset, Tuple *tuple) -> size_t {
+    tuple->DeserializeFrom(GetData() + offset);
+    return offset + sizeof(uint32_t) + tuple->GetLength();
+  }
 
  private:
-  static_assert(sizeof(page_id_t) == 4);
+  void SetFreeSpacePointer(uint32_t free_space) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space, sizeof(uint32_t));
+  }
+
+  static constexpr size_t OFFSET_FREE_SPACE = SIZE_PAGE_HEADER;
+  static constexpr size_t SIZE_HEADER = OFFSET_FREE_SPACE + sizeof(uint32_t);
 };
 
 }  // namespace bustub
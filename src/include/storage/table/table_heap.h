@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -99,6 +101,17 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
+  /** @return the ids of the pages of the table, in the order of the page list */
+  auto GetPageIds() -> std::vector<page_id_t>;
+
+  /**
+   * Read every tuple of one page of the table, under a single read latch.
+   * @param page_id the page to read
+   * @param txn transaction performing the read
+   * @param[out] tuples the tuples of the page are appended to it
+   */
+  void GetPageTuples(page_id_t page_id, Transaction *txn, std::vector<Tuple> *tuples);
+
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.h
+//
+// Identification: src/include/storage/table/tmp_tuple_file.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleFile is a sequence of tuples that an executor spilled to temporary pages of the buffer pool, in the
+ * TmpTuplePage format. The tuples are appended to a page-sized buffer in memory, which is copied to a new page once it
+ * is full, so a file never keeps a frame pinned and an executor may append to many files at once. The pages are
+ * deleted with the file.
+ */
+class TmpTupleFile {
+ public:
+  /** @param bpm The buffer pool that holds the pages of the file */
+  explicit TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleFile();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleFile);
+
+  /**
+   * Append a tuple to the file, writing out the buffered page first if it is full.
+   * @throw Exception if the buffer pool has no free frame, or the tuple is larger than a page
+   */
+  void Append(const Tuple &tuple);
+
+  /** Write out the buffered page and free the buffer. Appending after it starts a new page. */
+  void Finish();
+
+  /** @return The number of tuples in the file */
+  auto Size() const -> size_t { return num_tuples_; }
+
+  /** @return The number of pages of the file */
+  auto NumPages() const -> size_t { return page_ids_.size(); }
+
+  /**
+   * Reader reads the tuples of a finished file in the order they were appended. It copies the tuples of a page at a
+   * time out of the buffer pool, so that no page stays pinned between two calls.
+   */
+  class Reader {
+   public:
+    explicit Reader(TmpTupleFile *file) : file_(file) {}
+
+    /** @param[out] tuple The next tuple. @return `false` if the file has no more tuples */
+    auto Next(Tuple *tuple) -> bool;
+
+   private:
+    TmpTupleFile *file_;
+    /** The index of the next page to read */
+    size_t page_idx_{0};
+    /** The tuples of the page that was read last, from the last appended to the first */
+    std::vector<Tuple> tuples_;
+  };
+
+ private:
+  BufferPoolManager *bpm_;
+  /** The pages of the file, in the order they were appended to */
+  std::vector<page_id_t> page_ids_;
+  /** Copy the buffered tuples to a new page of the file, unless there are none. */
+  void FlushBuffer();
+
+  /** The page being appended to, in memory, or nullptr */
+  std::unique_ptr<TmpTuplePage> buffer_;
+  size_t num_tuples_{0};
+};
+
+}  // namespace bustub
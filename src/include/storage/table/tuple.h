@@ -48,6 +48,12 @@ class Tuple {
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move constructor, takes over the data of the other tuple
+  Tuple(Tuple &&other) noexcept;
+
+  // move assign operator, takes over the data of the other tuple
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Split a predicate into the expressions that are and-ed together. */
+void CollectConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    CollectConjuncts(logic->children_[0], conjuncts);
+    CollectConjuncts(logic->children_[1], conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+/** Match `<column> <op> <constant>` (or the other way round) and normalize it so that the column is on the left. */
+auto MatchColumnConstant(const AbstractExpression &expr) -> std::optional<std::tuple<uint32_t, ComparisonType, Value>> {
+  const auto *cmp = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp == nullptr || cmp->comp_type_ == ComparisonType::NotEqual) {
+    return std::nullopt;
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(cmp->children_[0].get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(cmp->children_[1].get());
+  auto comp_type = cmp->comp_type_;
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(cmp->children_[1].get());
+    constant = dynamic_cast<const ConstantValueExpression *>(cmp->children_[0].get());
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0 || constant->val_.IsNull() ||
+      constant->val_.GetTypeId() != column->GetReturnType()) {
+    return std::nullopt;
+  }
+  return std::make_tuple(column->GetColIdx(), comp_type, constant->val_);
+}
+
+/** Narrow one side of the range to `value` if it is tighter than the current bound. */
+void Tighten(std::optional<Value> *bound, bool *inclusive, const Value &value, bool value_inclusive,
+             bool value_is_tighter) {
+  if (!bound->has_value() || value_is_tighter) {
+    *bound = value;
+    *inclusive = value_inclusive;
+    return;
+  }
+  if ((*bound)->CompareEquals(value) == CmpBool::CmpTrue) {
+    *inclusive = *inclusive && value_inclusive;
+  }
+}
+
+/** The comparisons on the key column folded into one range, and the other conjuncts. */
+struct KeyRange {
+  std::optional<Value> lower_bound_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_bound_;
+  bool upper_inclusive_{true};
+  AbstractExpressionRef residual_;
+};
+
+/** Fold every comparison on the key column into a single range, the rest stays in a filter above the scan. */
+auto FoldRange(const std::vector<AbstractExpressionRef> &conjuncts, uint32_t key_column) -> KeyRange {
+  KeyRange range;
+  for (const auto &conjunct : conjuncts) {
+    auto matched = MatchColumnConstant(*conjunct);
+    if (!matched.has_value() || std::get<0>(*matched) != key_column) {
+      range.residual_ = range.residual_ == nullptr
+                            ? conjunct
+                            : std::make_shared<LogicExpression>(range.residual_, conjunct, LogicType::And);
+      continue;
+    }
+    const auto &[col_idx, comp_type, value] = *matched;
+    bool above_lower =
+        range.lower_bound_.has_value() && value.CompareGreaterThan(*range.lower_bound_) == CmpBool::CmpTrue;
+    bool below_upper =
+        range.upper_bound_.has_value() && value.CompareLessThan(*range.upper_bound_) == CmpBool::CmpTrue;
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        Tighten(&range.lower_bound_, &range.lower_inclusive_, value, true, above_lower);
+        Tighten(&range.upper_bound_, &range.upper_inclusive_, value, true, below_upper);
+        break;
+      case ComparisonType::GreaterThan:
+      case ComparisonType::GreaterThanOrEqual:
+        Tighten(&range.lower_bound_, &range.lower_inclusive_, value, comp_type == ComparisonType::GreaterThanOrEqual,
+                above_lower);
+        break;
+      case ComparisonType::LessThan:
+      case ComparisonType::LessThanOrEqual:
+        Tighten(&range.upper_bound_, &range.upper_inclusive_, value, comp_type == ComparisonType::LessThanOrEqual,
+                below_upper);
+        break;
+      default:
+        UNREACHABLE("not equal is never matched as a range");
+    }
+  }
+  return range;
+}
+
+/**
+ * Compare the pages an index scan over the range reads with the pages of a full table scan. The index scan reads
+ * the path to the first leaf, the leaves holding the range and the table page of every matching row, though never
+ * more table pages than there are.
+ */
+auto IndexScanIsCheaper(const IndexStats &stats, const Schema &table_schema, const std::optional<Value> &lower_bound,
+                        bool lower_inclusive, const std::optional<Value> &upper_bound, bool upper_inclusive) -> bool {
+  auto num_rows = static_cast<double>(stats.num_rows_);
+  // every tuple takes a slot of 8 bytes in the table page header besides its data
+  auto rows_per_page = std::max(1.0, static_cast<double>(BUSTUB_PAGE_SIZE) / (table_schema.GetLength() + 8));
+  auto table_pages = std::ceil(num_rows / rows_per_page);
+  auto rows_per_leaf = std::max(1.0, num_rows / std::max<uint32_t>(stats.leaf_page_count_, 1));
+
+  auto matched_rows =
+      num_rows * stats.EstimateSelectivity(lower_bound, lower_inclusive, upper_bound, upper_inclusive);
+  auto index_scan_pages =
+      stats.height_ + std::ceil(matched_rows / rows_per_leaf) + std::min(std::ceil(matched_rows), table_pages);
+  return index_scan_pages < table_pages;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Filter) {
+    return optimized_plan;
+  }
+  const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+  BUSTUB_ENSURE(filter_plan.children_.size() == 1, "Filter should have exactly 1 child.");
+  if (filter_plan.GetChildPlan()->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*filter_plan.GetChildPlan());
+
+  std::vector<AbstractExpressionRef> conjuncts;
+  CollectConjuncts(filter_plan.GetPredicate(), &conjuncts);
+  if (seq_scan_plan.filter_predicate_ != nullptr) {
+    CollectConjuncts(seq_scan_plan.filter_predicate_, &conjuncts);
+  }
+
+  // Use the first column that is compared against a constant and has an index that can answer the comparisons.
+  std::optional<KeyRange> range;
+  std::optional<index_oid_t> index_oid;
+  for (const auto &conjunct : conjuncts) {
+    auto matched = MatchColumnConstant(*conjunct);
+    if (!matched.has_value()) {
+      continue;
+    }
+    range = FoldRange(conjuncts, std::get<0>(*matched));
+    // only an equality on the key can be looked up in a hash index
+    bool is_point = range->lower_bound_.has_value() && range->upper_bound_.has_value() && range->lower_inclusive_ &&
+                    range->upper_inclusive_ &&
+                    range->lower_bound_->CompareEquals(*range->upper_bound_) == CmpBool::CmpTrue;
+    if (auto index = MatchIndex(seq_scan_plan.table_name_, std::get<0>(*matched), !is_point); index.has_value()) {
+      index_oid = std::get<0>(*index);
+      break;
+    }
+  }
+  if (!index_oid.has_value()) {
+    return optimized_plan;
+  }
+  auto &[lower_bound, lower_inclusive, upper_bound, upper_inclusive, residual] = *range;
+
+  // Without statistics the index is always used. With them, only if it reads fewer pages than the table scan.
+  if (const auto *index_info = catalog_.GetIndex(*index_oid); index_info->stats_.has_value()) {
+    const auto *table_info = catalog_.GetTable(seq_scan_plan.GetTableOid());
+    if (!IndexScanIsCheaper(*index_info->stats_, table_info->schema_, lower_bound, lower_inclusive, upper_bound,
+                            upper_inclusive)) {
+      return optimized_plan;
+    }
+  }
+
+  auto index_scan = std::make_shared<IndexScanPlanNode>(seq_scan_plan.output_schema_, *index_oid,
+                                                        std::move(lower_bound), lower_inclusive,
+                                                        std::move(upper_bound), upper_inclusive);
+  if (residual == nullptr) {
+    return index_scan;
+  }
+  return std::make_shared<FilterPlanNode>(filter_plan.output_schema_, residual, index_scan);
+}
+
+}  // namespace bustub
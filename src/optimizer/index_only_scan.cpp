@@ -0,0 +1,88 @@
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Collect the columns of the child plan that an expression reads. */
+void CollectColumns(const AbstractExpressionRef &expr, std::unordered_set<uint32_t> *columns) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    columns->insert(column->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexOnlyScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // The select list (or the aggregation) is what decides which columns are read at all.
+  std::vector<AbstractExpressionRef> exprs;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    const auto &projection_plan = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+    exprs = projection_plan.GetExpressions();
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &aggregation_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    exprs = aggregation_plan.GetGroupBys();
+    exprs.insert(exprs.end(), aggregation_plan.GetAggregates().begin(), aggregation_plan.GetAggregates().end());
+  } else {
+    return optimized_plan;
+  }
+
+  // Filters between them and the scan keep the columns of the scan, but read some more themselves.
+  std::vector<AbstractPlanNodeRef> filters;
+  auto child_plan = optimized_plan->children_[0];
+  while (child_plan->GetType() == PlanType::Filter) {
+    exprs.push_back(dynamic_cast<const FilterPlanNode &>(*child_plan).GetPredicate());
+    filters.push_back(child_plan);
+    child_plan = child_plan->children_[0];
+  }
+  if (child_plan->GetType() != PlanType::IndexScan) {
+    return optimized_plan;
+  }
+  const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+  const auto *index_info = catalog_.GetIndex(index_scan.GetIndexOid());
+  if (index_scan.index_only_ || index_info->index_type_ != IndexType::BPlusTreeIndex) {
+    return optimized_plan;
+  }
+
+  std::unordered_set<uint32_t> columns;
+  for (const auto &expr : exprs) {
+    CollectColumns(expr, &columns);
+  }
+  const auto &entry_attrs = index_info->index_->GetEntryAttrs();
+  const std::unordered_set<uint32_t> covered(entry_attrs.begin(), entry_attrs.end());
+  for (auto column : columns) {
+    if (covered.count(column) == 0) {
+      return optimized_plan;
+    }
+  }
+
+  auto index_only_scan = std::make_shared<IndexScanPlanNode>(index_scan);
+  index_only_scan->index_only_ = true;
+  AbstractPlanNodeRef new_child = index_only_scan;
+  for (auto filter = filters.rbegin(); filter != filters.rend(); ++filter) {
+    new_child = (*filter)->CloneWithChildren({new_child});
+  }
+  return optimized_plan->CloneWithChildren({new_child});
+}
+
+}  // namespace bustub
@@ -2,6 +2,7 @@
 #include <memory>
 #include <optional>
 #include <tuple>
+#include <vector>
 #include "catalog/column.h"
 #include "catalog/schema.h"
 #include "common/exception.h"
@@ -21,15 +22,85 @@
 
 namespace bustub {
 
-auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx)
+auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx, bool ordered)
     -> std::optional<std::tuple<index_oid_t, std::string>> {
   const auto key_attrs = std::vector{index_key_idx};
+  std::optional<std::tuple<index_oid_t, std::string>> matched;
   for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
-    if (key_attrs == index_info->index_->GetKeyAttrs()) {
-      return std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
+    if (key_attrs != index_info->index_->GetKeyAttrs()) {
+      continue;
     }
+    bool is_hash = IsHashIndex(index_info->index_type_);
+    if (is_hash && ordered) {
+      continue;
+    }
+    if (is_hash || !matched.has_value()) {
+      matched = std::make_tuple(index_info->index_oid_, index_info->name_);
+    }
+    if (is_hash) {
+      break;
+    }
+  }
+  return matched;
+}
+
+auto Optimizer::SwapJoinSidesForIndexJoin(const NestedLoopJoinPlanNode &nlj_plan) -> AbstractPlanNodeRef {
+  if (nlj_plan.GetJoinType() != JoinType::INNER || nlj_plan.GetLeftPlan()->GetType() != PlanType::SeqScan ||
+      nlj_plan.GetRightPlan()->GetType() != PlanType::SeqScan) {
+    return nullptr;
+  }
+  const auto &left_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetLeftPlan());
+  const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
+  if (left_seq_scan.filter_predicate_ != nullptr) {
+    return nullptr;
+  }
+  const auto *expr = dynamic_cast<const ComparisonExpression *>(&nlj_plan.Predicate());
+  if (expr == nullptr || expr->comp_type_ != ComparisonType::Equal) {
+    return nullptr;
+  }
+  const auto *first = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+  const auto *second = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+  if (first == nullptr || second == nullptr || first->GetTupleIdx() == second->GetTupleIdx()) {
+    return nullptr;
   }
-  return std::nullopt;
+  const auto *left_expr = first->GetTupleIdx() == 0 ? first : second;
+  const auto *right_expr = first->GetTupleIdx() == 0 ? second : first;
+  auto left_index = MatchIndex(left_seq_scan.table_name_, left_expr->GetColIdx());
+  if (!left_index.has_value()) {
+    return nullptr;
+  }
+
+  // Only statistics can tell which side is smaller, and the index of the bigger one is the one to probe.
+  auto left_cardinality = EstimatedCardinality(left_seq_scan.table_name_);
+  auto right_cardinality = EstimatedCardinality(right_seq_scan.table_name_);
+  if (!left_cardinality.has_value() || !right_cardinality.has_value()) {
+    return nullptr;
+  }
+  if (MatchIndex(right_seq_scan.table_name_, right_expr->GetColIdx()).has_value() &&
+      *left_cardinality <= *right_cardinality) {
+    return nullptr;
+  }
+
+  const auto &left_columns = left_seq_scan.OutputSchema().GetColumns();
+  const auto &right_columns = right_seq_scan.OutputSchema().GetColumns();
+  std::vector<Column> swapped_columns(right_columns);
+  swapped_columns.insert(swapped_columns.end(), left_columns.begin(), left_columns.end());
+  auto [index_oid, index_name] = *left_index;
+  auto index_join = std::make_shared<NestedIndexJoinPlanNode>(
+      std::make_shared<Schema>(swapped_columns), nlj_plan.GetRightPlan(),
+      std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType()),
+      left_seq_scan.GetTableOid(), index_oid, std::move(index_name), left_seq_scan.table_name_,
+      left_seq_scan.output_schema_, JoinType::INNER);
+
+  std::vector<AbstractExpressionRef> exprs;
+  for (uint32_t i = 0; i < left_columns.size(); i++) {
+    exprs.emplace_back(
+        std::make_shared<ColumnValueExpression>(0, right_columns.size() + i, left_columns[i].GetType()));
+  }
+  for (uint32_t i = 0; i < right_columns.size(); i++) {
+    exprs.emplace_back(std::make_shared<ColumnValueExpression>(0, i, right_columns[i].GetType()));
+  }
+  return std::make_shared<ProjectionPlanNode>(nlj_plan.output_schema_, std::move(exprs), std::move(index_join));
 }
 
 auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
@@ -43,6 +114,9 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
     const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
     // Has exactly two children
     BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
+    if (auto swapped = SwapJoinSidesForIndexJoin(nlj_plan); swapped != nullptr) {
+      return swapped;
+    }
     // Check if expr is equal condition where one is for the left table, and one is for the right table.
     if (const auto *expr = dynamic_cast<const ComparisonExpression *>(&nlj_plan.Predicate()); expr != nullptr) {
       if (expr->comp_type_ == ComparisonType::Equal) {
@@ -1,5 +1,6 @@
 #include "optimizer/optimizer.h"
 #include <optional>
+#include "catalog/catalog.h"
 #include "common/util/string_util.h"
 #include "execution/plans/abstract_plan.h"
 
@@ -21,6 +22,11 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
+  for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
+    if (index_info->stats_.has_value()) {
+      return std::make_optional(index_info->stats_->num_rows_);
+    }
+  }
   if (StringUtil::EndsWith(table_name, "_1m")) {
     return std::make_optional(1000000);
   }
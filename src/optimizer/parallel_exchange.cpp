@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "common/config.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/gather_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/repartition_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::EstimatedPipelineRows(const AbstractPlanNode &plan) -> std::optional<size_t> {
+  const auto *leaf = &plan;
+  while (leaf->GetType() == PlanType::Filter || leaf->GetType() == PlanType::Projection) {
+    leaf = leaf->GetChildAt(0).get();
+  }
+  if (leaf->GetType() == PlanType::SeqScan) {
+    return EstimatedCardinality(dynamic_cast<const SeqScanPlanNode &>(*leaf).table_name_);
+  }
+  if (leaf->GetType() == PlanType::MockScan) {
+    return EstimatedCardinality(dynamic_cast<const MockScanPlanNode &>(*leaf).GetTable());
+  }
+  return std::nullopt;
+}
+
+auto Optimizer::OptimizeParallelExchange(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  if (max_parallel_workers_ <= 1) {
+    return plan;
+  }
+  auto is_large = [](std::optional<size_t> rows) {
+    return rows.has_value() && *rows >= static_cast<size_t>(PARALLEL_EXCHANGE_MIN_ROWS);
+  };
+
+  // Tuples that a statement writes could be read again by a scan that runs ahead of it.
+  if (plan->GetType() == PlanType::Insert || plan->GetType() == PlanType::Update ||
+      plan->GetType() == PlanType::Delete) {
+    return plan;
+  }
+
+  if (plan->GetType() == PlanType::HashJoin) {
+    const auto &join_plan = dynamic_cast<const HashJoinPlanNode &>(*plan);
+    auto left_rows = EstimatedPipelineRows(*join_plan.GetLeftPlan());
+    auto right_rows = EstimatedPipelineRows(*join_plan.GetRightPlan());
+    if (left_rows.has_value() && right_rows.has_value() && (is_large(left_rows) || is_large(right_rows))) {
+      // Equal join keys go to the same worker, which joins its partitions of both sides like a serial join.
+      auto left = std::make_shared<RepartitionPlanNode>(
+          join_plan.GetLeftPlan()->output_schema_, join_plan.GetLeftPlan(),
+          std::vector<AbstractExpressionRef>{join_plan.left_key_expression_}, max_parallel_workers_);
+      auto right = std::make_shared<RepartitionPlanNode>(
+          join_plan.GetRightPlan()->output_schema_, join_plan.GetRightPlan(),
+          std::vector<AbstractExpressionRef>{join_plan.right_key_expression_}, max_parallel_workers_);
+      std::vector<AbstractPlanNodeRef> children{left, right};
+      return std::make_shared<GatherPlanNode>(plan->output_schema_, plan->CloneWithChildren(std::move(children)),
+                                              max_parallel_workers_);
+    }
+  }
+
+  if (auto rows = EstimatedPipelineRows(*plan); rows.has_value()) {
+    // A bare scan would only move its tuples from one thread to another.
+    bool has_work = plan->GetType() != PlanType::SeqScan && plan->GetType() != PlanType::MockScan;
+    if (plan->GetType() == PlanType::SeqScan) {
+      has_work = dynamic_cast<const SeqScanPlanNode &>(*plan).filter_predicate_ != nullptr;
+    }
+    if (has_work && is_large(rows)) {
+      return std::make_shared<GatherPlanNode>(plan->output_schema_, plan, max_parallel_workers_);
+    }
+    return plan;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (size_t i = 0; i < plan->GetChildren().size(); i++) {
+    const auto &child = plan->GetChildAt(i);
+    // An aggregation and the build side of a hash join run a pipeline on morsel-driven workers by themselves, and the
+    // inner side of a nested loop join would restart its workers for every outer tuple.
+    bool keep = plan->GetType() == PlanType::Aggregation ||
+                (i == 1 && (plan->GetType() == PlanType::HashJoin || plan->GetType() == PlanType::NestedLoopJoin));
+    children.emplace_back(keep && EstimatedPipelineRows(*child).has_value() ? child
+                                                                             : OptimizeParallelExchange(child));
+  }
+  return plan->CloneWithChildren(std::move(children));
+}
+
+}  // namespace bustub
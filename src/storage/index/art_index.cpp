@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.cpp
+//
+// Identification: src/storage/index/art_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art_index.h"
+
+#include <limits>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ArtIndex::ArtIndex(std::unique_ptr<IndexMetadata> &&metadata) : Index(std::move(metadata)) {
+  for (const auto &column : GetKeySchema()->GetColumns()) {
+    switch (column.GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+      case TypeId::VARCHAR:
+        break;
+      default:
+        throw NotImplementedException("art index only supports integer and varchar key columns");
+    }
+  }
+}
+
+void ArtIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(EncodeEntry(key, rid), rid);
+}
+
+void ArtIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // Only the entry of this tuple goes, not one that another tuple inserted with the same key.
+  container_.Remove(EncodeEntry(key, rid), rid);
+}
+
+void ArtIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  if (GetMetadata()->IsUnique()) {
+    RID rid;
+    if (container_.Lookup(EncodeKey(key), &rid)) {
+      result->push_back(rid);
+    }
+    return;
+  }
+  container_.ScanRange(EncodeBound(key, false), true, EncodeBound(key, true), true, result);
+}
+
+void ArtIndex::ScanRange(const std::optional<Tuple> &low, bool low_inclusive, const std::optional<Tuple> &high,
+                         bool high_inclusive, std::vector<RID> *result, Transaction *transaction) {
+  std::optional<ArtKey> low_key;
+  if (low.has_value()) {
+    // The entries of a key go after its smallest suffix, and an exclusive bound skips up to its largest one.
+    low_key = EncodeBound(*low, !low_inclusive);
+  }
+  std::optional<ArtKey> high_key;
+  if (high.has_value()) {
+    high_key = EncodeBound(*high, high_inclusive);
+  }
+  container_.ScanRange(low_key, low_inclusive, high_key, high_inclusive, result);
+}
+
+auto ArtIndex::EncodeEntry(const Tuple &key, RID rid) const -> ArtKey {
+  auto art_key = EncodeKey(key);
+  if (!GetMetadata()->IsUnique()) {
+    art_key.AppendInteger(rid.Get(), sizeof(int64_t));
+  }
+  return art_key;
+}
+
+auto ArtIndex::EncodeBound(const Tuple &key, bool after_all_rids) const -> ArtKey {
+  auto art_key = EncodeKey(key);
+  if (!GetMetadata()->IsUnique()) {
+    art_key.AppendInteger(after_all_rids ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min(),
+                          sizeof(int64_t));
+  }
+  return art_key;
+}
+
+auto ArtIndex::EncodeKey(const Tuple &key) const -> ArtKey {
+  const auto *key_schema = GetKeySchema();
+  ArtKey art_key;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    auto value = key.GetValue(key_schema, i);
+    switch (key_schema->GetColumn(i).GetType()) {
+      case TypeId::TINYINT:
+        art_key.AppendInteger(value.GetAs<int8_t>(), sizeof(int8_t));
+        break;
+      case TypeId::SMALLINT:
+        art_key.AppendInteger(value.GetAs<int16_t>(), sizeof(int16_t));
+        break;
+      case TypeId::INTEGER:
+        art_key.AppendInteger(value.GetAs<int32_t>(), sizeof(int32_t));
+        break;
+      case TypeId::BIGINT:
+        art_key.AppendInteger(value.GetAs<int64_t>(), sizeof(int64_t));
+        break;
+      case TypeId::VARCHAR:
+        // the stored length counts the terminating zero byte
+        art_key.AppendString(value.GetData(), value.GetLength() - 1);
+        break;
+      default:
+        UNREACHABLE("checked in the constructor");
+    }
+  }
+  return art_key;
+}
+
+}  // namespace bustub
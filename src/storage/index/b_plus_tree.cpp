@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <string>
+#include <type_traits>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -9,43 +13,263 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool unique, int fill_factor)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      // an internal page holds one entry beyond its max size right before it is split, keep room for it
+      internal_max_size_(std::min(
+          internal_max_size,
+          static_cast<int>((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<KeyType, page_id_t>)) -
+              1)),
+      unique_(unique),
+      fill_factor_(std::clamp(fill_factor, BPLUSTREE_MIN_FILL_FACTOR, 100)) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
-  return root_page_id_ == INVALID_PAGE_ID; 
-}
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_PAGE_ID; }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values associated with input key, more than one only in a
+ * non-unique tree
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page = FindLeafPage(key, OperationType::Get, transaction);
-  if( leaf_page == nullptr ){
+  Page *page = FindLeafPage(key, OperationType::GET, transaction);
+  if (page == nullptr) {
     return false;
   }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType value;
+  bool found = leaf->Lookup(key, &value, comparator_);
+  if (found) {
+    CollectValues(value, result);
+  }
+  ReleaseReadPage(page);
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                               Transaction *transaction) {
+  result->assign(keys.size(), {});
+  if (keys.empty()) {
+    return;
+  }
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t lhs, size_t rhs) { return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return;
+  }
+  Page *root = FetchPage(root_page_id_);
+  root_latch_.RUnlock();
+  root->RLatch();
+  std::vector<size_t> retry;
+  GetValuesBelow(root, keys, order, 0, order.size(), result, &retry);
+  // keys that a concurrent split or merge moved away from the path of the batch are looked up on their own
+  for (size_t i : retry) {
+    GetValue(keys[i], &(*result)[i], transaction);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValuesBelow(Page *page, const std::vector<KeyType> &keys, const std::vector<size_t> &order,
+                                    size_t begin, size_t end, std::vector<std::vector<ValueType>> *result,
+                                    std::vector<size_t> *retry) {
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (true) {
+    // The page may have changed since the keys were routed to it, or since its latch was dropped for a child.
+    if (node->IsDeleted()) {
+      for (size_t i = begin; i < end; i++) {
+        retry->push_back(order[i]);
+      }
+      break;
+    }
+    while (begin < end && KeyRangePosition(node, keys[order[begin]]) < 0) {
+      retry->push_back(order[begin++]);
+    }
+    while (end > begin && KeyRangePosition(node, keys[order[end - 1]]) > 0) {
+      retry->push_back(order[--end]);
+    }
+    if (begin == end) {
+      break;
+    }
+
+    if (node->IsLeafPage()) {
+      auto *leaf = reinterpret_cast<LeafPage *>(node);
+      ValueType value;
+      for (size_t i = begin; i < end; i++) {
+        if (leaf->Lookup(keys[order[i]], &value, comparator_)) {
+          CollectValues(value, &(*result)[order[i]]);
+        }
+      }
+      break;
+    }
+
+    // Child `c` gets the keys in [KeyAt(c), KeyAt(c + 1)); visit the child of the smallest remaining key.
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    const KeyType &key = keys[order[begin]];
+    int child = 1;
+    while (child < internal->GetSize() && comparator_(internal->KeyAt(child), key) <= 0) {
+      child++;
+    }
+    size_t group_end = begin + 1;
+    if (child < internal->GetSize()) {
+      while (group_end < end && comparator_(keys[order[group_end]], internal->KeyAt(child)) < 0) {
+        group_end++;
+      }
+    } else {
+      group_end = end;
+    }
+    Page *child_page = FetchPage(internal->ValueAt(child - 1));
+    page->RUnlatch();
+    child_page->RLatch();
+    GetValuesBelow(child_page, keys, order, begin, group_end, result, retry);
+    begin = group_end;
+    page->RLatch();
+  }
+  ReleaseReadPage(page);
+}
 
-  result->resize(1);
-  auto ret = leaf_page->Lookup(key, result[0], comparator_);
-  
-  UnLatchAndUnpinPageSet(transaction,OperationType::Get);
-  // buffer_pool_manager_->UnpinPage(leaf_page->GetPageId());//suppose need to relase now
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, OperationType operation, Transaction *transaction, int location)
+    -> Page * {
+  if (operation == OperationType::GET) {
+    return FindLeafPageRead(key, location);
+  }
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
 
-  return ret;
+  Page *page = FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  page->WLatch();
+  if (node->IsSafe(operation)) {
+    UnLatchAndUnpinPageSet(transaction, operation, false);
+  }
+  transaction->AddIntoPageSet(page);
+
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id;
+    if (location < 0) {
+      child_id = internal->ValueAt(0);
+    } else if (location > 0) {
+      child_id = internal->ValueAt(internal->GetSize() - 1);
+    } else {
+      child_id = internal->Lookup(key, comparator_);
+    }
+
+    Page *child = FetchPage(child_id);
+    node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    child->WLatch();
+    if (node->IsSafe(operation)) {
+      UnLatchAndUnpinPageSet(transaction, operation, false);
+    }
+    transaction->AddIntoPageSet(child);
+    page = child;
+  }
+  return page;
+}
+
+/*
+ * The next page is always pinned before the latch on the current one is dropped, so a merge can unlink it from the
+ * tree but can not free it under the reader; ReleaseReadPage() frees it once the last reader leaves.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageRead(const KeyType &key, int location) -> Page * {
+  while (true) {
+    root_latch_.RLock();
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      root_latch_.RUnlock();
+      return nullptr;
+    }
+    Page *page = FetchPage(root_page_id_);
+    root_latch_.RUnlock();
+    page->RLatch();
+
+    while (true) {
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      int position = node->IsDeleted() ? -1 : KeyRangePosition(node, key, location);
+      if (position < 0) {
+        break;
+      }
+      page_id_t next_id;
+      if (position > 0) {
+        next_id = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->GetNextPageId()
+                                     : reinterpret_cast<InternalPage *>(node)->GetRightPageId();
+      } else if (node->IsLeafPage()) {
+        return page;
+      } else {
+        auto *internal = reinterpret_cast<InternalPage *>(node);
+        if (location < 0) {
+          next_id = internal->ValueAt(0);
+        } else if (location > 0) {
+          next_id = internal->ValueAt(internal->GetSize() - 1);
+        } else {
+          next_id = internal->Lookup(key, comparator_);
+        }
+      }
+      Page *next = FetchPage(next_id);
+      ReleaseReadPage(page);
+      next->RLatch();
+      page = next;
+    }
+    ReleaseReadPage(page);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::KeyRangePosition(const BPlusTreePage *node, const KeyType &key, int location) const -> int {
+  bool has_low;
+  bool has_high;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<const LeafPage *>(node);
+    if (location == 0) {
+      return leaf->KeyRangePosition(key, comparator_);
+    }
+    has_low = leaf->GetLowKey().has_value();
+    has_high = leaf->GetHighKey().has_value();
+  } else {
+    auto *internal = reinterpret_cast<const InternalPage *>(node);
+    if (location == 0) {
+      return internal->KeyRangePosition(key, comparator_);
+    }
+    has_low = internal->GetLowKey().has_value();
+    has_high = internal->GetHighKey().has_value();
+  }
+  if (location < 0) {
+    return has_low ? -1 : 0;
+  }
+  return has_high ? 1 : 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseReadPage(Page *page) {
+  page_id_t page_id = page->GetPageId();
+  bool deleted = reinterpret_cast<BPlusTreePage *>(page->GetData())->IsDeleted();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (deleted) {
+    // fails harmlessly while other readers still hold a pin, the last one to leave frees the page; if that one left
+    // just before the page was marked, the frame is simply evicted like any other unpinned page
+    buffer_pool_manager_->DeletePage(page_id);
+  }
 }
 
 /*****************************************************************************
@@ -55,359 +279,944 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: false if the key already exists in a unique tree, or the key &
+ * value pair already exists in a non-unique one, otherwise true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  BPlusTreeLeafPage *leaf_page = FindLeafPage(key, OperationType::INSERT, transaction);
-  root_id_mutex_.lock();
-  if( leaf_page == nullptr ){
-    if( leaf_page = NewTree() == nullptr) {
-      root_id_mutex_.unlock();
-      return false;
-    }
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  rebuild_latch_.RLock();
+  Page *leaf_page = FindLeafPage(key, OperationType::INSERT, transaction);
+  bool inserted = true;
+  if (leaf_page == nullptr) {
+    // the root latch is still held
+    NewTree(key, value);
+    UnLatchAndUnpinPageSet(transaction, OperationType::INSERT);
+  } else {
+    inserted = InsertIntoLeaf(leaf_page, key, value, transaction);
   }
-  root_id_mutex_.unlock();
-  return InsertIntoLeaf(leaf_page, key, value, transaction);
+  rebuild_latch_.RUnlock();
+  return inserted;
 }
 
+/*
+ * Create a root leaf holding the first entry. Called with the root latch held.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertIntoLeaf(LeafPage *leaf_page,const KeyType &key, const ValueType &value, Transaction *transaction)->bool{
-  // check if the value exists
-  ValueType v;
-  bool isExit = leaf_page->Lookup(key, v, comparator_);
-  if (isExit) {
-    // buffer_pool_manager_->UnpinPage(leaf_page->GetPageId());
-    UnLatchAndUnpinPageSet(transaction, OperationType::INSERT); //unpin the other pages
-    return false;
+void BPLUSTREE_TYPE::NewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the root page of the B+ tree");
   }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
 
-  if( page->GetSize == page->GetMaxSize() ){
-    //split the old pages
-    BPlusTreeLeafPage *new_leaf_page = SplitPage(leaf)
-    if( new_leaf_page == nullptr ){
-      return false;
-    }
-    transaction->AddIntoPageSet(new_leaf_page->GetPageId());
-    InsertIntoLeafs(leaf_page, new_leaf_page, key, value, comparator_);
-    //insert into parent page
-    InsertIntoParent(leaf_page, new_leaf_page->KeyAt(0), new_leaf_page, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertIntoLeaf(Page *leaf_page, const KeyType &key, const ValueType &value,
+                                    Transaction *transaction) -> bool {
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  if (!leaf->Insert(key, value, comparator_)) {
+    // a duplicate key joins the key's posting list, the leaf itself does not grow
+    bool added = !unique_ && AddToPostingList(leaf, leaf->KeyIndex(key, comparator_), value);
+    UnLatchAndUnpinPageSet(transaction, OperationType::INSERT, added);
+    return added;
+  }
+  if (leaf->GetSize() >= leaf->GetMaxSize()) {
+    LeafPage *new_leaf = SplitLeaf(leaf);
+    InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  UnLatchAndUnpinPageSet(transaction, OperationType::INSERT);
+  return true;
+}
 
-  } else {
-    leaf_page->Insert(key, value, comparator_ );//no need to check
-    UnLatchAndUnpinPageSet(transaction, OperationType::INSERT);
-    return true;
+/*
+ * Move the upper half of a full leaf into a new right sibling and link it into
+ * the leaf chain. The new leaf is returned pinned.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SplitLeaf(LeafPage *leaf) -> LeafPage * {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a page to split a B+ tree leaf");
+  }
+  auto *new_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  new_leaf->Init(page_id, leaf->GetParentPageId(), leaf_max_size_);
+  leaf->MoveTailTo(new_leaf, SplitPoint(leaf));
+  // the new leaf takes over the upper part of the key range, readers that still expect those keys here move right
+  new_leaf->SetLowKey(new_leaf->KeyAt(0));
+  new_leaf->SetHighKey(leaf->GetHighKey());
+  leaf->SetHighKey(new_leaf->KeyAt(0));
+
+  new_leaf->SetPrevPageId(leaf->GetPageId());
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
+    // sibling latches are always taken left to right
+    Page *next_page = FetchPage(leaf->GetNextPageId());
+    next_page->WLatch();
+    reinterpret_cast<LeafPage *>(next_page->GetData())->SetPrevPageId(page_id);
+    next_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(next_page->GetPageId(), true);
   }
+  leaf->SetNextPageId(page_id);
+  return new_leaf;
 }
 
+/*
+ * Move the upper half of an overflowing internal page into a new right
+ * sibling and link it in on its level. The new page is returned pinned, its
+ * first key is the separator.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertIntoLeafs( 
-    LeafPage *leaf, 
-    LeafPage *new_leaf,
-    const KeyType &key, 
-    const ValueType &value, 
-    Transaction *transaction)->bool{
-  if( comparator_(new_leaf->KeyAt(0),key) >= 0  ){
-    leaf->Insert(key, value, comparator_ );
-  } else {
-    new_leaf->Insert(key, value, comparator_ );
+auto BPLUSTREE_TYPE::SplitInternal(InternalPage *node) -> InternalPage * {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a page to split a B+ tree internal page");
   }
+  auto *new_node = reinterpret_cast<InternalPage *>(page->GetData());
+  new_node->Init(page_id, node->GetParentPageId(), internal_max_size_);
+  node->MoveTailTo(new_node, SplitPoint(node), buffer_pool_manager_);
+  new_node->SetLowKey(new_node->KeyAt(0));
+  new_node->SetHighKey(node->GetHighKey());
+  new_node->SetRightPageId(node->GetRightPageId());
+  node->SetHighKey(new_node->KeyAt(0));
+  node->SetRightPageId(page_id);
+  return new_node;
 }
 
+/*
+ * A page splits in half, unless it is the rightmost page of its level: keys
+ * arriving in ascending order all end up there, so it keeps the fill factor's
+ * share and the pages it leaves behind stay that full. The new right page gets
+ * at least one entry (two children for an internal page).
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertIntoInters( 
-    InternalPage *new_inter, 
-    InternalPage *inter,
-    const ValueType &old_value,
-    const KeyType &key, 
-    const ValueType &value, 
-    Transaction *transaction)->bool{
-  int index = inter->ValueIndex(old_value);
-  if( index == -1 ){
-    index = new_inter->ValueIndex(old_value);
-    new_inter->InsertByIndex(index,key,value); //insert into internal page
-  } else {
-    inter->InsertByIndex(index,key,value); //insert into internal page
+template <typename N>
+auto BPLUSTREE_TYPE::SplitPoint(const N *node) const -> int {
+  int keep = node->GetMinSize();
+  if (!node->GetHighKey().has_value()) {
+    keep = std::max(keep, node->GetSize() * fill_factor_ / 100);
   }
-  
+  return std::min(keep, node->GetSize() - (node->IsLeafPage() ? 1 : 2));
 }
 
+/*
+ * Insert key & value pair into internal page after split
+ * @param   old_node      input page from split() method
+ * @param   key
+ * @param   new_node      returned page from split() method
+ * User needs to first find the parent page of old_node, parent node must be
+ * adjusted to take info of new_node into account. Remember to deal with split
+ * recursively if necessary.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::SplitPage(InternalPage *page)->InternalPage *{
-    page_id_t new_page_id;
-    Page *new_buffer_page = buffer_pool_manager_->NewPage(new_page_id);
-    if (new_buffer_page == nullptr) {
-        return nullptr;
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    // the old root was not safe, so the root latch is still held
+    page_id_t root_id;
+    Page *page = buffer_pool_manager_->NewPage(&root_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a new root page for the B+ tree");
     }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(root_id);
+    new_node->SetParentPageId(root_id);
+    root_page_id_ = root_id;
+    UpdateRootPageId();
+    buffer_pool_manager_->UnpinPage(root_id, true);
+    return;
+  }
+
+  // the parent is already write latched by this operation
+  page_id_t parent_id = old_node->GetParentPageId();
+  Page *parent_page = FetchPage(parent_id);
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  new_node->SetParentPageId(parent_id);
+  if (parent->GetSize() > parent->GetMaxSize()) {
+    InternalPage *new_parent = SplitInternal(parent);
+    InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+    buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key
+ * If current tree is empty, return immdiately.
+ * If not, User needs to first find the right leaf page as deletion target, then
+ * delete entry from leaf page. Remember to deal with redistribute or merge if
+ * necessary.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  rebuild_latch_.RLock();
+  RemoveEntry(key, nullptr, transaction);
+  rebuild_latch_.RUnlock();
+}
 
-    InternalPage *new_page = reinterpret_cast<InternalPage *>(new_buffer_page->GetData());
-    if( Page_type )
-    new_page->Init(new_page_id, page->GetParentPageId(),internal_max_size_);
-    page->MoveHalfTo(new_page);
-    return new_page;
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  rebuild_latch_.RLock();
+  RemoveEntry(key, &value, transaction);
+  rebuild_latch_.RUnlock();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::SplitPage(LeafPage *page)->LeafPage *{
-    page_id_t new_page_id;
-    Page *new_buffer_page = buffer_pool_manager_->NewPage(new_page_id);
-    if (new_buffer_page == nullptr) {
-        return nullptr;
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction) {
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  Page *leaf_page = FindLeafPage(key, OperationType::DELETE, transaction);
+  if (leaf_page == nullptr) {
+    UnLatchAndUnpinPageSet(transaction, OperationType::DELETE, false);
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+    UnLatchAndUnpinPageSet(transaction, OperationType::DELETE, false);
+    return;
+  }
+  ValueType current = leaf->ValueAt(index);
+  if (value != nullptr && IsPostingListEntry(current)) {
+    // the key stays as long as its posting list is not empty
+    bool removed = RemoveFromPostingList(leaf, index, *value);
+    UnLatchAndUnpinPageSet(transaction, OperationType::DELETE, removed);
+    return;
+  }
+  if (value != nullptr && !(current == *value)) {
+    UnLatchAndUnpinPageSet(transaction, OperationType::DELETE, false);
+    return;
+  }
+  if (IsPostingListEntry(current)) {
+    FreePostingList(current.GetPageId());
+  }
+  leaf->RemoveAndDeleteRecord(key, comparator_);
+  MergeOrRedistribute(leaf, transaction);
+  UnLatchAndUnpinPageSet(transaction, OperationType::DELETE);
+}
+
+/*
+ * If the node underflows, find its sibling: if the two fit into one page,
+ * merge them, otherwise borrow one entry from the sibling. The sibling is
+ * latched and added to the page set; pages that become empty are added to the
+ * deleted page set.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N>
+void BPLUSTREE_TYPE::MergeOrRedistribute(N *node, Transaction *transaction) {
+  if (node->IsRootPage()) {
+    AdjustRoot(node, transaction);
+    return;
+  }
+  if (node->GetSize() >= node->GetMinSize()) {
+    return;
+  }
+
+  page_id_t parent_id = node->GetParentPageId();
+  Page *parent_page = FetchPage(parent_id);
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  int sibling_index = index == 0 ? 1 : index - 1;
+
+  Page *sibling_page = FetchPage(parent->ValueAt(sibling_index));
+  sibling_page->WLatch();
+  transaction->AddIntoPageSet(sibling_page);
+  auto *sibling = reinterpret_cast<N *>(sibling_page->GetData());
+
+  // a leaf splits once it is full, an internal page only once it overflows
+  int capacity = node->IsLeafPage() ? node->GetMaxSize() - 1 : node->GetMaxSize();
+  if (sibling->GetSize() + node->GetSize() <= capacity) {
+    if (index == 0) {
+      // the sibling is on the right, fold it into this node instead
+      Merge(node, sibling, parent, 1, transaction);
+    } else {
+      Merge(sibling, node, parent, index, transaction);
     }
+  } else {
+    Redistribute(sibling, node, parent, index);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
 
-    LeafPage *new_page = reinterpret_cast<LeafPage *>(new_buffer_page->GetData());
-    new_page->Init(new_page_id, page->GetParentPageId(),page->GetNextPageId(),leaf_max_size_);
-    page->SetNextPageId(new_page_id);
-    page->MoveHalfTo(new_page);
-    return new_page;
+/*
+ * Move all entries of `node` into its left neighbour, remove it from the
+ * parent and rebalance the parent. The neighbour's range grows to cover the
+ * range of `node`, which is marked deleted so that readers still holding a pin
+ * on it start over.
+ * @param index position of `node` in the parent
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N>
+void BPLUSTREE_TYPE::Merge(N *neighbor_node, N *node, InternalPage *parent, int index, Transaction *transaction) {
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    node->MoveAllTo(neighbor_node);
+    neighbor_node->SetNextPageId(node->GetNextPageId());
+    if (node->GetNextPageId() != INVALID_PAGE_ID) {
+      Page *next_page = FetchPage(node->GetNextPageId());
+      next_page->WLatch();
+      reinterpret_cast<LeafPage *>(next_page->GetData())->SetPrevPageId(neighbor_node->GetPageId());
+      next_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(next_page->GetPageId(), true);
+    }
+  } else {
+    node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
+    neighbor_node->SetRightPageId(node->GetRightPageId());
+  }
+  neighbor_node->SetHighKey(node->GetHighKey());
+  node->MarkDeleted();
+  transaction->AddIntoDeletedPageSet(node->GetPageId());
+  parent->Remove(index);
+  MergeOrRedistribute(parent, transaction);
 }
 
+/*
+ * Borrow one entry from the neighbour and fix up the separator in the parent.
+ * @param index position of `node` in the parent; 0 means the neighbour is the
+ * right sibling, otherwise it is the left one
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertIntoParent(
-  BPlusTreePage* leaf, 
-  const KeyType &key, 
-  BPlusTreePage* new_leaf, 
-  Transaction *transaction)->bool
-{
-  root_id_mutex_.lock();
-  if( root_page_id_ == leaf->GetPageId() ) {
-    page_id_t new_parent_page_id;
-    Page *new_buffer_page = buffer_pool_manager_->NewPage(new_parent_page_id);
-    if (new_buffer_page == nullptr) {
-      UnLatchAndUnpinPageSet(transaction,OperationType::INSERT,false);
-      // stop the thread
-      return false;
+template <typename N>
+void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, InternalPage *parent, int index) {
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    if (index == 0) {
+      neighbor_node->MoveFirstToEndOf(node);
+      parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+    } else {
+      neighbor_node->MoveLastToFrontOf(node);
+      parent->SetKeyAt(index, node->KeyAt(0));
     }
-    root_page_id_ = new_parent_page_id;
-    UpdateRootPageId();
-    root_id_mutex_.unlock();
-    transaction->AddIntoPageSet(new_parent_page_id);
-    BPlusTreeInternalPage *new_parent_page = reinterpret_cast<BPlusTreeInternalPage *>(new_buffer_page->GetData());
-    new_parent_page->Init(new_parent_page_id,INVALID_PAGE_ID,internal_max_size_);
-    new_parent_page->InsertByIndex(-1,INVALID_PAGE_ID,leaf->GetPageId());
-    new_parent_page->InsertByIndex(0,key,new_leaf->GetPageId());
-    //---
   } else {
-    root_id_mutex_.unlock();
-    Page* buffer_parent_page = buffer_pool_manager_->FetchPage(leaf->GetParentPageId());
-    if( buffer_parent_page == nullptr ){
-      UnLatchAndUnpinPageSet(transaction,OperationType::INSERT,false);
-      return false;
-    } 
-    transaction->AddIntoPageSet(leaf->GetParentPageId());
-    BPlusTreeInternalPage* parent_page = reinterpret_cast<BPlusTreeInternalPage*>(buffer_parent_page->GetData());
-    if( parent_page->GetSize() == parent_page->GetMaxSize() ){
-      BPlusTreeInternalPage* new_parent_page = SplitPage(parent_page);
-      if( new_parent_page == nullptr ){
-        UnLatchAndUnpinPageSet(transaction,OperationType::INSERT,false);
-        return false;
-      }
-      //insert into new pages
-      transaction->AddIntoPageSet(new_parent_page->GetPageId());
-      InsertIntoInters(new_parent_page, parent_page, leaf, key, new_leaf, comparator_);
-      //maybe need to be changed
-      InsertIntoParent(parent_page,new_parent_page->KeyAt(0), new_parent_page, transaction); //recurisve
+    if (index == 0) {
+      neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
+      parent->SetKeyAt(1, neighbor_node->KeyAt(0));
     } else {
-      parent_page->Insert(key,new_leaf,comparator_); //insert the two pages into parent page
+      neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), buffer_pool_manager_);
+      parent->SetKeyAt(index, node->KeyAt(0));
     }
   }
-  UnLatchAndUnpinPageSet(transaction,OperationType::INSERT);
-  // buffer_pool_manager_->UnpinPage(leaf->GetPageId());
-  // buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(),true;);
-  return true;
+  // the boundary between the two pages moved, so do their fences
+  N *left = index == 0 ? node : neighbor_node;
+  N *right = index == 0 ? neighbor_node : node;
+  KeyType separator = parent->KeyAt(index == 0 ? 1 : index);
+  left->SetHighKey(separator);
+  right->SetLowKey(separator);
 }
 
+/*
+ * Update root page if necessary
+ * NOTE: size of root page can be less than min size and this method is only
+ * called within MergeOrRedistribute() method
+ * case 1: when you delete the last element in root page, but root page still
+ * has one last child
+ * case 2: when you delete the last element in whole b+ tree
+ * In both cases the root was not safe for deletion, so the root latch is held.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Transaction *transaction) {
+  if (old_root_node->IsLeafPage()) {
+    if (old_root_node->GetSize() == 0) {
+      old_root_node->MarkDeleted();
+      transaction->AddIntoDeletedPageSet(old_root_node->GetPageId());
+      root_page_id_ = INVALID_PAGE_ID;
+      UpdateRootPageId();
+    }
+    return;
+  }
+  if (old_root_node->GetSize() == 1) {
+    auto *old_root = reinterpret_cast<InternalPage *>(old_root_node);
+    page_id_t child_id = old_root->RemoveAndReturnOnlyChild();
+    Page *child_page = FetchPage(child_id);
+    reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(child_id, true);
+    old_root_node->MarkDeleted();
+    transaction->AddIntoDeletedPageSet(old_root_node->GetPageId());
+    root_page_id_ = child_id;
+    UpdateRootPageId();
+  }
+}
 
+/*
+ * Release the latches (and pins) of all pages this operation still holds,
+ * top-down, then give back the pages that became empty. A nullptr entry stands
+ * for the root latch.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::UnLatchAndUnpinPageSet(Transaction* transaction, const OperationType operation,bool flush){
-  while(!transaction->GetPageSet()->empty()){
-      Page* page = transaction->GetPageSet()->back();
-      transaction->GetPageSet()->pop_back();
-      if( operation == OperationType::Get() ){
-        buffer_pool_manager_->UnpinPage(page->GetPageId());
-        page->RUnlatch();
-        
+void BPLUSTREE_TYPE::UnLatchAndUnpinPageSet(Transaction *transaction, OperationType operation, bool dirty) {
+  auto page_set = transaction->GetPageSet();
+  while (!page_set->empty()) {
+    Page *page = page_set->front();
+    page_set->pop_front();
+    if (page == nullptr) {
+      if (operation == OperationType::GET) {
+        root_latch_.RUnlock();
       } else {
-        if( flush ){
-          buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
-        } else {
-          uffer_pool_manager_->UnpinPage(page->GetPageId());
-        }
-        page->WUnlatch();
-        
+        root_latch_.WUnlock();
       }
+      continue;
     }
+    if (operation == OperationType::GET) {
+      page->RUnlatch();
+    } else {
+      page->WUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), dirty);
+  }
+
+  auto deleted_page_set = transaction->GetDeletedPageSet();
+  for (page_id_t page_id : *deleted_page_set) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  deleted_page_set->clear();
 }
 
 /*****************************************************************************
- * REMOVE
+ * REBUILD
  *****************************************************************************/
 /*
- * Delete key & value pair associated with input key
- * If current tree is empty, return immdiately.
- * If not, User needs to first find the right leaf page as deletion target, then
- * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
+ * Writers are drained first, so the old tree no longer changes and can be
+ * read without latches. Its pages are collected level by level along the right
+ * links, the copy is built bottom-up and switched in under the root latch.
+ * Each old page is then marked deleted and written back, so that fetching its
+ * id later does not bring back the old contents, and freed; a page that a
+ * reader still pins is freed by the last one to leave, see ReleaseReadPage().
+ * Posting lists are shared by the old and the new leaves and stay where they
+ * are.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  if( IsEmpty() ){
+void BPLUSTREE_TYPE::Rebuild() {
+  rebuild_latch_.WLock();
+  std::vector<page_id_t> old_pages;
+  page_id_t first_leaf = INVALID_PAGE_ID;
+  int count = 0;
+  for (page_id_t level_head = root_page_id_; level_head != INVALID_PAGE_ID;) {
+    first_leaf = level_head;
+    page_id_t next_head = INVALID_PAGE_ID;
+    for (page_id_t page_id = level_head; page_id != INVALID_PAGE_ID;) {
+      Page *page = FetchPage(page_id);
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      old_pages.push_back(page_id);
+      page_id_t next_id;
+      if (node->IsLeafPage()) {
+        auto *leaf = reinterpret_cast<LeafPage *>(node);
+        count += leaf->GetSize();
+        next_id = leaf->GetNextPageId();
+      } else {
+        auto *internal = reinterpret_cast<InternalPage *>(node);
+        if (page_id == level_head) {
+          next_head = internal->ValueAt(0);
+        }
+        next_id = internal->GetRightPageId();
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_id;
+    }
+    level_head = next_head;
+  }
+  if (count == 0) {
+    rebuild_latch_.WUnlock();
     return;
-  } 
+  }
 
-  BPlusTreeLeafPage* leaf_page = FindLeafPage(key, OperationType::DELETE, transaction);
-  if( leaf_page == nullptr ){
-    UnLatchAndUnpinPageSet(transaction,OperationType::DELETE,false);
-    return 
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  RebuildLeaves(first_leaf, count, &level);
+  while (level.size() > 1) {
+    RebuildInternalLevel(&level);
   }
-  leaf_page->Remove(key,comparator_);
-  if( leaf_page->GetSize() < leaf_page->GetMinSize() ){
-    MergeOrRedistribute(leaf_page,transaction);
-  } else {
-    UnLatchAndUnpinPageSet(transaction,OperationType::DELETE);
+  root_latch_.WLock();
+  root_page_id_ = level[0].second;
+  UpdateRootPageId();
+  root_latch_.WUnlock();
+  rebuild_latch_.WUnlock();
+
+  for (page_id_t page_id : old_pages) {
+    Page *page = FetchPage(page_id);
+    page->WLatch();
+    reinterpret_cast<BPlusTreePage *>(page->GetData())->MarkDeleted();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    buffer_pool_manager_->FlushPage(page_id);
+    buffer_pool_manager_->DeletePage(page_id);
   }
 }
 
-/**
- * @brief Ajust the Rootpage in 2 cases:
- *        1.the root page is a leaf page, need to be deleted
- *        2.the root page is internal page, only has 1 child, change the root page to the child
- * 
- * @param page 
- * @param transaction 
- * @return true 
- * @return false 
- */
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::AjustRoot(BPlusTreePage* page,Transaction *transaction)->bool{
-  if( page->IsLeafPage() ){
-
-    if( page->GetSize() != 0 ) return buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
-
-    root_id_mutex_.lock();
-    root_page_id_ = INVALID_PAGE_ID;
-    root_id_mutex_.unlock();
-    DeleteRootPageId();
-    UnLatchAndUnpinPageSet(transaction,OperationType::DELETE);
-    return buffer_pool_manager_->DeletePage(page->GetPageId());
-  }
-
-  if( page->GetSize() != 1 ) return UnLatchAndUnpinPageSet(transaction,OperationType::DELETE);
-  BPlusTreeInternalPage* root_page = reinterpret_cast<BPlusTreeInternalPage*>(page);
-  Page* buffer_page = buffer_pool_manager_->Fetch(root_page->array[0].second);
-  if( buffer_page == nullptr ){
-    UnLatchAndUnpinPageSet(transaction,OperationType::DELETE,false);
+/*
+ * The leaf chain is walked with one latch at a time while writers may run, so
+ * the counts are a snapshot that is good enough to decide on a rebuild.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Defragment() -> bool {
+  Page *page = FindLeafPageRead(KeyType{}, -1);
+  if (page == nullptr) {
     return false;
   }
-  transaction->AddIntoPageSet(buffer_page->GetPageId());
-  BPlusTreePage* leaf_page = reinterpret_cast<BPlusTreePage*>(buffer_page->GetData());
-  root_id_mutex_.lock();
-  root_page_id_ = leaf_page->GetPageId();
-  root_id_mutex_.unlock();
-  leaf_page->SetParentPageId(INVALID_PAGE_ID);
-  UpdateRootPageId();
-  UnLatchAndUnpinPageSet(transaction,OperationType::DELETE);
-  return buffer_pool_manager_->DeletePage(page->GetPageId());
+  int leaves = 0;
+  int count = 0;
+  bool in_order = true;
+  while (true) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaves++;
+    count += leaf->GetSize();
+    page_id_t next_id = leaf->GetNextPageId();
+    if (next_id == INVALID_PAGE_ID) {
+      break;
+    }
+    in_order = in_order && next_id > page->GetPageId();
+    Page *next = FetchPage(next_id);
+    ReleaseReadPage(page);
+    next->RLatch();
+    page = next;
+  }
+  ReleaseReadPage(page);
+
+  if (in_order && leaves <= static_cast<int>(LevelPageSizes(count, true).size())) {
+    return false;
+  }
+  Rebuild();
+  return true;
 }
 
-/**
- * @brief 
- * 
- * @param node 
- * @param isLeftSibling 
- * @return Page_type* 
+/*
+ * Pages are filled to the fill factor and the entries are spread evenly, so
+ * the last page of a level is not left nearly empty. Internal pages get at
+ * least three children each, so that no page ends up with a single child.
  */
 INDEX_TEMPLATE_ARGUMENTS
-template <typename Page_type>
-auto BPLUSTREE_TYPE::FindSibling(Page_type *node,  bool &isLeftSibling, Transaction* transaction)->Page_type * {
-  Page* buffer_page = buffer_pool_manager_->Fetch(node->GetParentPageId());
-  if( buffer_page == nullptr ){
-    return nullptr;
+auto BPLUSTREE_TYPE::LevelPageSizes(int count, bool leaf_level) const -> std::vector<int> {
+  int capacity = leaf_level ? std::clamp(leaf_max_size_ * fill_factor_ / 100, 1, leaf_max_size_ - 1)
+                            : std::clamp(internal_max_size_ * fill_factor_ / 100, std::min(3, internal_max_size_),
+                                         internal_max_size_);
+  int pages = std::max(1, (count + capacity - 1) / capacity);
+  std::vector<int> sizes(pages, count / pages);
+  for (int i = 0; i < count % pages; i++) {
+    sizes[i]++;
   }
-  transaction->AddIntoPageSet(buffer_page->GetPageId(),OperationType::DELETE);
-  BPInternalPage *parent_page = reinterpret_cast<BPInternalPage *>(page->GetData());
-  int index = parent_page->ValueIndex(node->GetPageId());
-  int siblingIndex;
-  if (index == 0) {
-      siblingIndex = index + 1;
-      isLeftSibling = false;
-  } else {
-      siblingIndex = index - 1;
-      isLeftSibling = true;
+  return sizes;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebuildLeaves(page_id_t first_leaf, int count,
+                                   std::vector<std::pair<KeyType, page_id_t>> *level) {
+  auto sizes = LevelPageSizes(count, true);
+  LeafPage *new_leaf = nullptr;
+  for (page_id_t page_id = first_leaf; page_id != INVALID_PAGE_ID;) {
+    Page *page = FetchPage(page_id);
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      if (new_leaf == nullptr || new_leaf->GetSize() == sizes[level->size() - 1]) {
+        page_id_t new_id;
+        Page *new_page = buffer_pool_manager_->NewPage(&new_id);
+        if (new_page == nullptr) {
+          throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a page to rebuild the B+ tree");
+        }
+        auto *next_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+        next_leaf->Init(new_id, INVALID_PAGE_ID, leaf_max_size_);
+        if (new_leaf != nullptr) {
+          next_leaf->SetLowKey(leaf->KeyAt(i));
+          next_leaf->SetPrevPageId(new_leaf->GetPageId());
+          new_leaf->SetHighKey(leaf->KeyAt(i));
+          new_leaf->SetNextPageId(new_id);
+          buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+        }
+        new_leaf = next_leaf;
+        level->emplace_back(leaf->KeyAt(i), new_id);
+      }
+      new_leaf->Insert(leaf->KeyAt(i), leaf->ValueAt(i), comparator_);
+    }
+    page_id_t next_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_id;
   }
+  buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+}
 
-  Page* buffer_sibling_page = buffer_pool_manager_->Fetch(parent_page->ValueAt(siblingIndex));
-  if( buffer_sibling_page == nullptr ){
-    return false;
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebuildInternalLevel(std::vector<std::pair<KeyType, page_id_t>> *level) {
+  auto sizes = LevelPageSizes(static_cast<int>(level->size()), false);
+  std::vector<std::pair<KeyType, page_id_t>> parents;
+  InternalPage *node = nullptr;
+  for (const auto &[key, child_id] : *level) {
+    if (node == nullptr || node->GetSize() == sizes[parents.size() - 1]) {
+      page_id_t new_id;
+      Page *new_page = buffer_pool_manager_->NewPage(&new_id);
+      if (new_page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a page to rebuild the B+ tree");
+      }
+      auto *next_node = reinterpret_cast<InternalPage *>(new_page->GetData());
+      next_node->Init(new_id, INVALID_PAGE_ID, internal_max_size_);
+      if (node != nullptr) {
+        next_node->SetLowKey(key);
+        node->SetHighKey(key);
+        node->SetRightPageId(new_id);
+        buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+      }
+      node = next_node;
+      parents.emplace_back(key, new_id);
+    }
+    // the first key of a page is never looked at, like the one a split leaves there
+    node->IncreaseSize(1);
+    node->SetKeyAt(node->GetSize() - 1, key);
+    node->SetValueAt(node->GetSize() - 1, child_id);
+    Page *child = FetchPage(child_id);
+    reinterpret_cast<BPlusTreePage *>(child->GetData())->SetParentPageId(node->GetPageId());
+    buffer_pool_manager_->UnpinPage(child_id, true);
   }
-  transaction->AddIntoPageSet(buffer_sibling_page->GetPageId(),OperationType::DELETE);
-  Page_type* sibling_page = reinterpret_cast<Page_type*>(buffer_sibling_page->GetData());
-  return sibling_page;
+  buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+  *level = std::move(parents);
 }
 
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+/*
+ * The levels are counted top-down. While a level is walked along its right
+ * links, the leftmost page of the level below stays pinned, so the walk can
+ * continue there. Should that page have been freed in the meantime, because a
+ * rebuild or a new root replaced it, the collection starts over.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-template <typename Page_type> auto BPLUSTREE_TYPE::MergeOrRedistribute(Page_type* page, Transaction* transaction)->bool{
-  bool res;
-  if( page->IsRootPage() ){
-    return AjustRoot(page,transaction);
-  } else {
-    bool isLeft;
-    Page_type* sibling_page = FindSibling(page, isLeft,transaction);
-    if( sibling_page == nullptr ){
-      UnLatchAndUnpinPageSet(transaction,OperationType::DELETE,false);
-      return false;
+auto BPLUSTREE_TYPE::CollectStats(int sample_leaves, int num_buckets) -> BPlusTreeStats<KeyType> {
+  while (true) {
+    BPlusTreeStats<KeyType> stats;
+    root_latch_.RLock();
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      root_latch_.RUnlock();
+      return stats;
     }
- 
-    Page* buffer_parent_page = buffer_pool_manager_->Fetch(page->GetParentID());
-    if( buffer_parent_page == nullptr ){
-      return false;
+    Page *page = FetchPage(root_page_id_);
+    root_latch_.RUnlock();
+    page->RLatch();
+
+    // the leftmost page of the lowest internal level, pinned
+    Page *bottom = nullptr;
+    int leaf_count = 1;
+    while (!reinterpret_cast<BPlusTreePage *>(page->GetData())->IsDeleted()) {
+      stats.height_++;
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      if (node->IsLeafPage()) {
+        break;
+      }
+      Page *child = FetchPage(reinterpret_cast<InternalPage *>(node)->ValueAt(0));
+      if (bottom != nullptr) {
+        buffer_pool_manager_->UnpinPage(bottom->GetPageId(), false);
+      }
+      bottom = FetchPage(page->GetPageId());
+      stats.internal_page_count_ += CountLevel(page, &leaf_count);
+      child->RLatch();
+      page = child;
+    }
+    if (reinterpret_cast<BPlusTreePage *>(page->GetData())->IsDeleted()) {
+      ReleaseReadPage(page);
+      if (bottom != nullptr) {
+        buffer_pool_manager_->UnpinPage(bottom->GetPageId(), false);
+      }
+      continue;
     }
-    transaction->AddIntoPageSet(buffer_parent_page->GetPageId(),OperationType::DELETE);
-    BPlusTreeInternalPage* parent_page = reinterpret_cast<BPlusTreeInternalPage*>(buffer_parent_page->GetData());
 
-    if( sibling_page->GetSize() + page->GetSize() <= page->GetMaxSize() ){
-      Merge(sibling_page,page,isLeft);
-      parent_page->Remove(page->GetPageId(),comparator_);
-      if( parent_page->GetSize() < parent_page->GetMinSize() ){
-        return MergeOrRedistribute(parent_page,transaction);
-      } 
+    std::vector<std::pair<KeyType, size_t>> sample;
+    int sampled_leaves = 1;
+    if (bottom == nullptr) {
+      SampleLeaf(reinterpret_cast<LeafPage *>(page->GetData()), &sample);
+      ReleaseReadPage(page);
     } else {
-      Redistribute(sibling_page,page,parent_page,isLeft);
+      ReleaseReadPage(page);
+      bottom->RLatch();
+      sampled_leaves = SampleLeaves(bottom, leaf_count, std::min(sample_leaves, leaf_count), &sample);
+    }
+
+    stats.leaf_page_count_ = leaf_count;
+    if (sample.empty() || sampled_leaves == 0) {
+      return stats;
+    }
+    size_t sampled_values = 0;
+    for (const auto &[key, values] : sample) {
+      sampled_values += values;
+    }
+    double entries_per_leaf = static_cast<double>(sample.size()) / sampled_leaves;
+    stats.leaf_fill_ = entries_per_leaf / std::max(1, leaf_max_size_ - 1);
+    stats.distinct_keys_ = std::llround(entries_per_leaf * leaf_count);
+    stats.num_values_ = std::llround(static_cast<double>(stats.distinct_keys_) * sampled_values / sample.size());
+
+    // bucket `b` ends at the first key where the values seen so far reach b / num_buckets of the sampled ones
+    stats.histogram_.push_back(sample.front().first);
+    size_t seen = 0;
+    int bucket = 1;
+    for (const auto &[key, values] : sample) {
+      seen += values;
+      if (bucket <= num_buckets && seen * num_buckets >= sampled_values * bucket) {
+        stats.histogram_.push_back(key);
+        while (bucket <= num_buckets && seen * num_buckets >= sampled_values * bucket) {
+          bucket++;
+        }
+      }
     }
+    return stats;
   }
-  UnLatchAndUnpinPageSet(transaction,OperationType::DELETE);
-  return res;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-template <typename Page_type> auto BPLUSTREE_TYPE::Merge(Page_type* page, Page_type* sibling_page,bool isLeft)->bool{
-  if( isLeft ){
-    page->MoveToLast(sibling_page);  
+auto BPLUSTREE_TYPE::CountLevel(Page *page, int *children) -> int {
+  int pages = 0;
+  *children = 0;
+  while (true) {
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    // a page that was merged away still links to the rest of its level
+    if (!node->IsDeleted()) {
+      pages++;
+      *children += node->GetSize();
+    }
+    page_id_t next_id = node->GetRightPageId();
+    if (next_id == INVALID_PAGE_ID) {
+      break;
+    }
+    Page *next = FetchPage(next_id);
+    ReleaseReadPage(page);
+    next->RLatch();
+    page = next;
+  }
+  ReleaseReadPage(page);
+  return pages;
+}
+
+/*
+ * A sampled leaf is latched while its parent still is, the order writers
+ * latch them in as well.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SampleLeaves(Page *page, int leaf_count, int count,
+                                  std::vector<std::pair<KeyType, size_t>> *sample) -> int {
+  auto position = [&](int i) { return count == 1 ? 0 : static_cast<int>(int64_t{i} * (leaf_count - 1) / (count - 1)); };
+  int sampled = 0;
+  int index = 0;
+  int next = 0;
+  while (true) {
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    for (int i = 0; !node->IsDeleted() && i < node->GetSize() && next < count; i++, index++) {
+      if (index < position(next)) {
+        continue;
+      }
+      while (next < count && position(next) <= index) {
+        next++;
+      }
+      Page *leaf_page = FetchPage(node->ValueAt(i));
+      leaf_page->RLatch();
+      auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+      if (!leaf->IsDeleted()) {
+        SampleLeaf(leaf, sample);
+        sampled++;
+      }
+      ReleaseReadPage(leaf_page);
+    }
+    page_id_t next_id = node->GetRightPageId();
+    if (next_id == INVALID_PAGE_ID || next >= count) {
+      break;
+    }
+    Page *next_page = FetchPage(next_id);
+    ReleaseReadPage(page);
+    next_page->RLatch();
+    page = next_page;
+  }
+  ReleaseReadPage(page);
+  return sampled;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SampleLeaf(LeafPage *leaf, std::vector<std::pair<KeyType, size_t>> *sample) {
+  std::vector<ValueType> values;
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    values.clear();
+    CollectValues(leaf->ValueAt(i), &values);
+    sample->emplace_back(leaf->KeyAt(i), values.size());
+  }
+}
+
+/*****************************************************************************
+ * POSTING LISTS
+ *****************************************************************************/
+/*
+ * Add `value` to the values of the entry at `index`, turning a single value
+ * into a posting list on the first duplicate. Values are table RIDs, which are
+ * unique, so a posting list takes them without looking for an equal one and
+ * appends go straight to the tail page the head keeps track of.
+ * @return false if the entry already is this single value
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::AddToPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool {
+  ValueType current = leaf->ValueAt(index);
+  if (!IsPostingListEntry(current)) {
+    if (current == value) {
+      return false;
+    }
+    page_id_t head_id;
+    BPlusTreePostingPage *head = NewPostingPage(&head_id);
+    head->Append(current);
+    head->Append(value);
+    leaf->SetValueAt(index, ValueType(head_id, POSTING_LIST_SLOT));
+    buffer_pool_manager_->UnpinPage(head_id, true);
+    return true;
+  }
+
+  page_id_t head_id = current.GetPageId();
+  Page *head_page = FetchPage(head_id);
+  auto *head = reinterpret_cast<BPlusTreePostingPage *>(head_page->GetData());
+  page_id_t tail_id = head->GetTailPageId();
+  BPlusTreePostingPage *tail = head;
+  if (tail_id != head_id) {
+    tail = reinterpret_cast<BPlusTreePostingPage *>(FetchPage(tail_id)->GetData());
+  }
+  // only the last page of the chain can have room
+  if (tail->IsFull()) {
+    page_id_t overflow_id;
+    NewPostingPage(&overflow_id)->Append(value);
+    tail->SetNextPageId(overflow_id);
+    head->SetTailPageId(overflow_id);
+    buffer_pool_manager_->UnpinPage(overflow_id, true);
   } else {
-    sibling_page->MoveToFisrt(page);
+    tail->Append(value);
   }
-  UnLatchAndUnpinPageSet(transaction,OperationType::DELETE);
-  buffer_pool_manager_->DeletePage(page->GetPageId());
+  if (tail_id != head_id) {
+    buffer_pool_manager_->UnpinPage(tail_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(head_id, true);
   return true;
 }
 
+/*
+ * Remove `value` from the posting list of the entry at `index`. The hole is
+ * filled with the last value of the chain, an emptied last page is unlinked,
+ * and a list down to one value is folded back into the leaf entry.
+ * @return false if the list does not have this value
+ */
 INDEX_TEMPLATE_ARGUMENTS
-template <typename Page_type> auto BPLUSTREE_TYPE::Redistribute(Page_type* page, Page_type* sibling_page,InternalPage* parent_page,bool isLeft)->bool{
-  if( isLeft ){
-    KeyType newkey = (sibling_page->GetArray()+(sibling_page->GetSize()-1)).first;
-    int index = parent_page->ValueIndex(page->GetPageId());
-    sibling_page->MoveLastToFisrt(page);
-    parent_page->SetKeyAt(index,newkey);
+auto BPLUSTREE_TYPE::RemoveFromPostingList(LeafPage *leaf, int index, const ValueType &value) -> bool {
+  page_id_t head_id = leaf->ValueAt(index).GetPageId();
+  std::vector<page_id_t> chain;
+  page_id_t found_page_id = INVALID_PAGE_ID;
+  int found_index = -1;
+  for (page_id_t page_id = head_id; page_id != INVALID_PAGE_ID;) {
+    Page *page = FetchPage(page_id);
+    auto *posting = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    chain.push_back(page_id);
+    if (found_index < 0) {
+      found_index = posting->Find(value);
+      found_page_id = page_id;
+    }
+    page_id_t next_id = posting->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_id;
+  }
+  if (found_index < 0) {
+    return false;
+  }
+
+  Page *last_page = FetchPage(chain.back());
+  auto *last = reinterpret_cast<BPlusTreePostingPage *>(last_page->GetData());
+  ValueType moved = last->PopBack();
+  if (found_page_id == chain.back()) {
+    if (found_index < last->GetSize()) {
+      last->SetRidAt(found_index, moved);
+    }
   } else {
-    KeyType newkey = (sibling_page->GetArray()+1).first;
-    int index = parent_page->ValueIndex(sibling_page->GetPageId());
-    sibling_page->MoveFirstToLast(page);
-    parent_page->SetKeyAt(index,newkey);
+    Page *found_page = FetchPage(found_page_id);
+    reinterpret_cast<BPlusTreePostingPage *>(found_page->GetData())->SetRidAt(found_index, moved);
+    buffer_pool_manager_->UnpinPage(found_page_id, true);
+  }
+  bool last_emptied = last->GetSize() == 0;
+  buffer_pool_manager_->UnpinPage(chain.back(), true);
+  if (last_emptied && chain.size() > 1) {
+    Page *prev_page = FetchPage(chain[chain.size() - 2]);
+    reinterpret_cast<BPlusTreePostingPage *>(prev_page->GetData())->SetNextPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+    buffer_pool_manager_->DeletePage(chain.back());
+    chain.pop_back();
+    Page *head_page = FetchPage(head_id);
+    reinterpret_cast<BPlusTreePostingPage *>(head_page->GetData())->SetTailPageId(chain.back());
+    buffer_pool_manager_->UnpinPage(head_id, true);
+  }
+
+  if (chain.size() == 1) {
+    Page *head_page = FetchPage(head_id);
+    auto *head = reinterpret_cast<BPlusTreePostingPage *>(head_page->GetData());
+    bool fold = head->GetSize() == 1;
+    if (fold) {
+      leaf->SetValueAt(index, head->RidAt(0));
+    }
+    buffer_pool_manager_->UnpinPage(head_id, false);
+    if (fold) {
+      buffer_pool_manager_->DeletePage(head_id);
+    }
   }
   return true;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FreePostingList(page_id_t head_id) {
+  for (page_id_t page_id = head_id; page_id != INVALID_PAGE_ID;) {
+    Page *page = FetchPage(page_id);
+    page_id_t next_id = reinterpret_cast<BPlusTreePostingPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_id;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewPostingPage(page_id_t *page_id) -> BPlusTreePostingPage * {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a B+ tree posting list page");
+  }
+  auto *posting = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+  posting->Init(*page_id);
+  return posting;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectValues(const ValueType &value, std::vector<ValueType> *result) {
+  if (!IsPostingListEntry(value)) {
+    result->push_back(value);
+    return;
+  }
+  for (page_id_t page_id = value.GetPageId(); page_id != INVALID_PAGE_ID;) {
+    Page *page = FetchPage(page_id);
+    auto *posting = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    for (int i = 0; i < posting->GetSize(); i++) {
+      result->push_back(posting->RidAt(i));
+    }
+    page_id_t next_id = posting->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_id;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchPage(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch B+ tree page " + std::to_string(page_id));
+  }
+  return page;
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -417,12 +1226,8 @@ template <typename Page_type> auto BPLUSTREE_TYPE::Redistribute(Page_type* page,
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { 
-  BPlusTreeLeafPage* leaf_page = FindLeafPage(INVALID_PAGE_ID,OperationType::Get,comparator_,-1);
-  if( leaf_page == nullptr ){
-    return {};
-  }
-  return INDEXITERATOR_TYPE(leaf_page,0,buffer_pool_manager_); 
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  return INDEXITERATOR_TYPE(this, std::nullopt, true, std::nullopt, true, false);
 }
 
 /*
@@ -432,14 +1237,8 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  BPlusTreeLeafPage* leaf_page =  FindLeafPage(key,OperationType::Get,comparator_);
-  if( leaf_page == nullptr ){
-    return {};
-  }
-  int index = leaf_page->KeyIndex(key, comparator_);
-  return INDEXITERATOR_TYPE(leaf_page,index,buffer_pool_manager_);
-  // return INDEXITERATOR_TYPE(); 
-  }
+  return INDEXITERATOR_TYPE(this, key, true, std::nullopt, true, false);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -447,120 +1246,39 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { 
-  BPlusTreeLeafPage* leaf_page =  FindLeafPage(key,OperationType::Get,comparator_);
-  if( leaf_page == nullptr ){
-    return {}; //maybe need to change
-  }
-  return INDEXITERATOR_TYPE(leaf_page,leaf_page->GetSize()+1,buffer_pool_manager_);
-  // return INDEXITERATOR_TYPE(); 
-  
-}
+auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
 
-/**
- * @return Page id of the root of this tree
+/*
+ * Reverse iterator starting at the largest key
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { 
-  return root_page_id_; 
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  return INDEXITERATOR_TYPE(this, std::nullopt, true, std::nullopt, true, true);
 }
 
-/**
- * @brief 
- * 
- * @param key 
- * @param operation 
- * @param transaction 
- * @return B_PLUS_TREE_LEAF_PAGE_TYPE* remember to unpin by the caller
- */
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key,const OperationType operation,Transaction* transaction,int location)->B_PLUS_TREE_LEAF_PAGE_TYPE*{
-  root_id_mutex_.lock();
-  if( IsEmpty() ) {
-      root_id_mutex_.unlock();
-      return nullptr;
-  }
-  
-  auto page = buffer_pool_manager_->FetchPage(GetRootPageId());
-  if( page == nullptr ){
-    root_id_mutex_.unlock();
-    return nullptr;
-  }
-  root_id_mutex_.unlock();
-  if (operation == OperationType::GET) {
-      page->RLatch();
-  } else {
-      page->WLatch();
-  }
-  transaction->AddIntoPageSet(page);
-
-  BPlusTreePage *tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  while( !tree_page->IsLeafPage() ){   
-    BPlusTreeInternalPage* inter_page =  reinterpret_cast<BPlusTreeInternalPage*>(tree_page);
-    page_id_t next_page_id;
-    if (location == -1) { //leftmost
-      next_page_id = inter_page->ValueAt(0);
-    } else if(location == 1) { //rightmost
-      next_page_id = inter_page->ValueAt(inter_page->GetSize()-1);
-    } else { //point search
-      next_page_id = inter_page->Lookup(key, comparator_);
-    }
-    Page* last_page = page;  //maintain the parent buffer page
-    page = buffer_pool_manager_->FetchPage(next_page_id);
-    if( page == nullptr ){
-      return nullptr;
-    }
-
-    tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
-
-    //lock check
-    if (operation == OperationType::GET) {
-        page->RLatch();
-    } else {
-        page->WLatch();
-    }
-    transaction->AddIntoPageSet(page);
+/*
+ * Reverse iterator starting at the largest key that is not greater than `key`
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  return INDEXITERATOR_TYPE(this, key, true, std::nullopt, true, true);
+}
 
-    if (transaction != nullptr) {
-      if (operation == OperationType::GET) {
-          UnLatchAndUnpinPageSet(transaction, operation);
-          // assert(transaction->GetPageSet()->size() == 0);
-      } else {
-        if (page->IsSafe(operation)) {
-            UnLatchAndUnpinPageSet(transaction, operation);
-        }
-      }
-    } else {
-      // assert(operation == OperationType::GET);
-      last_page->RUnlatch();
-      // if (tree_page->IsRootPage()) {
-      //     root_id_mutex_.unlock();
-      // }
-      buffer_pool_manager_->UnpinPage(last_page->GetPageId(), false);
-    }
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BeginRange(const std::optional<KeyType> &low, bool low_inclusive,
+                                const std::optional<KeyType> &high, bool high_inclusive, bool reverse)
+    -> INDEXITERATOR_TYPE {
+  if (reverse) {
+    return INDEXITERATOR_TYPE(this, high, high_inclusive, low, low_inclusive, true);
   }
-  return static_cast<BPlusTreeLeafPage *>(tree_page); 
+  return INDEXITERATOR_TYPE(this, low, low_inclusive, high, high_inclusive, false);
 }
 
 /**
- * @brief create a new bplus tree, don't need to lock
- * 
- * @return B_PLUS_TREE_LEAF_PAGE_TYPE* 
+ * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::NewTree()->B_PLUS_TREE_LEAF_PAGE_TYPE* {
-  page_id_t page_id;
-  Page* new_page = buffer_pool_manager_->NewPage(page_id);
-  if( new_page == nullptr ) {
-    return nullptr;
-  }
-
-  root_page_id_ = page_id;
-  BPlusTreeLeafPage* leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(new_page->GetData());
-  // buffer_pool_manager_->UnpinPage(page_id); still in use
-  leaf_page->Init(page_id, INVALID_PAGE_ID,I NVALID_PAGE_ID,leaf_max_size_);
-  return leaf_page;
-}
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -576,25 +1294,14 @@ auto BPLUSTREE_TYPE::NewTree()->B_PLUS_TREE_LEAF_PAGE_TYPE* {
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  // a tree that was emptied and then grows again already has a record
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
-//add zjx
-INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::DeleteRootPageId() {
-    HeaderPage *header_page = static_cast<HeaderPage *>(
-      buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-    header_page->DeleteRecord(index_name_);
-    buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
-}
-
 /*
  * This method is used for test only
  * Read data from file and insert one by one
@@ -3,54 +3,260 @@
  */
 #include <cassert>
 
+#include "common/exception.h"
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(LeafPage* leaf_page,int index,BufferPoolManager* buffer_pool_manager):
-    leaf_page_(leaf_page),
-    index_(index),
-    buffer_pool_manager(buffer_pool_manager){
-};
+INDEXITERATOR_TYPE::IndexIterator(TreeType *tree, const std::optional<KeyType> &start, bool start_inclusive,
+                                  const std::optional<KeyType> &stop, bool stop_inclusive, bool reverse)
+    : tree_(tree), reverse_(reverse), stop_(stop), stop_inclusive_(stop_inclusive) {
+  Seek(start, start_inclusive);
+  Settle();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : tree_(other.tree_),
+      reverse_(other.reverse_),
+      stop_(std::move(other.stop_)),
+      stop_inclusive_(other.stop_inclusive_),
+      page_id_(other.page_id_),
+      next_page_id_(other.next_page_id_),
+      prev_page_id_(other.prev_page_id_),
+      low_key_(std::move(other.low_key_)),
+      high_key_(std::move(other.high_key_)),
+      entries_(std::move(other.entries_)),
+      index_(other.index_),
+      prefetch_page_id_(other.prefetch_page_id_),
+      prefetch_(std::move(other.prefetch_)) {
+  other.prefetch_page_id_ = INVALID_PAGE_ID;
+  other.page_id_ = INVALID_PAGE_ID;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { 
-    return (leaf_page_ == nullptr) || (index_ >= leaf_page_->GetSize());
-    // throw std::runtime_error("unimplemented"); 
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> IndexIterator & {
+  if (this != &other) {
+    DropPrefetch();
+    tree_ = other.tree_;
+    reverse_ = other.reverse_;
+    stop_ = std::move(other.stop_);
+    stop_inclusive_ = other.stop_inclusive_;
+    page_id_ = other.page_id_;
+    next_page_id_ = other.next_page_id_;
+    prev_page_id_ = other.prev_page_id_;
+    low_key_ = std::move(other.low_key_);
+    high_key_ = std::move(other.high_key_);
+    entries_ = std::move(other.entries_);
+    index_ = other.index_;
+    prefetch_page_id_ = other.prefetch_page_id_;
+    prefetch_ = std::move(other.prefetch_);
+    other.prefetch_page_id_ = INVALID_PAGE_ID;
+    other.page_id_ = INVALID_PAGE_ID;
+  }
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { 
-    if( IsEnd() ) return {};
-    return leaf_page_->GetItem();
-    // throw std::runtime_error("unimplemented"); 
+INDEXITERATOR_TYPE::~IndexIterator() { DropPrefetch(); }  // NOLINT
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::IsEnd() const -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  BUSTUB_ASSERT(!IsEnd(), "dereferencing an end iterator");
+  return entries_[index_];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { 
-    if( IsEnd() ) return *this;//maybe not return the original one
-    if( index_ < leaf_page->GetSize()-1){
-        index_++;
-    } else if( leaf_page_->GetNextPageId() != INVALID_PAGE_ID ){
-        Page* buffer_next_page = buffer_pool_manager_->FetchPage(leaf_page_->GetNextPageId());
-        if( buffer_next_page == nullptr ){
-            return {};
-        }
-        buffer_pool_manager_->UnpinPage(leaf_page_->GetPageId());
-        BPlusTreeLeafPage* next_page = reinterpret_cast<BPlusTreeLeafPage*>(buffer_next_page->GetData())
-        index_ = 0;
-        leaf_page_ = next_page;
-    }
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  if (IsEnd()) {
     return *this;
-    // throw std::runtime_error("unimplemented"); 
+  }
+  index_ += reverse_ ? -1 : 1;
+  Settle();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Seek(const std::optional<KeyType> &key, bool inclusive) {
+  DropPrefetch();
+  int location = 0;
+  if (!key.has_value()) {
+    location = reverse_ ? 1 : -1;
+  }
+  Page *page = tree_->FindLeafPage(key.value_or(KeyType{}), OperationType::GET, nullptr, location);
+  if (page == nullptr) {
+    SetEnd();
+    return;
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index;
+  if (!key.has_value()) {
+    index = reverse_ ? leaf->GetSize() - 1 : 0;
+  } else {
+    index = leaf->KeyIndex(*key, tree_->comparator_);
+    bool hit = index < leaf->GetSize() && tree_->comparator_(leaf->KeyAt(index), *key) == 0;
+    if (!reverse_ && hit && !inclusive) {
+      index++;
+    }
+    if (reverse_ && !(hit && inclusive)) {
+      index--;
+    }
+  }
+  LoadLeaf(page, index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadLeaf(Page *page, int index) {
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  page_id_ = page->GetPageId();
+  next_page_id_ = leaf->GetNextPageId();
+  prev_page_id_ = leaf->GetPrevPageId();
+  low_key_ = leaf->GetLowKey();
+  high_key_ = leaf->GetHighKey();
+  entries_.clear();
+  // `index` is a leaf slot, a key with a posting list takes one entry per value
+  index_ = index < 0 ? -1 : 0;
+  std::vector<ValueType> values;
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    values.clear();
+    tree_->CollectValues(leaf->ValueAt(i), &values);
+    if (i == index) {
+      index_ = static_cast<int>(entries_.size()) + (reverse_ ? static_cast<int>(values.size()) - 1 : 0);
+    }
+    for (const auto &value : values) {
+      entries_.emplace_back(leaf->KeyAt(i), value);
+    }
+  }
+  if (index >= leaf->GetSize()) {
+    index_ = static_cast<int>(entries_.size());
+  }
+  page->RUnlatch();
+  tree_->buffer_pool_manager_->UnpinPage(page_id_, false);
+
+  // Start reading the neighbour unless the scan is known to end within this leaf.
+  page_id_t neighbour = reverse_ ? prev_page_id_ : next_page_id_;
+  if (neighbour == INVALID_PAGE_ID) {
+    return;
+  }
+  if (stop_.has_value() && !entries_.empty()) {
+    const KeyType &edge = reverse_ ? entries_.front().first : entries_.back().first;
+    int cmp = tree_->comparator_(edge, *stop_);
+    if (reverse_ ? cmp <= 0 : cmp >= 0) {
+      return;
+    }
+  }
+  Prefetch(neighbour);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Settle() {
+  while (!IsEnd()) {
+    if (index_ >= 0 && index_ < static_cast<int>(entries_.size())) {
+      if (PastStop()) {
+        SetEnd();
+      }
+      return;
+    }
+
+    page_id_t neighbour = reverse_ ? prev_page_id_ : next_page_id_;
+    if (neighbour == INVALID_PAGE_ID) {
+      SetEnd();
+      return;
+    }
+    Page *page = TakePrefetched(neighbour);
+    page->RLatch();
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    if (IsValidNeighbour(leaf)) {
+      LoadLeaf(page, reverse_ ? leaf->GetSize() - 1 : 0);
+      continue;
+    }
+    tree_->ReleaseReadPage(page);
+
+    // The leaf was split or merged since we copied it, find our place again from the root.
+    if (entries_.empty()) {
+      SetEnd();
+      return;
+    }
+    KeyType boundary = reverse_ ? entries_.front().first : entries_.back().first;
+    Seek(boundary, false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::IsValidNeighbour(const LeafPage *leaf) const -> bool {
+  if (!leaf->IsLeafPage() || leaf->GetSize() == 0) {
+    return false;
+  }
+  // A redistribution moves the fence between the two leaves, which can hand entries to the copied leaf behind us.
+  if (reverse_) {
+    auto high_key = leaf->GetHighKey();
+    return leaf->GetNextPageId() == page_id_ && high_key.has_value() && low_key_.has_value() &&
+           tree_->comparator_(*high_key, *low_key_) == 0;
+  }
+  auto low_key = leaf->GetLowKey();
+  return leaf->GetPrevPageId() == page_id_ && low_key.has_value() && high_key_.has_value() &&
+         tree_->comparator_(*low_key, *high_key_) == 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::PastStop() const -> bool {
+  if (!stop_.has_value()) {
+    return false;
+  }
+  int cmp = tree_->comparator_(entries_[index_].first, *stop_);
+  if (reverse_) {
+    cmp = -cmp;
+  }
+  return stop_inclusive_ ? cmp > 0 : cmp >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Prefetch(page_id_t page_id) {
+  DropPrefetch();
+  auto *bpm = tree_->buffer_pool_manager_;
+  prefetch_page_id_ = page_id;
+  prefetch_ = std::async(std::launch::async, [bpm, page_id] { return bpm->FetchPage(page_id); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::TakePrefetched(page_id_t page_id) -> Page * {
+  Page *page;
+  if (prefetch_page_id_ == page_id && prefetch_.valid()) {
+    page = prefetch_.get();
+    prefetch_page_id_ = INVALID_PAGE_ID;
+  } else {
+    DropPrefetch();
+    page = tree_->buffer_pool_manager_->FetchPage(page_id);
+  }
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch the next leaf page");
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::DropPrefetch() {
+  if (prefetch_.valid()) {
+    Page *page = prefetch_.get();
+    if (page != nullptr) {
+      tree_->buffer_pool_manager_->UnpinPage(prefetch_page_id_, false);
+    }
+  }
+  prefetch_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SetEnd() {
+  DropPrefetch();
+  page_id_ = INVALID_PAGE_ID;
+  entries_.clear();
+  index_ = 0;
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
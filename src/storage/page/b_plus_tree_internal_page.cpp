@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -27,184 +28,252 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
-  SetParentPageId(parent_id);
+  SetLSN();
+  SetSize(0);
   SetPageId(page_id);
+  SetParentPageId(parent_id);
   SetMaxSize(max_size);
+  SetRightPageId(INVALID_PAGE_ID);
+  SetLowKey(std::nullopt);
+  SetHighKey(std::nullopt);
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  assert(index>=0 && index < GetSize()-1);
-  KeyType key = array_.at[index].first;
-  return key;
-}
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  assert(index>=0 && index < GetSize()-1);
-  array_.at[index].first = key;
-}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
 
 /*
- * Helper method to get the value associated with input "index"(a.k.a array
+ * Helper method to get/set the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { 
-  assert(index>=0 && index < GetSize()-1);
-  ValueType value = array_.at[index].second;
-  return value;
-}
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const->int {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+
+/*
+ * Helper method to find and return array index(or offset), so that its value
+ * equals to input "value"
+ * @return -1 if no such child exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
   for (int i = 0; i < GetSize(); i++) {
-      if (value == ValueAt(i)) {
-          return i;
-      }
+    if (array_[i].second == value) {
+      return i;
+    }
   }
   return -1;
 }
 
-//add zjx
-INDEX_TEMPLATE_ARGUMENTS
-ValueType
-B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key,
-                                       const KeyComparator &comparator) const{  
-  int first = 1;
-  int last = GetSize()-1;
-  int mid;
-  int comp_res;
-
-  while( first <= last ){
-    mid = (first + last)/2;
-    comp_res = comparator(KeyAt(mid),key);
-    if( comp_res > 0 ){
-      last = mid - 1;
-    } else if( comp_res < 0 ) {
-      first = mid+1;
-    } else {
-      break;
-    }
-  }
+/*
+ * Helper methods to get/set the right link to the next page on the same level
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetRightPageId() const -> page_id_t { return right_page_id_; }
 
-  if (comparator(array[mid].first, key) <= 0) {
-      return array[mid].second;
-  } else {
-      return array[mid - 1].second;
-  }
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetRightPageId(page_id_t right_page_id) { right_page_id_ = right_page_id; }
+
+/*
+ * Helper methods to get/set the fence keys
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetLowKey() const -> std::optional<KeyType> {
+  return has_low_key_ ? std::optional<KeyType>(low_key_) : std::nullopt;
 }
-                                       
-
-INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(
-    const KeyType &key, 
-    const ValueType & new_leaf_id, 
-    const KeyComparator& comparator)->bool{
-  int first = 1;
-  int last = GetSize()-1;
-  int mid;
-  int comp_res;
-
-  while( first <= last ){
-    mid = (first + last)/2;
-    comp_res = comparator(KeyAt(mid),key);
-    if( comp_res > 0 ){
-      last = mid - 1;
-    } else if( comp_res < 0 ) {
-      first = mid+1;
-    } else {
-      break;
-    }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetLowKey(const std::optional<KeyType> &key) {
+  has_low_key_ = key.has_value();
+  if (has_low_key_) {
+    low_key_ = *key;
   }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> std::optional<KeyType> {
+  return has_high_key_ ? std::optional<KeyType>(high_key_) : std::nullopt;
+}
 
-  if (comparator(array[mid].first, key) == 0) {
-    return false;
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const std::optional<KeyType> &key) {
+  has_high_key_ = key.has_value();
+  if (has_high_key_) {
+    high_key_ = *key;
   }
+}
 
-  if (comparator(array[mid].first, key) < 0) {
-    MoveData(mid+1,1);
-    array_[mid+1].first = key;
-    array_[mid+1].second = value;
-  } else { //insert before never happen
-    MoveData(mid,1);
-    array_[mid].first = key;
-    array_[mid].second = value;
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyRangePosition(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if (has_low_key_ && comparator(key, low_key_) < 0) {
+    return -1;
   }
+  if (has_high_key_ && comparator(key, high_key_) >= 0) {
+    return 1;
+  }
+  return 0;
+}
 
-  IncreaseSize(1);
-  return true;
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Find and return the child pointer(page_id) which points to the child page
+ * that contains input "key". Start the binary search from the second key since
+ * the first key is always invalid.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  auto *target = std::upper_bound(array_ + 1, array_ + GetSize(), key,
+                                  [&comparator](const KeyType &k, const MappingType &item) {
+                                    return comparator(k, item.first) < 0;
+                                  });
+  return std::prev(target)->second;
 }
 
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Populate new root page with old_value + new_key & new_value
+ * When the insertion cause overflow from leaf page all the way upto the root
+ * page, you should create a new root page and populate its elements.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(const ValueType &value,const KeyComparator &comparator) {
-  int index = ValueIndex(value);
-  MoveData(index,-1);
-  IncreaseSize(-1);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1] = MappingType(new_key, new_value);
+  SetSize(2);
+}
+
+/*
+ * Insert new_key & new_value pair right after the pair with its value ==
+ * old_value
+ * @return: new size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) -> int {
+  int index = ValueIndex(old_value) + 1;
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = MappingType(new_key, new_value);
+  IncreaseSize(1);
+  return GetSize();
 }
 
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Remove the key & value pair in internal page according to input index(a.k.a
+ * array offset)
+ * NOTE: store key&value pair continuously after deletion
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertByIndex(
-    const int index,
-    const KeyType &key, 
-    const ValueType & new_leaf_id)->bool{
-  assert( index>=0 && index < GetMaxSize()-1 );
-  MoveData(index+1,1);
-  array_[index+1].first = key;
-  array_[index+1].second = value;
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
 }
 
+/*
+ * Remove the only key & value pair in internal page and return the value
+ * NOTE: only call this method within AdjustRoot()
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveData(const int mid,const int distance) {
-  memmove(array_[mid+distance], array_[mid],GetSize()-mid);
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() -> ValueType {
+  ValueType only_child = ValueAt(0);
+  SetSize(0);
+  return only_child;
 }
 
+/*****************************************************************************
+ * SPLIT / MERGE
+ *****************************************************************************/
+/*
+ * Remove the key & value pairs after the first `keep` ones from this page to
+ * "recipient" page. The first key moved becomes the (invalid) first key of the
+ * recipient, the caller pushes it up into the parent.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage* new_page) {
-  int mid = GetSize()/2;
-  memmove(array_[mid], new_page->GetArray(),GetSize()-mid);
-  IncreaseSize(-mid);
-  page->IncreaseSize(mid);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveTailTo(BPlusTreeInternalPage *recipient, int keep,
+                                                BufferPoolManager *buffer_pool_manager) {
+  int moved = GetSize() - keep;
+  recipient->CopyNFrom(array_ + keep, moved, buffer_pool_manager);
+  IncreaseSize(-moved);
 }
 
+/*
+ * Remove all of key & value pairs from this page to "recipient" page.
+ * The middle_key is the separation key you should get from the parent. You need
+ * to make sure the middle key is added to the recipient to maintain the invariant.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveToLast(BPlusTreeInternalPage* sibling_page){
-  memmove(sibling_page->GetArray()+sibling_page->GetSize(), array_[0], GetSize());
-  sibling_page->IncreaseSize(GetSize());
-  IncreaseSize(GetSize());
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                               BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyNFrom(array_, GetSize(), buffer_pool_manager);
+  SetSize(0);
 }
 
+/*
+ * Remove the first key & value pair from this page to tail of "recipient" page.
+ * The middle_key is the separation key from the parent; afterwards KeyAt(0) of
+ * this page holds the key that must replace it in the parent.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveToFirst(BPlusTreeInternalPage* sibling_page){
-  sibling_page->MoveData(0,GetSize());
-  memmove(sibling_page->GetArray(), array_[0], GetSize());
-  sibling_page->IncreaseSize(GetSize());
-  IncreaseSize(GetSize());
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyNFrom(array_, 1, buffer_pool_manager);
+  Remove(0);
 }
 
+/*
+ * Remove the last key & value pair from this page to head of "recipient" page.
+ * Afterwards KeyAt(0) of the recipient holds the key that must replace the
+ * middle_key in the parent.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFirst(BPlusTreeInternalPage* page){
-  page->MoveData(0,1);
-  memmove(page->GetArray()+page->GetSize()-1, array_[0],1);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  recipient->SetKeyAt(0, middle_key);
+  std::move_backward(recipient->array_, recipient->array_ + recipient->GetSize(),
+                     recipient->array_ + recipient->GetSize() + 1);
+  recipient->array_[0] = array_[GetSize() - 1];
+  recipient->IncreaseSize(1);
+  recipient->AdoptChild(recipient->array_[0].second, buffer_pool_manager);
   IncreaseSize(-1);
-  page->IncreaseSize(1);
 }
 
+/*
+ * Append `size` entries to this page and point the moved children at it
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToLast(BPlusTreeInternalPage* page){
-  memmove(page->GetArray()+page->GetSize(), array_[0],1);
-  MoveData(1,-1);
-  IncreaseSize(-1);
-  page->IncreaseSize(1);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const MappingType *items, int size,
+                                               BufferPoolManager *buffer_pool_manager) {
+  std::copy(items, items + size, array_ + GetSize());
+  IncreaseSize(size);
+  for (int i = 0; i < size; i++) {
+    AdoptChild(items[i].second, buffer_pool_manager);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-MappingType* B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetArray(){
-  return array_;
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::AdoptChild(const ValueType &child, BufferPoolManager *buffer_pool_manager) {
+  Page *page = buffer_pool_manager->FetchPage(child);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch child page while re-parenting");
+  }
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(child, true);
 }
 
 // valuetype for internalNode should be page id_t
@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
@@ -24,203 +25,209 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next/prev page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id,page_id_t next_page_id,int max_size){
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
   SetPageType(IndexPageType::LEAF_PAGE);
-  SetParentPageId(parent_id);
+  SetLSN();
+  SetSize(0);
   SetPageId(page_id);
+  SetParentPageId(parent_id);
   SetMaxSize(max_size);
-  SetNextPageId(next_page_id);
-  SetSize(0);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  SetLowKey(std::nullopt);
+  SetHighKey(std::nullopt);
 }
 
 /**
- * Helper methods to set/get next page id
+ * Helper methods to set/get next and previous page id
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { 
-  return next_page_id_; 
-}
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
-  next_page_id_ = next_page_id;
-}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
 
 /*
- * Helper method to find and return the key associated with input "index"(a.k.a
- * array offset)
+ * Helper methods to get/set the fence keys
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key = array_.at[index].first;
-  return key;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetLowKey() const -> std::optional<KeyType> {
+  return has_low_key_ ? std::optional<KeyType>(low_key_) : std::nullopt;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(
-    const KeyType &key, const KeyComparator &comparator) const->int {
-    int left = 0;
-    int right = GetSize() - 1;
-    int mid;
-    int compareResult;
-    while (left <= right) {
-        mid = left + (right - left) / 2;  //(left + right)
-        compareResult = comparator(array[mid].first, key);
-        if (compareResult == 0) {
-            return mid;
-        } else if (compareResult < 0) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
-    }
-    return left;
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetLowKey(const std::optional<KeyType> &key) {
+  has_low_key_ = key.has_value();
+  if (has_low_key_) {
+    low_key_ = *key;
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index)-> MappingType {
-  assert(index>=0 && index <= GetSize());
-  return array_[index];
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const -> std::optional<KeyType> {
+  return has_high_key_ ? std::optional<KeyType>(high_key_) : std::nullopt;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-bool B_PLUS_TREE_LEAF_PAGE_TYPE::LookUp(const KeyType &key, ValueType& result,const KeyComparator& comparator) const {
-  int first = 0;
-  int last = GetSize()-1;
-  int mid;
-  int comp_res;
-
-  while( first <= last ){
-    mid = (first + last)/2;
-    comp_res = comparator(KeyAt(mid),key);
-    if( comp_res > 0 ){
-      last = mid - 1;
-    } else if( comp_res < 0 ) {
-      first = mid+1;
-    } else {
-      break;
-    }
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const std::optional<KeyType> &key) {
+  has_high_key_ = key.has_value();
+  if (has_high_key_) {
+    high_key_ = *key;
   }
+}
 
-  if (comparator(array[mid].first, key) == 0) {
-    result = array_[mid].second;
-    return true;
-  } else {
-    return false;
-  }
-} 
-
-INDEX_TEMPLATE_ARGUMENTS
-bool B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, ValueType& value,const KeyComparator& comparator) const {
-  int first = 0;
-  int last = GetSize()-1;
-  int mid = -1;
-  int comp_res;
-
-  while( first <= last ){
-    mid = (first + last)/2;
-    comp_res = comparator(ValueAt(mid),key);
-    if( comp_res > 0 ){
-      last = mid - 1;
-    } else if( comp_res < 0 ) {
-      first = mid + 1;
-    } else {
-      break;
-    }
-  } 
-  
-  if( mid == -1){
-    array_[0].first = key;
-    array_[0].second = value;
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyRangePosition(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if (has_low_key_ && comparator(key, low_key_) < 0) {
+    return -1;
   }
-  
-  if (comparator(array[mid].first, key) == 0) {
-    return false; //duplicate key
-  } else {
-    MoveData(mid+1,1);
-    array_[mid+1].first = key;
-    array_[mid+1].second = value;
+  if (has_high_key_ && comparator(key, high_key_) >= 0) {
+    return 1;
   }
-  IncreaseSize(1);
-  return true;
+  return 0;
 }
 
+/*
+ * Helper method to find and return the key associated with input "index"(a.k.a
+ * array offset)
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator& comparator) const{
-  int first = 0;
-  int last = GetSize()-1;
-  int mid;
-  int comp_res;
-
-  while( first <= last ){
-    mid = (first + last)/2;
-    comp_res = comparator(KeyAt(mid),key);
-    if( comp_res > 0 ){
-      last = mid - 1;
-    } else if( comp_res < 0 ) {
-      first = mid+1;
-    } else {
-      break;
-    }
-  }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const -> const MappingType & { return array_[index]; }
+
+/*
+ * Binary search for the first slot whose key is >= `key`.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  auto *target = std::lower_bound(array_, array_ + GetSize(), key,
+                                  [&comparator](const MappingType &item, const KeyType &k) {
+                                    return comparator(item.first, k) < 0;
+                                  });
+  return static_cast<int>(std::distance(array_, target));
+}
 
-  if (comparator(array[mid].first, key) == 0) {
-    MoveData(mid,-1);
-    IncreaseSize(-1);
-  } 
+/*****************************************************************************
+ * LOOKUP / INSERTION / REMOVAL
+ *****************************************************************************/
+/*
+ * For the given key, check to see whether it exists in the leaf page. If it
+ * does, then store its corresponding value in input "value" and return true.
+ * If the key does not exist, then return false
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
+    -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return false;
+  }
+  *value = array_[index].second;
+  return true;
 }
 
+/*
+ * Insert key & value pair into leaf page ordered by key
+ * @return false if the key already exists, duplicates are handled by the tree
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveData(const int mid,const int distance) {
-  memmove(array_[mid+distance], array_[mid],GetSize()-mid);
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
+    -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && comparator(array_[index].first, key) == 0) {
+    return false;
+  }
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = MappingType(key, value);
+  IncreaseSize(1);
+  return true;
 }
 
+/*
+ * First look through leaf page to see whether delete key exist or not. If
+ * exist, perform deletion, otherwise return immediately.
+ * @return true if a record was deleted
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage* new_page) {
-  int mid = GetSize()/2;
-  memmove(array_[mid], new_page->GetArray(),GetSize()-mid);
-  IncreaseSize(-mid);
-  page->IncreaseSize(mid);
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return false;
+  }
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
+  return true;
 }
 
+/*****************************************************************************
+ * SPLIT / MERGE
+ *****************************************************************************/
+/*
+ * Remove the key & value pairs after the first `keep` ones from this page to
+ * "recipient" page
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveToLast(BPlusTreeLeafPage* sibling_page){
-  memmove(sibling_page->GetArray()+sibling_page->GetSize(), array_[0], GetSize());
-  sibling_page->IncreaseSize(GetSize());
-  IncreaseSize(GetSize());
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveTailTo(BPlusTreeLeafPage *recipient, int keep) {
+  int moved = GetSize() - keep;
+  recipient->CopyNFrom(array_ + keep, moved);
+  IncreaseSize(-moved);
 }
 
+/*
+ * Remove all of key & value pairs from this page to the end of "recipient" page
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveToFirst(BPlusTreeLeafPage* sibling_page){
-  sibling_page->MoveData(0,GetSize());
-  memmove(sibling_page->GetArray(), array_[0], GetSize());
-  sibling_page->IncreaseSize(GetSize());
-  IncreaseSize(GetSize());
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  recipient->CopyNFrom(array_, GetSize());
+  SetSize(0);
 }
 
+/*
+ * Remove the first key & value pair from this page to the end of "recipient" page
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFirst(BPlusTreeLeafPage* page){
-  page->MoveData(0,1);
-  memmove(page->GetArray()+page->GetSize()-1, array_[0],1);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->CopyNFrom(array_, 1);
+  std::move(array_ + 1, array_ + GetSize(), array_);
   IncreaseSize(-1);
-  page->IncreaseSize(1);
 }
 
+/*
+ * Remove the last key & value pair from this page to the front of "recipient" page
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToLast(BPlusTreeLeafPage* page){
-  memmove(page->GetArray()+page->GetSize(), array_[0],1);
-  MoveData(1,-1);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  std::move_backward(recipient->array_, recipient->array_ + recipient->GetSize(),
+                     recipient->array_ + recipient->GetSize() + 1);
+  recipient->array_[0] = array_[GetSize() - 1];
+  recipient->IncreaseSize(1);
   IncreaseSize(-1);
-  page->IncreaseSize(1);
 }
 
+/*
+ * Append `size` items to the end of this page
+ */
 INDEX_TEMPLATE_ARGUMENTS
-MappingType* B_PLUS_TREE_LEAF_PAGE_TYPE::GetArray(){
-  return array_;
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  std::copy(items, items + size, array_ + GetSize());
+  IncreaseSize(size);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
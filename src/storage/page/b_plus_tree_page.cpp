@@ -17,82 +17,68 @@ namespace bustub {
  * Helper methods to get/set page type
  * Page type enum class is defined in b_plus_tree_page.h
  */
-auto BPlusTreePage::IsLeafPage() const -> bool { 
-    return page_type_ == IndexPageType::LEAF_PAGE; 
-}
-auto BPlusTreePage::IsRootPage() const -> bool { //to be fixed
-    return page_id_ == INVALID_PAGE_ID; 
-}
-void BPlusTreePage::SetPageType(IndexPageType page_type) {
-    page_type_ = page_type;
-}
+auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+auto BPlusTreePage::IsRootPage() const -> bool { return parent_page_id_ == INVALID_PAGE_ID; }
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
+auto BPlusTreePage::IsDeleted() const -> bool { return page_type_ == IndexPageType::INVALID_INDEX_PAGE; }
+void BPlusTreePage::MarkDeleted() { page_type_ = IndexPageType::INVALID_INDEX_PAGE; }
 
 /*
  * Helper methods to get/set size (number of key/value pairs stored in that
  * page)
  */
-auto BPlusTreePage::GetSize() const -> int { 
-    return size_; 
-}
-void BPlusTreePage::SetSize(int size) {
-    size_ = size;
-}
-void BPlusTreePage::IncreaseSize(int amount) {
-    size_ += amount;
-}
+auto BPlusTreePage::GetSize() const -> int { return size_; }
+void BPlusTreePage::SetSize(int size) { size_ = size; }
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
 
 /*
  * Helper methods to get/set max size (capacity) of the page
  */
-auto BPlusTreePage::GetMaxSize() const -> int { 
-    return max_size_; 
-}
-void BPlusTreePage::SetMaxSize(int size) {
-    max_size_ = size;
-}
+auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
+void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
  * Generally, min page size == max page size / 2
+ * Internal pages count their (invalid) first key, so they round up.
  */
-auto BPlusTreePage::GetMinSize() const -> int { 
-    return max_size_/2; 
-}
+auto BPlusTreePage::GetMinSize() const -> int { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
 
 /*
  * Helper methods to get/set parent page id
  */
-auto BPlusTreePage::GetParentPageId() const -> page_id_t { 
-    return parent_page_id_; 
-}
-void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) {
-    parent_page_id_ = parent_page_id;
-}
+auto BPlusTreePage::GetParentPageId() const -> page_id_t { return parent_page_id_; }
+void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) { parent_page_id_ = parent_page_id; }
 
 /*
  * Helper methods to get/set self page id
  */
-auto BPlusTreePage::GetPageId() const -> page_id_t { 
-    return page_id_; 
-}
-void BPlusTreePage::SetPageId(page_id_t page_id) {
-    page_id_ = page_id;
-}
+auto BPlusTreePage::GetPageId() const -> page_id_t { return page_id_; }
+void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
 
 /*
  * Helper methods to set lsn
  */
-// void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-bool BPlusTreePage::IsSafe(OperationType op) {
-    if (op == OperationType::GET) {
-        return true;
-    } else if (op == OperationType::INSERT) {
-        return GetSize() < GetMaxSize();
-    } else if (op == OperationType::DELETE) {
-        return GetSize() > GetMinSize();
-    }
-    return false;
+/*
+ * A leaf splits once it reaches max size, an internal page once it exceeds it. The root underflows only when it
+ * becomes empty (leaf) or is left with a single child (internal).
+ */
+auto BPlusTreePage::IsSafe(OperationType op) const -> bool {
+  switch (op) {
+    case OperationType::GET:
+      return true;
+    case OperationType::INSERT:
+      return IsLeafPage() ? GetSize() + 1 < GetMaxSize() : GetSize() < GetMaxSize();
+    case OperationType::DELETE:
+      if (IsRootPage()) {
+        return IsLeafPage() ? GetSize() > 1 : GetSize() > 2;
+      }
+      return GetSize() > GetMinSize();
+    default:
+      return false;
+  }
 }
 
 }  // namespace bustub
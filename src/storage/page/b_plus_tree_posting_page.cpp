@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_posting_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void BPlusTreePostingPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  next_page_id_ = INVALID_PAGE_ID;
+  tail_page_id_ = page_id;
+  size_ = 0;
+}
+
+auto BPlusTreePostingPage::GetPageId() const -> page_id_t { return page_id_; }
+
+auto BPlusTreePostingPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void BPlusTreePostingPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto BPlusTreePostingPage::GetTailPageId() const -> page_id_t { return tail_page_id_; }
+
+void BPlusTreePostingPage::SetTailPageId(page_id_t tail_page_id) { tail_page_id_ = tail_page_id; }
+
+auto BPlusTreePostingPage::GetSize() const -> int { return size_; }
+
+auto BPlusTreePostingPage::IsFull() const -> bool { return size_ == static_cast<int>(POSTING_PAGE_SIZE); }
+
+auto BPlusTreePostingPage::RidAt(int index) const -> RID { return rids_[index]; }
+
+void BPlusTreePostingPage::SetRidAt(int index, const RID &rid) { rids_[index] = rid; }
+
+auto BPlusTreePostingPage::Find(const RID &rid) const -> int {
+  for (int i = 0; i < size_; i++) {
+    if (rids_[i] == rid) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void BPlusTreePostingPage::Append(const RID &rid) {
+  BUSTUB_ASSERT(!IsFull(), "posting page is full");
+  rids_[size_++] = rid;
+}
+
+auto BPlusTreePostingPage::PopBack() -> RID {
+  BUSTUB_ASSERT(size_ > 0, "posting page is empty");
+  return rids_[--size_];
+}
+
+}  // namespace bustub
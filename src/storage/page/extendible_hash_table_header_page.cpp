@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_header_page.cpp
+//
+// Identification: src/storage/page/extendible_hash_table_header_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_hash_table_header_page.h"
+
+namespace bustub {
+
+void ExtendibleHashTableHeaderPage::Init(page_id_t page_id, page_id_t directory_page_id, uint32_t max_depth) {
+  assert((1U << max_depth) <= HEADER_ARRAY_SIZE);
+  lsn_ = INVALID_LSN;
+  page_id_ = page_id;
+  global_depth_ = 0;
+  max_depth_ = max_depth;
+  local_depths_[0] = 0;
+  directory_page_ids_[0] = directory_page_id;
+}
+
+auto ExtendibleHashTableHeaderPage::GetPageId() const -> page_id_t { return page_id_; }
+
+auto ExtendibleHashTableHeaderPage::GetLSN() const -> lsn_t { return lsn_; }
+
+void ExtendibleHashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+auto ExtendibleHashTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  // shifting a 32-bit value by 32 is undefined, so depth 0 is spelled out
+  return global_depth_ == 0 ? 0 : hash >> (32 - global_depth_);
+}
+
+auto ExtendibleHashTableHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  return directory_page_ids_[directory_idx];
+}
+
+void ExtendibleHashTableHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+auto ExtendibleHashTableHeaderPage::GetGlobalDepth() const -> uint32_t { return global_depth_; }
+
+auto ExtendibleHashTableHeaderPage::GetMaxDepth() const -> uint32_t { return max_depth_; }
+
+void ExtendibleHashTableHeaderPage::IncrGlobalDepth() {
+  assert(global_depth_ < max_depth_);
+  // going from the top down leaves every slot unread by the time it is overwritten
+  for (uint32_t i = Size(); i-- > 0;) {
+    directory_page_ids_[2 * i] = directory_page_ids_[2 * i + 1] = directory_page_ids_[i];
+    local_depths_[2 * i] = local_depths_[2 * i + 1] = local_depths_[i];
+  }
+  global_depth_++;
+}
+
+auto ExtendibleHashTableHeaderPage::Size() const -> uint32_t { return 1U << global_depth_; }
+
+auto ExtendibleHashTableHeaderPage::GetLocalDepth(uint32_t directory_idx) const -> uint32_t {
+  return local_depths_[directory_idx];
+}
+
+void ExtendibleHashTableHeaderPage::IncrLocalDepth(uint32_t directory_idx) { local_depths_[directory_idx]++; }
+
+void ExtendibleHashTableHeaderPage::VerifyIntegrity() const {
+  assert(global_depth_ <= max_depth_);
+  uint32_t i = 0;
+  while (i < Size()) {
+    uint32_t local_depth = local_depths_[i];
+    assert(local_depth <= global_depth_);
+    uint32_t count = 1U << (global_depth_ - local_depth);
+    // the slots of a directory are aligned to their count
+    assert(i % count == 0);
+    for (uint32_t j = i; j < i + count; j++) {
+      assert(directory_page_ids_[j] == directory_page_ids_[i]);
+      assert(local_depths_[j] == local_depth);
+    }
+    i += count;
+  }
+}
+
+}  // namespace bustub
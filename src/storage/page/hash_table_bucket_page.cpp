@@ -11,71 +11,208 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "common/logger.h"
 #include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
 #include "storage/index/generic_key.h"
 #include "storage/index/hash_comparator.h"
 #include "storage/table/tmp_tuple.h"
 
 namespace bustub {
 
+namespace {
+
+#if defined(__AVX2__)
+constexpr uint32_t FINGERPRINT_LANES = 32;
+#elif defined(__SSE2__)
+constexpr uint32_t FINGERPRINT_LANES = 16;
+#else
+constexpr uint32_t FINGERPRINT_LANES = 8;
+#endif
+
+/** @return a mask with bit i set if fingerprints[i] equals fingerprint, for the next FINGERPRINT_LANES bytes */
+inline auto MatchFingerprints(const uint8_t *fingerprints, uint8_t fingerprint) -> uint32_t {
+#if defined(__AVX2__)
+  __m256i matches = _mm256_cmpeq_epi8(_mm256_set1_epi8(static_cast<char>(fingerprint)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(fingerprints)));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+#elif defined(__SSE2__)
+  __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(fingerprint)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints)));
+  return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < FINGERPRINT_LANES; i++) {
+    mask |= static_cast<uint32_t>(fingerprints[i] == fingerprint) << i;
+  }
+  return mask;
+#endif
+}
+
+/** @return the FINGERPRINT_LANES bits of a bitmap starting at a byte, bit i for slot 8 * byte + i */
+inline auto LoadBits(const char *bitmap, uint32_t byte) -> uint32_t {
+  uint32_t bits = 0;
+  for (uint32_t i = 0; i < FINGERPRINT_LANES / 8; i++) {
+    bits |= static_cast<uint32_t>(static_cast<unsigned char>(bitmap[byte + i])) << (8 * i);
+  }
+  return bits;
+}
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::Fingerprint(const KeyType &key) -> uint8_t {
+  // the table picks buckets and directories by the low 32 bits of the same hash
+  return static_cast<uint8_t>(HashFunction<KeyType>().GetHash(key) >> 56);
+}
+
+/*
+ * Slots are taken front to back and stay occupied after a removal, so a scan
+ * can stop at the first group of slots that were never used.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+auto HASH_TABLE_BUCKET_TYPE::FindMatching(uint8_t fingerprint, Visitor &&visit) const -> bool {
+  uint32_t bucket_idx = 0;
+  for (; bucket_idx + FINGERPRINT_LANES <= BUCKET_ARRAY_SIZE; bucket_idx += FINGERPRINT_LANES) {
+    if (LoadBits(occupied_, bucket_idx / 8) == 0) {
+      return false;
+    }
+    uint32_t matches = MatchFingerprints(fingerprints_ + bucket_idx, fingerprint) & LoadBits(readable_, bucket_idx / 8);
+    while (matches != 0) {
+      if (visit(bucket_idx + __builtin_ctz(matches))) {
+        return true;
+      }
+      matches &= matches - 1;
+    }
+  }
+  for (; bucket_idx < BUCKET_ARRAY_SIZE && IsOccupied(bucket_idx); bucket_idx++) {
+    if (fingerprints_[bucket_idx] == fingerprint && IsReadable(bucket_idx) && visit(bucket_idx)) {
+      return true;
+    }
+  }
   return false;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
+  bool found = false;
+  FindMatching(Fingerprint(key), [&](uint32_t bucket_idx) {
+    if (cmp(key, array_[bucket_idx].first) == 0) {
+      result->push_back(array_[bucket_idx].second);
+      found = true;
+    }
+    return false;
+  });
+  return found;
+}
+
+/*
+ * Any slot that is not readable takes the pair: a tombstone, or the first
+ * slot that was never used, which keeps the occupied slots in front.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return true;
+  uint8_t fingerprint = Fingerprint(key);
+  bool exists = FindMatching(fingerprint, [&](uint32_t bucket_idx) {
+    return cmp(key, array_[bucket_idx].first) == 0 && array_[bucket_idx].second == value;
+  });
+  if (exists) {
+    return false;
+  }
+  for (uint32_t byte = 0; byte < sizeof(readable_); byte++) {
+    auto free_bits = static_cast<unsigned char>(~readable_[byte]);
+    if (free_bits == 0) {
+      continue;
+    }
+    uint32_t bucket_idx = byte * 8 + __builtin_ctz(free_bits);
+    if (bucket_idx >= BUCKET_ARRAY_SIZE) {
+      break;
+    }
+    array_[bucket_idx] = MappingType(key, value);
+    fingerprints_[bucket_idx] = fingerprint;
+    SetOccupied(bucket_idx);
+    SetReadable(bucket_idx);
+    return true;
+  }
+  return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return false;
+  return FindMatching(Fingerprint(key), [&](uint32_t bucket_idx) {
+    if (cmp(key, array_[bucket_idx].first) == 0 && array_[bucket_idx].second == value) {
+      RemoveAt(bucket_idx);
+      return true;
+    }
+    return false;
+  });
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+  uint32_t count = 0;
+  for (auto bits : readable_) {
+    count += __builtin_popcount(static_cast<unsigned char>(bits));
+  }
+  return count;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+  for (auto bits : readable_) {
+    if (bits != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
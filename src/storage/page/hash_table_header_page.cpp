@@ -12,23 +12,52 @@
 
 #include "storage/page/hash_table_header_page.h"
 
+#include <cstddef>
+
 namespace bustub {
-auto HashTableHeaderPage::GetBlockPageId(size_t index) -> page_id_t { return 0; }
+auto HashTableHeaderPage::GetBlockPageId(size_t index) -> page_id_t {
+  assert(index < next_ind_);
+  return block_page_ids_[index];
+}
+
+void HashTableHeaderPage::SetBlockPageId(size_t index, page_id_t page_id) {
+  assert(index < next_ind_);
+  block_page_ids_[index] = page_id;
+}
+
+auto HashTableHeaderPage::GetPageId() const -> page_id_t { return page_id_; }
+
+void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) { page_id_ = page_id; }
+
+auto HashTableHeaderPage::GetLSN() const -> lsn_t { return lsn_; }
+
+void HashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {
+  assert(next_ind_ < MaxNumBlocks());
+  block_page_ids_[next_ind_++] = page_id;
+}
+
+auto HashTableHeaderPage::NumBlocks() -> size_t { return next_ind_; }
+
+auto HashTableHeaderPage::MaxNumBlocks() -> size_t {
+  return (BUSTUB_PAGE_SIZE - offsetof(HashTableHeaderPage, block_page_ids_)) / sizeof(page_id_t);
+}
 
-auto HashTableHeaderPage::GetPageId() const -> page_id_t { return 0; }
+void HashTableHeaderPage::SetSize(size_t size) { size_ = size; }
 
-void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) {}
+auto HashTableHeaderPage::GetSize() const -> size_t { return size_; }
 
-auto HashTableHeaderPage::GetLSN() const -> lsn_t { return 0; }
+auto HashTableHeaderPage::GetNumOccupied() const -> size_t { return num_occupied_; }
 
-void HashTableHeaderPage::SetLSN(lsn_t lsn) {}
+void HashTableHeaderPage::SetNumOccupied(size_t num_occupied) { num_occupied_ = num_occupied; }
 
-void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {}
+auto HashTableHeaderPage::GetOldHeaderPageId() const -> page_id_t { return old_header_page_id_; }
 
-auto HashTableHeaderPage::NumBlocks() -> size_t { return 0; }
+void HashTableHeaderPage::SetOldHeaderPageId(page_id_t page_id) { old_header_page_id_ = page_id; }
 
-void HashTableHeaderPage::SetSize(size_t size) {}
+auto HashTableHeaderPage::GetMigratedBlocks() const -> size_t { return migrated_blocks_; }
 
-auto HashTableHeaderPage::GetSize() const -> size_t { return 0; }
+void HashTableHeaderPage::SetMigratedBlocks(size_t migrated_blocks) { migrated_blocks_ = migrated_blocks; }
 
 }  // namespace bustub
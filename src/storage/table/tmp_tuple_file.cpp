@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.cpp
+//
+// Identification: src/storage/table/tmp_tuple_file.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_file.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleFile::~TmpTupleFile() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleFile::Append(const Tuple &tuple) {
+  TmpTuple out(INVALID_PAGE_ID, 0);
+  if (buffer_ != nullptr && buffer_->Insert(tuple, &out)) {
+    num_tuples_++;
+    return;
+  }
+  if (buffer_ == nullptr) {
+    buffer_ = std::make_unique<TmpTuplePage>();
+  } else {
+    FlushBuffer();
+  }
+  buffer_->Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE);
+  if (!buffer_->Insert(tuple, &out)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "tuple does not fit in a temporary page");
+  }
+  num_tuples_++;
+}
+
+void TmpTupleFile::Finish() {
+  if (buffer_ != nullptr) {
+    FlushBuffer();
+    buffer_.reset();
+  }
+}
+
+void TmpTupleFile::FlushBuffer() {
+  if (buffer_->GetFreeSpacePointer() == BUSTUB_PAGE_SIZE) {
+    return;
+  }
+  page_id_t page_id;
+  auto *page = bpm_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool for a temporary page");
+  }
+  memcpy(page->GetData(), buffer_->GetData(), BUSTUB_PAGE_SIZE);
+  reinterpret_cast<TmpTuplePage *>(page)->SetTablePageId(page_id);
+  bpm_->UnpinPage(page_id, true);
+  page_ids_.push_back(page_id);
+}
+
+auto TmpTupleFile::Reader::Next(Tuple *tuple) -> bool {
+  while (tuples_.empty()) {
+    if (page_idx_ == file_->page_ids_.size()) {
+      return false;
+    }
+    auto page_id = file_->page_ids_[page_idx_++];
+    auto *page = file_->bpm_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool for a temporary page");
+    }
+    auto *tmp_page = reinterpret_cast<TmpTuplePage *>(page);
+    for (size_t offset = tmp_page->GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE;) {
+      offset = tmp_page->Get(offset, &tuples_.emplace_back());
+    }
+    file_->bpm_->UnpinPage(page_id, false);
+  }
+  *tuple = std::move(tuples_.back());
+  tuples_.pop_back();
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,228 @@
+/**
+ * art_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/art/art.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+auto MakeArtKey(int64_t key, size_t width = 8) -> ArtKey {
+  ArtKey art_key;
+  art_key.AppendInteger(key, width);
+  return art_key;
+}
+
+auto MakeRid(int64_t key) -> RID { return {static_cast<page_id_t>(key >> 32), static_cast<uint32_t>(key)}; }
+
+TEST(AdaptiveRadixTreeTest, SampleTest) {
+  auto tree = std::make_unique<AdaptiveRadixTree>();
+
+  EXPECT_TRUE(tree->Insert(MakeArtKey(1), MakeRid(1)));
+  EXPECT_TRUE(tree->Insert(MakeArtKey(-1), MakeRid(-1)));
+  EXPECT_TRUE(tree->Insert(MakeArtKey(256), MakeRid(256)));
+  EXPECT_FALSE(tree->Insert(MakeArtKey(1), MakeRid(2)));
+
+  RID rid;
+  EXPECT_TRUE(tree->Lookup(MakeArtKey(1), &rid));
+  EXPECT_EQ(MakeRid(1), rid);
+  EXPECT_TRUE(tree->Lookup(MakeArtKey(-1), &rid));
+  EXPECT_EQ(MakeRid(-1), rid);
+  EXPECT_FALSE(tree->Lookup(MakeArtKey(2), &rid));
+
+  EXPECT_FALSE(tree->Remove(MakeArtKey(1), MakeRid(2)));
+  EXPECT_TRUE(tree->Lookup(MakeArtKey(1), &rid));
+  EXPECT_TRUE(tree->Remove(MakeArtKey(1), MakeRid(1)));
+  EXPECT_FALSE(tree->Remove(MakeArtKey(1)));
+  EXPECT_FALSE(tree->Lookup(MakeArtKey(1), &rid));
+  EXPECT_TRUE(tree->Lookup(MakeArtKey(256), &rid));
+}
+
+TEST(AdaptiveRadixTreeTest, RandomTest) {
+  // small key ranges exercise growing and shrinking of the inner nodes, large ones exercise path compression
+  for (int64_t range : {int64_t{300}, int64_t{100000}, int64_t{1} << 40}) {
+    auto tree = std::make_unique<AdaptiveRadixTree>();
+    std::map<int64_t, RID> expected;
+    std::mt19937_64 rng(range);
+
+    for (int i = 0; i < 100000; i++) {
+      auto key = static_cast<int64_t>(rng() % range) - range / 2;
+      if (rng() % 3 != 0) {
+        EXPECT_EQ(expected.count(key) == 0, tree->Insert(MakeArtKey(key), MakeRid(key)));
+        expected.emplace(key, MakeRid(key));
+      } else {
+        EXPECT_EQ(expected.erase(key) == 1, tree->Remove(MakeArtKey(key)));
+      }
+    }
+
+    for (int i = 0; i < 10000; i++) {
+      auto key = static_cast<int64_t>(rng() % range) - range / 2;
+      RID rid;
+      ASSERT_EQ(expected.count(key) == 1, tree->Lookup(MakeArtKey(key), &rid));
+    }
+    for (const auto &[key, value] : expected) {
+      RID rid;
+      ASSERT_TRUE(tree->Lookup(MakeArtKey(key), &rid));
+      EXPECT_EQ(value, rid);
+    }
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, RangeScanTest) {
+  auto tree = std::make_unique<AdaptiveRadixTree>();
+  std::map<int64_t, RID> expected;
+  std::mt19937_64 rng(15445);
+  for (int i = 0; i < 20000; i++) {
+    // clustered keys exercise all node sizes, spread out keys exercise path compression
+    auto key = i % 2 == 0 ? static_cast<int64_t>(rng() % 5000) - 2500 : static_cast<int64_t>(rng());
+    tree->Insert(MakeArtKey(key), MakeRid(key));
+    expected.emplace(key, MakeRid(key));
+  }
+
+  for (int i = 0; i < 500; i++) {
+    auto low = static_cast<int64_t>(rng() % 6000) - 3000;
+    auto high = i % 10 == 0 ? static_cast<int64_t>(rng()) : low + static_cast<int64_t>(rng() % 1000);
+    bool low_inclusive = rng() % 2 == 0;
+    bool high_inclusive = rng() % 2 == 0;
+    std::vector<RID> result;
+    tree->ScanRange(MakeArtKey(low), low_inclusive, MakeArtKey(high), high_inclusive, &result);
+
+    std::vector<RID> want;
+    for (auto it = low_inclusive ? expected.lower_bound(low) : expected.upper_bound(low);
+         it != expected.end() && (high_inclusive ? it->first <= high : it->first < high); ++it) {
+      want.push_back(it->second);
+    }
+    ASSERT_EQ(want, result);
+  }
+
+  // open bounds
+  std::vector<RID> result;
+  tree->ScanRange(std::nullopt, true, std::nullopt, true, &result);
+  ASSERT_EQ(expected.size(), result.size());
+  EXPECT_EQ(expected.begin()->second, result.front());
+  EXPECT_EQ(expected.rbegin()->second, result.back());
+}
+
+TEST(AdaptiveRadixTreeTest, StringKeyTest) {
+  auto tree = std::make_unique<AdaptiveRadixTree>();
+  auto make_key = [](const std::string &str) {
+    ArtKey key;
+    key.AppendString(str.data(), str.size());
+    return key;
+  };
+
+  // strings that are prefixes of each other, share long prefixes or contain zero bytes
+  std::vector<std::string> strings{"",         "a",           "ab",         "abc",   std::string("a\0", 2),
+                                   "b",        "terrier",     "terriers",   "terra", std::string(20, 'x'),
+                                   "xxxxxxxx", std::string(21, 'x'), std::string(20, 'x') + "y"};
+  for (size_t i = 0; i < strings.size(); i++) {
+    EXPECT_TRUE(tree->Insert(make_key(strings[i]), RID(0, i)));
+  }
+  for (size_t i = 0; i < strings.size(); i++) {
+    RID rid;
+    ASSERT_TRUE(tree->Lookup(make_key(strings[i]), &rid));
+    EXPECT_EQ(i, rid.GetSlotNum());
+  }
+
+  std::vector<size_t> order(strings.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return strings[a] < strings[b]; });
+  std::vector<RID> result;
+  tree->ScanRange(make_key("a"), false, make_key("terriers"), false, &result);
+  std::vector<RID> want;
+  for (auto i : order) {
+    if (strings[i] > "a" && strings[i] < "terriers") {
+      want.emplace_back(0, i);
+    }
+  }
+  EXPECT_EQ(want, result);
+}
+
+TEST(AdaptiveRadixTreeTest, ConcurrentTest) {
+  const int num_threads = 8;
+  const int num_keys = 100000;
+  auto tree = std::make_unique<AdaptiveRadixTree>();
+
+  // every thread inserts its own keys and removes a third of them again while a reader looks them up
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([tid, &tree]() {
+      for (int key = tid; key < num_keys; key += num_threads) {
+        EXPECT_TRUE(tree->Insert(MakeArtKey(key, 4), MakeRid(key)));
+      }
+      for (int key = tid; key < num_keys; key += num_threads) {
+        if (key % 3 == 0) {
+          EXPECT_TRUE(tree->Remove(MakeArtKey(key, 4)));
+        }
+      }
+    });
+  }
+  std::atomic<bool> done{false};
+  std::thread reader([&done, &tree]() {
+    std::mt19937 rng(15445);
+    while (!done) {
+      uint32_t key = rng() % num_keys;
+      RID rid;
+      if (tree->Lookup(MakeArtKey(key, 4), &rid)) {
+        EXPECT_EQ(MakeRid(key), rid);
+      }
+      // a scan racing with the writers still returns keys within the range in order
+      std::vector<RID> result;
+      tree->ScanRange(MakeArtKey(key, 4), true, MakeArtKey(key + 100, 4), false, &result);
+      for (size_t i = 0; i < result.size(); i++) {
+        EXPECT_GE(result[i].GetSlotNum(), key);
+        EXPECT_LT(result[i].GetSlotNum(), key + 100);
+        if (i > 0) {
+          EXPECT_LT(result[i - 1].GetSlotNum(), result[i].GetSlotNum());
+        }
+      }
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+
+  for (int key = 0; key < num_keys; key++) {
+    RID rid;
+    EXPECT_EQ(key % 3 != 0, tree->Lookup(MakeArtKey(key, 4), &rid));
+  }
+
+  // all threads fight over the same few keys
+  threads.clear();
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([tid, &tree]() {
+      std::mt19937 rng(tid);
+      for (int i = 0; i < 50000; i++) {
+        int key = rng() % 2000;
+        if (rng() % 2 == 0) {
+          tree->Insert(MakeArtKey(key, 4), MakeRid(key));
+        } else {
+          tree->Remove(MakeArtKey(key, 4));
+        }
+        RID rid;
+        if (tree->Lookup(MakeArtKey(key, 4), &rid)) {
+          EXPECT_EQ(MakeRid(key), rid);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace bustub
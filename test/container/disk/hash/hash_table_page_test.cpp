@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,13 +18,14 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/extendible_hash_table_header_page.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -57,7 +59,50 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page =
+      reinterpret_cast<ExtendibleHashTableHeaderPage *>(bpm->NewPage(&header_page_id, nullptr)->GetData());
+  header_page->Init(header_page_id, 7, 2);
+  EXPECT_EQ(header_page_id, header_page->GetPageId());
+  EXPECT_EQ(0, header_page->GetGlobalDepth());
+  EXPECT_EQ(2, header_page->GetMaxDepth());
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+  EXPECT_EQ(7, header_page->GetDirectoryPageId(0));
+
+  // doubling keeps the directory of every hash, and picks slots by the top bits
+  header_page->IncrGlobalDepth();
+  EXPECT_EQ(2, header_page->Size());
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0x7FFFFFFF));
+  EXPECT_EQ(1, header_page->HashToDirectoryIndex(0x80000000));
+  EXPECT_EQ(7, header_page->GetDirectoryPageId(1));
+  header_page->VerifyIntegrity();
+
+  // split the directory in two by the top bit
+  header_page->IncrLocalDepth(0);
+  header_page->IncrLocalDepth(1);
+  header_page->SetDirectoryPageId(1, 8);
+  header_page->IncrGlobalDepth();
+  EXPECT_EQ(4, header_page->Size());
+  for (uint32_t i = 0; i < 4; i++) {
+    EXPECT_EQ(i < 2 ? 7 : 8, header_page->GetDirectoryPageId(i));
+    EXPECT_EQ(1, header_page->GetLocalDepth(i));
+  }
+  EXPECT_EQ(2, header_page->HashToDirectoryIndex(0xBFFFFFFF));
+  header_page->VerifyIntegrity();
+
+  bpm->UnpinPage(header_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -114,4 +159,50 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFullTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
+      bpm->NewPage(&bucket_page_id, nullptr)->GetData());
+
+  // fill every slot, with a few values per key, so that the scans cover whole groups of fingerprints and the tail
+  int num_pairs = 0;
+  while (bucket_page->Insert(num_pairs / 3, num_pairs, IntComparator())) {
+    num_pairs++;
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_EQ(num_pairs, bucket_page->NumReadable());
+  EXPECT_FALSE(bucket_page->Insert(0, 0, IntComparator()));
+
+  for (int key = 0; key * 3 < num_pairs; key++) {
+    std::vector<int> values;
+    EXPECT_TRUE(bucket_page->GetValue(key, IntComparator(), &values));
+    EXPECT_EQ(std::min(3, num_pairs - key * 3), values.size());
+    EXPECT_FALSE(bucket_page->Insert(key, key * 3, IntComparator()));
+  }
+  std::vector<int> values;
+  EXPECT_FALSE(bucket_page->GetValue(-1, IntComparator(), &values));
+
+  // removed slots are taken again, front to back
+  EXPECT_TRUE(bucket_page->Remove(10, 31, IntComparator()));
+  EXPECT_TRUE(bucket_page->Remove(2, 6, IntComparator()));
+  EXPECT_FALSE(bucket_page->Remove(2, 6, IntComparator()));
+  EXPECT_TRUE(bucket_page->Insert(-1, -1, IntComparator()));
+  EXPECT_EQ(-1, bucket_page->KeyAt(6));
+  EXPECT_TRUE(bucket_page->Insert(-2, -2, IntComparator()));
+  EXPECT_EQ(-2, bucket_page->KeyAt(31));
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_TRUE(bucket_page->GetValue(-1, IntComparator(), &values));
+  EXPECT_EQ(std::vector<int>{-1}, values);
+
+  bpm->UnpinPage(bucket_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
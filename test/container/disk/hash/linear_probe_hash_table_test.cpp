@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/logger.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // duplicate pairs are rejected, other values of a key are not
+  EXPECT_FALSE(ht.Insert(nullptr, 1, 1));
+  EXPECT_TRUE(ht.Insert(nullptr, 1, 2));
+  std::vector<int> res;
+  ht.GetValue(nullptr, 1, &res);
+  EXPECT_EQ(2, res.size());
+
+  EXPECT_TRUE(ht.Remove(nullptr, 1, 1));
+  EXPECT_FALSE(ht.Remove(nullptr, 1, 1));
+  res.clear();
+  ht.GetValue(nullptr, 1, &res);
+  EXPECT_EQ(std::vector<int>{2}, res);
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  // every key stays visible while the pairs move between tables
+  const int num_keys = 20000;
+  bool resized = false;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    resized = resized || ht.IsResizing();
+    if (i % 97 == 0) {
+      for (int j = 0; j <= i; j += 13) {
+        std::vector<int> res;
+        ht.GetValue(nullptr, j, &res);
+        ASSERT_EQ(1, res.size()) << "Lost " << j << " after inserting " << i << std::endl;
+      }
+    }
+  }
+  EXPECT_TRUE(resized);
+  EXPECT_GT(ht.GetSize(), initial_size);
+  EXPECT_GE(ht.GetSize(), num_keys);
+
+  // removes move the rest of the pairs
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_FALSE(ht.IsResizing());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 2, res.size()) << "key " << i;
+  }
+
+  // an explicit resize drops the tombstones
+  size_t size = ht.GetSize();
+  ht.Resize(size);
+  EXPECT_EQ(2 * size, ht.GetSize());
+  EXPECT_TRUE(ht.IsResizing());
+  for (int i = 1; i < num_keys; i += 2) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "key " << i;
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_FALSE(ht.IsResizing());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // writers grow the table while readers look up the keys written before
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        // a key this thread inserted half way back
+        int key = t + num_threads * (i / num_threads / 2);
+        std::vector<int> res;
+        ht.GetValue(nullptr, key, &res);
+        EXPECT_EQ(1, res.size()) << "key " << key;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "key " << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -10,7 +10,7 @@
 
 namespace bustub {
 
-TEST(ExtendibleHashTableTest, DISABLED_SampleTest) {
+TEST(ExtendibleHashTableTest, SampleTest) {
   auto table = std::make_unique<ExtendibleHashTable<int, std::string>>(2);
 
   table->Insert(1, "a");
@@ -42,7 +42,7 @@ TEST(ExtendibleHashTableTest, DISABLED_SampleTest) {
   EXPECT_FALSE(table->Remove(20));
 }
 
-TEST(ExtendibleHashTableTest, DISABLED_ConcurrentInsertTest) {
+TEST(ExtendibleHashTableTest, ConcurrentInsertTest) {
   const int num_runs = 50;
   const int num_threads = 3;
 
@@ -68,4 +68,43 @@ TEST(ExtendibleHashTableTest, DISABLED_ConcurrentInsertTest) {
   }
 }
 
+TEST(ExtendibleHashTableTest, ConcurrentMixedTest) {
+  const int num_threads = 4;
+  const int num_keys = 2000;
+  auto table = std::make_unique<ExtendibleHashTable<int, int>>(4);
+
+  // Every thread owns the keys that are equal to its id modulo num_threads, and reads everybody else's while the
+  // directory keeps splitting underneath.
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([tid, &table]() {
+      for (int key = tid; key < num_keys; key += num_threads) {
+        table->Insert(key, key);
+        int val;
+        EXPECT_TRUE(table->Find(key, val));
+        EXPECT_EQ(key, val);
+        table->Find((key + 1) % num_keys, val);
+      }
+      for (int key = tid; key < num_keys; key += 2 * num_threads) {
+        EXPECT_TRUE(table->Remove(key));
+        table->Insert(key + num_threads, -key);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int key = 0; key < num_keys; key++) {
+    int val;
+    bool removed = key % (2 * num_threads) < num_threads;
+    EXPECT_EQ(!removed, table->Find(key, val));
+    if (!removed) {
+      EXPECT_EQ(-(key - num_threads), val);
+    }
+  }
+  EXPECT_LE(table->GetNumBuckets(), 1 << table->GetGlobalDepth());
+}
+
 }  // namespace bustub
@@ -0,0 +1,171 @@
+/**
+ * flat_hash_table_test.cpp
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/hash/flat_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(FlatHashTableTest, SampleTest) {
+  FlatHashTable<int, std::string> table;
+
+  EXPECT_TRUE(table.Insert(1, "a"));
+  EXPECT_TRUE(table.Insert(2, "b"));
+  EXPECT_FALSE(table.Insert(1, "c"));
+  EXPECT_EQ(2U, table.Size());
+  EXPECT_EQ("a", *table.Find(1));
+  EXPECT_EQ("b", *table.Find(2));
+  EXPECT_EQ(nullptr, table.Find(3));
+
+  table.Upsert(
+      1, []() { return std::string{}; }, [](std::string &value) { value += "x"; });
+  table.Upsert(
+      3, []() { return std::string{"c"}; }, [](std::string &value) { value += "y"; });
+  EXPECT_EQ("ax", *table.Find(1));
+  EXPECT_EQ("cy", *table.Find(3));
+
+  table.Clear();
+  EXPECT_EQ(0U, table.Size());
+  EXPECT_EQ(nullptr, table.Find(1));
+  EXPECT_TRUE(table.Insert(1, "d"));
+  EXPECT_EQ("d", *table.Find(1));
+}
+
+TEST(FlatHashTableTest, GrowTest) {
+  const int num_keys = 10000;
+  FlatHashTable<int, int> table;
+
+  std::vector<int *> values;
+  for (int key = 0; key < num_keys; key++) {
+    EXPECT_TRUE(table.Insert(key, key * 2));
+    values.push_back(table.Find(key));
+  }
+  EXPECT_EQ(static_cast<size_t>(num_keys), table.Size());
+
+  // the entries do not move when the slot array grows
+  for (int key = 0; key < num_keys; key++) {
+    EXPECT_EQ(values[key], table.Find(key));
+    EXPECT_EQ(key * 2, *values[key]);
+  }
+
+  // the keys come back in the order they were inserted
+  int expected = 0;
+  for (auto iter = table.Begin(); iter != table.End(); ++iter) {
+    EXPECT_EQ(expected, iter.Key());
+    EXPECT_EQ(expected * 2, iter.Val());
+    expected++;
+  }
+  EXPECT_EQ(num_keys, expected);
+}
+
+TEST(FlatHashTableTest, ConcurrentUpsertTest) {
+  const int num_threads = 4;
+  const int num_keys = 1000;
+  const int num_rounds = 10;
+  FlatHashTable<int, int> table(16);
+  EXPECT_TRUE(table.IsConcurrent());
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&table]() {
+      for (int round = 0; round < num_rounds; round++) {
+        for (int key = 0; key < num_keys; key++) {
+          table.Upsert(
+              key, []() { return 0; }, [](int &value) { value++; });
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(static_cast<size_t>(num_keys), table.Size());
+  size_t count = 0;
+  for (auto iter = table.Begin(); iter != table.End(); ++iter) {
+    EXPECT_EQ(num_threads * num_rounds, iter.Val());
+    count++;
+  }
+  EXPECT_EQ(static_cast<size_t>(num_keys), count);
+}
+
+TEST(FlatHashTableTest, ConcurrentFindTest) {
+  const int num_threads = 4;
+  const int num_keys = 1000;
+  // a few keys leave most of the partitions without a slot array
+  FlatHashTable<int, int> table(64);
+  for (int key = 0; key < 4; key++) {
+    EXPECT_TRUE(table.Insert(key, key));
+  }
+
+  // readers share the table and must not allocate the slot arrays of empty partitions
+  const auto &shared = table;
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&shared]() {
+      for (int key = 0; key < num_keys; key++) {
+        const int *value = shared.Find(key);
+        if (key < 4) {
+          ASSERT_NE(nullptr, value);
+          EXPECT_EQ(key, *value);
+        } else {
+          EXPECT_EQ(nullptr, value);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(FlatHashTableTest, PartitionedMergeTest) {
+  const int num_tables = 4;
+  const int num_keys = 1000;
+  const size_t num_partitions = 16;
+
+  // Every table has a count for some of the keys; a key has the same partition in all of them.
+  std::vector<std::unique_ptr<FlatHashTable<int, int>>> tables;
+  for (int t = 0; t < num_tables; t++) {
+    tables.push_back(std::make_unique<FlatHashTable<int, int>>(num_partitions, false));
+    EXPECT_FALSE(tables.back()->IsConcurrent());
+    for (int key = t; key < num_keys; key++) {
+      tables.back()->Insert(key, 1);
+    }
+  }
+
+  // One thread per partition merges it without latches.
+  FlatHashTable<int, int> merged(num_partitions, false);
+  std::vector<std::thread> threads;
+  threads.reserve(num_partitions);
+  for (size_t partition = 0; partition < num_partitions; partition++) {
+    threads.emplace_back([&, partition]() {
+      for (auto &table : tables) {
+        for (auto iter = table->Begin(partition); iter != table->End(partition); ++iter) {
+          merged.Upsert(
+              iter.Key(), []() { return 0; }, [&](int &value) { value += iter.Val(); });
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(static_cast<size_t>(num_keys), merged.Size());
+  for (int key = 0; key < num_keys; key++) {
+    ASSERT_NE(nullptr, merged.Find(key));
+    EXPECT_EQ(std::min(key + 1, num_tables), *merged.Find(key));
+  }
+}
+
+}  // namespace bustub
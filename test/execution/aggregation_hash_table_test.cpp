@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table_test.cpp
+//
+// Identification: test/execution/aggregation_hash_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+const std::vector<AggregationType> AGGREGATION_TYPES = {
+    AggregationType::CountStarAggregate, AggregationType::CountAggregate, AggregationType::SumAggregate,
+    AggregationType::MinAggregate, AggregationType::MaxAggregate};
+
+/** A random value of a type, or null one time in five */
+auto RandomValue(TypeId type, std::mt19937 *rng) -> Value {
+  if ((*rng)() % 5 == 0) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  auto v = static_cast<int>((*rng)() % 2001) - 1000;
+  switch (type) {
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(v / 4.0);
+    case TypeId::VARCHAR:
+      return ValueFactory::GetVarcharValue(std::to_string(v));
+    default:
+      return Value(TypeId::INTEGER, v).CastAs(type);
+  }
+}
+
+/** Combine a value into the aggregate of a group the way Value arithmetic does */
+void CombineReference(AggregationType type, Value *result, const Value &in) {
+  if (type == AggregationType::CountStarAggregate) {
+    *result = result->Add(ValueFactory::GetIntegerValue(1));
+    return;
+  }
+  if (in.IsNull()) {
+    return;
+  }
+  switch (type) {
+    case AggregationType::CountAggregate:
+      *result = result->IsNull() ? ValueFactory::GetIntegerValue(1) : result->Add(ValueFactory::GetIntegerValue(1));
+      break;
+    case AggregationType::SumAggregate:
+      *result = result->IsNull() ? in : result->Add(in);
+      break;
+    case AggregationType::MinAggregate:
+      if (result->IsNull() || in.CompareLessThan(*result) == CmpBool::CmpTrue) {
+        *result = in;
+      }
+      break;
+    default:
+      if (result->IsNull() || in.CompareGreaterThan(*result) == CmpBool::CmpTrue) {
+        *result = in;
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+TEST(AggregationHashTableTest, MatchesValueAggregationTest) {
+  std::mt19937 rng(42);
+  const size_t num_groups = 37;
+  const size_t num_partitions = 4;
+  for (auto type : {TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT, TypeId::DECIMAL, TypeId::VARCHAR}) {
+    std::vector<AbstractExpressionRef> exprs;
+    std::vector<AggregationType> types;
+    for (auto agg_type : AGGREGATION_TYPES) {
+      if (type == TypeId::VARCHAR && agg_type == AggregationType::SumAggregate) {
+        continue;
+      }
+      exprs.push_back(std::make_shared<ColumnValueExpression>(0, 0, type));
+      types.push_back(agg_type);
+    }
+
+    // Two partial tables, each with some of the rows of every group, merged partition by partition.
+    std::vector<std::vector<Value>> expected(num_groups);
+    SimpleAggregationHashTable tables[2] = {{exprs, types, num_partitions}, {exprs, types, num_partitions}};
+    for (auto &table : tables) {
+      for (size_t round = 0; round < 10; round++) {
+        ColumnVector input(type);
+        input.Resize(100);
+        std::vector<AggregateState *> states;
+        for (size_t row = 0; row < 100; row++) {
+          auto group = rng() % num_groups;
+          auto value = RandomValue(type, &rng);
+          input.SetValue(row, value);
+          states.push_back(table.FindOrInsert({{ValueFactory::GetIntegerValue(static_cast<int32_t>(group))}}));
+          if (expected[group].empty()) {
+            std::vector<Value> initial;
+            table.FinalizeAggregateState(table.GenerateInitialAggregateState(), &initial);
+            expected[group] = initial;
+          }
+          for (uint32_t i = 0; i < types.size(); i++) {
+            CombineReference(types[i], &expected[group][i], value);
+          }
+        }
+        for (uint32_t i = 0; i < types.size(); i++) {
+          table.CombineAggregateColumn(i, input, states);
+        }
+      }
+    }
+    SimpleAggregationHashTable merged(exprs, types, num_partitions);
+    for (size_t partition = 0; partition < num_partitions; partition++) {
+      for (auto &table : tables) {
+        for (auto iter = table.Begin(partition); iter != table.End(partition); ++iter) {
+          merged.InsertMerge(iter.Key(), iter.Val());
+        }
+      }
+    }
+
+    ASSERT_EQ(num_groups, merged.Size());
+    for (auto iter = merged.Begin(); iter != merged.End(); ++iter) {
+      auto group = iter.Key().group_bys_[0].GetAs<int32_t>();
+      std::vector<Value> values;
+      merged.FinalizeAggregateState(iter.Val(), &values);
+      for (uint32_t i = 0; i < types.size(); i++) {
+        const auto &want = expected[group][i];
+        EXPECT_EQ(want.IsNull(), values[i].IsNull()) << group << " " << i;
+        if (!want.IsNull()) {
+          EXPECT_EQ(want.GetTypeId(), values[i].GetTypeId()) << group << " " << i;
+          EXPECT_EQ(CmpBool::CmpTrue, want.CompareEquals(values[i])) << group << " " << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(AggregationHashTableTest, SumOverflowTest) {
+  std::vector<AbstractExpressionRef> exprs{std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER)};
+  std::vector<AggregationType> types{AggregationType::SumAggregate};
+  SimpleAggregationHashTable table(exprs, types);
+  ColumnVector input(TypeId::INTEGER);
+  input.Resize(2);
+  input.SetValue(0, ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
+  input.SetValue(1, ValueFactory::GetIntegerValue(1));
+  auto *state = table.FindOrInsert({});
+  table.CombineAggregateColumn(0, input, {state, state});
+  std::vector<Value> values;
+  EXPECT_THROW(table.FinalizeAggregateState(*state, &values), Exception);
+}
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compare_kernels_test.cpp
+//
+// Identification: test/execution/compare_kernels_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <vector>
+
+#include "execution/compare_kernels.h"
+#include "execution/expressions/comparison_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+const std::vector<ComparisonType> COMPARISON_TYPES = {
+    ComparisonType::Equal,           ComparisonType::NotEqual,    ComparisonType::LessThan,
+    ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual,
+};
+
+auto Compare(const Value &lhs, ComparisonType op, const Value &rhs) -> CmpBool {
+  switch (op) {
+    case ComparisonType::Equal:
+      return lhs.CompareEquals(rhs);
+    case ComparisonType::NotEqual:
+      return lhs.CompareNotEquals(rhs);
+    case ComparisonType::LessThan:
+      return lhs.CompareLessThan(rhs);
+    case ComparisonType::LessThanOrEqual:
+      return lhs.CompareLessThanEquals(rhs);
+    case ComparisonType::GreaterThan:
+      return lhs.CompareGreaterThan(rhs);
+    default:
+      return lhs.CompareGreaterThanEquals(rhs);
+  }
+}
+
+/** A column of small random values, so that many rows are equal, and some nulls */
+auto RandomColumn(TypeId type, size_t size, std::mt19937 *rng) -> ColumnVector {
+  ColumnVector column(type);
+  column.Resize(size);
+  for (size_t row = 0; row < size; row++) {
+    auto v = static_cast<int8_t>((*rng)() % 9) - 4;
+    if ((*rng)() % 10 == 0) {
+      column.SetValue(row, ValueFactory::GetNullValueByType(type));
+    } else if (type == TypeId::BOOLEAN) {
+      column.SetValue(row, ValueFactory::GetBooleanValue(v > 0));
+    } else if (type == TypeId::DECIMAL) {
+      column.SetValue(row, ValueFactory::GetDecimalValue(v / 2.0));
+    } else {
+      column.SetValue(row, Value(TypeId::TINYINT, v).CastAs(type));
+    }
+  }
+  return column;
+}
+
+}  // namespace
+
+TEST(CompareKernelsTest, MatchesValueComparisonTest) {
+  std::mt19937 rng(42);
+  for (auto type : {TypeId::BOOLEAN, TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT,
+                    TypeId::DECIMAL}) {
+    // Sizes around the word and register widths, so that both the SIMD loops and the scalar tails run.
+    for (size_t size : {0, 1, 7, 63, 64, 65, 130, 1024}) {
+      auto lhs = RandomColumn(type, size, &rng);
+      auto rhs = RandomColumn(type, size, &rng);
+      auto constant = size > 0 && !rhs.IsNull(0) ? rhs.GetValue(0) : ValueFactory::GetZeroValueByType(type);
+      for (auto op : COMPARISON_TYPES) {
+        SelectionMask columns_mask;
+        SelectionMask constant_mask;
+        CompareColumns(lhs, op, rhs, &columns_mask);
+        CompareColumnConstant(lhs, op, constant, &constant_mask);
+        ASSERT_EQ((size + 63) / 64, columns_mask.size());
+        for (size_t row = 0; row < size; row++) {
+          bool expected = Compare(lhs.GetValue(row), op, rhs.GetValue(row)) == CmpBool::CmpTrue;
+          EXPECT_EQ(expected, (columns_mask[row / 64] >> (row % 64) & 1) != 0) << row;
+          expected = Compare(lhs.GetValue(row), op, constant) == CmpBool::CmpTrue;
+          EXPECT_EQ(expected, (constant_mask[row / 64] >> (row % 64) & 1) != 0) << row;
+        }
+        if (size % 64 != 0) {
+          EXPECT_EQ(0U, columns_mask.back() >> (size % 64));
+          EXPECT_EQ(0U, constant_mask.back() >> (size % 64));
+        }
+      }
+    }
+  }
+
+  // Nothing compares true with null.
+  auto column = RandomColumn(TypeId::INTEGER, 100, &rng);
+  SelectionMask mask;
+  CompareColumnConstant(column, ComparisonType::NotEqual, ValueFactory::GetNullValueByType(TypeId::INTEGER), &mask);
+  for (auto word : mask) {
+    EXPECT_EQ(0U, word);
+  }
+}
+
+}  // namespace bustub
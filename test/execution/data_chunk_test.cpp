@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// data_chunk_test.cpp
+//
+// Identification: test/execution/data_chunk_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/data_chunk.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeTuples(const Schema &schema, size_t num_rows) -> std::vector<Tuple> {
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < num_rows; i++) {
+    auto a = i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                        : ValueFactory::GetIntegerValue(static_cast<int32_t>(i));
+    auto b = ValueFactory::GetDecimalValue(static_cast<double>(i) / 2);
+    auto c = i % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                        : ValueFactory::GetVarcharValue("s" + std::to_string(i));
+    tuples.emplace_back(std::vector<Value>{a, b, c}, &schema);
+  }
+  return tuples;
+}
+
+}  // namespace
+
+TEST(DataChunkTest, LoadSelectTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::DECIMAL}, Column{"c", TypeId::VARCHAR, 16}});
+  auto tuples = MakeTuples(schema, 100);
+
+  DataChunk chunk;
+  chunk.Load(tuples, &schema);
+  EXPECT_EQ(100U, chunk.Size());
+  EXPECT_EQ(3U, chunk.ColumnCount());
+  for (size_t row = 0; row < chunk.Size(); row++) {
+    EXPECT_EQ(row % 7 == 0, chunk.Column(0).IsNull(row));
+    EXPECT_EQ(row % 5 == 0, chunk.Column(2).IsNull(row));
+    for (uint32_t c = 0; c < schema.GetColumnCount(); c++) {
+      auto expected = tuples[row].GetValue(&schema, c);
+      auto actual = chunk.Column(c).GetValue(row);
+      EXPECT_EQ(expected.IsNull(), actual.IsNull());
+      if (!expected.IsNull()) {
+        EXPECT_EQ(CmpBool::CmpTrue, expected.CompareEquals(actual));
+      }
+    }
+  }
+
+  SelectionVector selection{0, 3, 64, 70, 99};
+  chunk.Select(selection);
+  EXPECT_EQ(selection.size(), chunk.Size());
+  for (size_t row = 0; row < chunk.Size(); row++) {
+    auto expected = tuples[selection[row]];
+    auto actual = chunk.RowTuple(row);
+    for (uint32_t c = 0; c < schema.GetColumnCount(); c++) {
+      EXPECT_EQ(expected.GetValue(&schema, c).IsNull(), actual.GetValue(&schema, c).IsNull());
+      EXPECT_EQ(expected.GetValue(&schema, c).ToString(), actual.GetValue(&schema, c).ToString());
+    }
+  }
+}
+
+TEST(DataChunkTest, EvaluateChunkTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::DECIMAL}, Column{"c", TypeId::VARCHAR, 16}});
+  auto tuples = MakeTuples(schema, 200);
+  DataChunk chunk;
+  chunk.Load(tuples, &schema);
+
+  auto a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto b = std::make_shared<ColumnValueExpression>(0, 1, TypeId::DECIMAL);
+  auto c = std::make_shared<ColumnValueExpression>(0, 2, TypeId::VARCHAR);
+  auto int_const = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(100));
+  auto dec_const = std::make_shared<ConstantValueExpression>(ValueFactory::GetDecimalValue(20.5));
+  auto str_const = std::make_shared<ConstantValueExpression>(ValueFactory::GetVarcharValue("s42"));
+
+  auto a_less = std::make_shared<ComparisonExpression>(a, int_const, ComparisonType::LessThan);
+  auto b_greater = std::make_shared<ComparisonExpression>(b, dec_const, ComparisonType::GreaterThanOrEqual);
+  std::vector<AbstractExpressionRef> exprs{
+      a_less,
+      b_greater,
+      std::make_shared<ComparisonExpression>(c, str_const, ComparisonType::Equal),
+      std::make_shared<ArithmeticExpression>(a, int_const, ArithmeticType::Minus),
+      std::make_shared<LogicExpression>(a_less, b_greater, LogicType::And),
+      std::make_shared<LogicExpression>(a_less, b_greater, LogicType::Or),
+  };
+
+  // Every expression evaluates a chunk to what it evaluates each row to, nulls included.
+  for (const auto &expr : exprs) {
+    ColumnVector result;
+    expr->EvaluateChunk(chunk, &result);
+    ASSERT_EQ(expr->GetReturnType(), result.GetType());
+    ASSERT_EQ(chunk.Size(), result.Size());
+    for (size_t row = 0; row < chunk.Size(); row++) {
+      auto expected = expr->Evaluate(&tuples[row], schema);
+      auto actual = result.GetValue(row);
+      EXPECT_EQ(expected.IsNull(), actual.IsNull()) << expr->ToString() << " row " << row;
+      if (!expected.IsNull()) {
+        EXPECT_EQ(CmpBool::CmpTrue, expected.CompareEquals(actual)) << expr->ToString() << " row " << row;
+      }
+    }
+  }
+
+  SelectionMask mask;
+  exprs[0]->EvaluateMask(chunk, &mask);
+  SelectionVector selection;
+  MaskToSelection(mask, chunk.Size(), &selection);
+  // a < 100, without the rows where a is null
+  EXPECT_EQ(100U - 15U, selection.size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_normalizer_test.cpp
+//
+// Identification: test/execution/key_normalizer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/key_normalizer.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** A random value of a type, from a small domain so that many values are equal, or null one time in ten */
+auto RandomValue(TypeId type, std::mt19937 *rng) -> Value {
+  if ((*rng)() % 10 == 0) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  auto v = static_cast<int>((*rng)() % 21) - 10;
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(v > 0);
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(v * 1.5);
+    case TypeId::VARCHAR:
+      // Long strings with a common prefix, so that some differ only after the normalized prefix.
+      return ValueFactory::GetVarcharValue(std::string(static_cast<size_t>((*rng)() % 3) * 10, 'a') +
+                                           std::to_string(v));
+    default:
+      return Value(TypeId::INTEGER, v).CastAs(type);
+  }
+}
+
+}  // namespace
+
+TEST(KeyNormalizerTest, OrderTest) {
+  std::mt19937 rng(42);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::DECIMAL}, Column{"c", TypeId::VARCHAR, 64},
+                 Column{"d", TypeId::BIGINT}, Column{"e", TypeId::SMALLINT}, Column{"f", TypeId::BOOLEAN}});
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < 500; i++) {
+    std::vector<Value> values;
+    for (const auto &column : schema.GetColumns()) {
+      values.push_back(RandomValue(column.GetType(), &rng));
+    }
+    tuples.emplace_back(values, &schema);
+  }
+
+  for (uint32_t first = 0; first < schema.GetColumnCount(); first++) {
+    for (auto type : {OrderByType::ASC, OrderByType::DESC}) {
+      std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys;
+      for (uint32_t i = 0; i < 3; i++) {
+        auto col = (first + i) % schema.GetColumnCount();
+        order_bys.emplace_back(i == 1 ? OrderByType::DEFAULT : type,
+                               std::make_shared<ColumnValueExpression>(0, col, schema.GetColumn(col).GetType()));
+      }
+      KeyNormalizer normalizer(order_bys, schema);
+      std::vector<char> keys(tuples.size() * normalizer.KeySize());
+      for (size_t i = 0; i < tuples.size(); i++) {
+        normalizer.Normalize(tuples[i], keys.data() + i * normalizer.KeySize());
+      }
+
+      // Keys that differ order their tuples as the values do; equal exact keys come from equal values.
+      for (size_t i = 0; i < tuples.size(); i++) {
+        for (size_t j = 0; j < tuples.size(); j += 7) {
+          auto expected = normalizer.Compare(tuples[i], tuples[j]);
+          auto actual = memcmp(keys.data() + i * normalizer.KeySize(), keys.data() + j * normalizer.KeySize(),
+                               normalizer.KeySize());
+          if (actual != 0 || normalizer.IsExact()) {
+            EXPECT_EQ(expected < 0, actual < 0) << i << " " << j;
+            EXPECT_EQ(expected == 0, actual == 0) << i << " " << j;
+          }
+        }
+      }
+
+      // The radix sort orders the rows as memcmp does.
+      std::vector<uint32_t> rows(tuples.size());
+      std::iota(rows.begin(), rows.end(), 0);
+      RadixSortKeys(keys.data(), normalizer.KeySize(), &rows);
+      for (size_t i = 1; i < rows.size(); i++) {
+        EXPECT_LE(memcmp(keys.data() + rows[i - 1] * normalizer.KeySize(),
+                         keys.data() + rows[i] * normalizer.KeySize(), normalizer.KeySize()),
+                  0);
+      }
+    }
+  }
+}
+
+}  // namespace bustub
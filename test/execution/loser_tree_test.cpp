@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree_test.cpp
+//
+// Identification: test/execution/loser_tree_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "execution/loser_tree.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LoserTreeTest, MergeTest) {
+  std::mt19937 rng(42);
+  // Source counts that are and are not powers of two, with empty and duplicate-heavy sources.
+  for (size_t num_sources : {1, 2, 3, 5, 8, 13, 64}) {
+    std::vector<std::vector<int>> sources(num_sources);
+    std::vector<int> expected;
+    for (auto &source : sources) {
+      auto size = rng() % 50;
+      for (size_t i = 0; i < size; i++) {
+        source.push_back(static_cast<int>(rng() % 100));
+      }
+      std::sort(source.begin(), source.end());
+      expected.insert(expected.end(), source.begin(), source.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<size_t> heads(num_sources, 0);
+    auto less = [&](size_t lhs, size_t rhs) {
+      if (heads[lhs] == sources[lhs].size()) {
+        return false;
+      }
+      return heads[rhs] == sources[rhs].size() || sources[lhs][heads[lhs]] < sources[rhs][heads[rhs]];
+    };
+    LoserTree<decltype(less)> merge(num_sources, less);
+    std::vector<int> merged;
+    for (auto top = merge.Top(); heads[top] < sources[top].size(); top = merge.Top()) {
+      merged.push_back(sources[top][heads[top]++]);
+      merge.Replay(top);
+    }
+    EXPECT_EQ(expected, merged) << num_sources << " sources";
+  }
+}
+
+}  // namespace bustub
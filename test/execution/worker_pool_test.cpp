@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool_test.cpp
+//
+// Identification: test/execution/worker_pool_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "execution/morsel_queue.h"
+#include "execution/worker_pool.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(WorkerPoolTest, RunTest) {
+  WorkerPool pool(3);
+  std::vector<std::atomic<int>> runs(16);
+  pool.Run(runs.size(), [&](size_t i) { runs[i]++; });
+  for (const auto &count : runs) {
+    EXPECT_EQ(1, count.load());
+  }
+
+  // A task may run tasks of its own, even when every thread of the pool is busy.
+  std::atomic<int> nested{0};
+  pool.Run(4, [&](size_t) { pool.Run(4, [&](size_t) { nested++; }); });
+  EXPECT_EQ(16, nested.load());
+
+  // Every task still runs when one of them throws.
+  std::atomic<int> done{0};
+  EXPECT_THROW(pool.Run(8,
+                        [&](size_t i) {
+                          done++;
+                          if (i == 5) {
+                            throw std::runtime_error("task failed");
+                          }
+                        }),
+               std::runtime_error);
+  EXPECT_EQ(8, done.load());
+}
+
+TEST(WorkerPoolTest, MorselQueueTest) {
+  WorkerPool pool(3);
+  MorselQueue morsels(1000, 64);
+  EXPECT_EQ(16U, morsels.NumMorsels());
+
+  // The workers take every row exactly once between them.
+  std::vector<std::atomic<int>> taken(1000);
+  pool.Run(4, [&](size_t) {
+    size_t begin;
+    size_t end;
+    while (morsels.Next(&begin, &end)) {
+      EXPECT_LE(end - begin, 64U);
+      for (size_t row = begin; row < end; row++) {
+        taken[row]++;
+      }
+    }
+  });
+  for (const auto &count : taken) {
+    EXPECT_EQ(1, count.load());
+  }
+}
+
+}  // namespace bustub
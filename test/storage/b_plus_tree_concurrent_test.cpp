@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -333,4 +334,183 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, ReadDuringSplitAndMergeTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1000, disk_manager);
+  // small pages so that writers keep splitting and merging the pages readers are on
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // every fourth key stays in the tree for the whole test, the writers insert and remove the others
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> stable_keys;
+  for (int64_t key = 0; key < num_keys; key += 4) {
+    stable_keys.push_back(key);
+  }
+  InsertHelper(&tree, stable_keys);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; t++) {
+    writers.emplace_back([&tree, t] {
+      GenericKey<8> index_key;
+      for (int round = 0; round < 3; round++) {
+        for (int64_t key = 1 + t; key < num_keys; key += 2) {
+          index_key.SetFromInteger(key);
+          if (key % 4 != 0) {
+            tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+          }
+        }
+        for (int64_t key = 1 + t; key < num_keys; key += 2) {
+          index_key.SetFromInteger(key);
+          if (key % 4 != 0) {
+            tree.Remove(index_key);
+          }
+        }
+      }
+    });
+  }
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; t++) {
+    readers.emplace_back([&] {
+      GenericKey<8> index_key;
+      std::vector<GenericKey<8>> batch;
+      for (auto key : stable_keys) {
+        index_key.SetFromInteger(key);
+        batch.push_back(index_key);
+      }
+      while (!done) {
+        for (auto key : stable_keys) {
+          std::vector<RID> rids;
+          index_key.SetFromInteger(key);
+          ASSERT_TRUE(tree.GetValue(index_key, &rids));
+          ASSERT_EQ(rids[0].GetSlotNum(), key);
+        }
+        std::vector<std::vector<RID>> results;
+        tree.GetValues(batch, &results);
+        for (size_t i = 0; i < stable_keys.size(); i++) {
+          ASSERT_EQ(results[i].size(), 1);
+          ASSERT_EQ(results[i][0].GetSlotNum(), stable_keys[i]);
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t size = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), stable_keys[size]);
+    size = size + 1;
+  }
+  EXPECT_EQ(size, stable_keys.size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ScanDuringRebuildTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1000, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, true, 90);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // every fourth key stays in the tree for the whole test, the writer inserts and removes the others
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> stable_keys;
+  for (int64_t key = 0; key < num_keys; key += 4) {
+    stable_keys.push_back(key);
+  }
+  InsertHelper(&tree, stable_keys);
+
+  std::atomic<bool> done{false};
+  std::thread writer([&tree] {
+    GenericKey<8> index_key;
+    for (int round = 0; round < 3; round++) {
+      for (int64_t key = 1; key < num_keys; key++) {
+        index_key.SetFromInteger(key);
+        if (key % 4 != 0) {
+          tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+        }
+      }
+      for (int64_t key = 1; key < num_keys; key++) {
+        index_key.SetFromInteger(key);
+        if (key % 4 != 0) {
+          tree.Remove(index_key);
+        }
+      }
+    }
+  });
+  std::thread rebuilder([&tree] {
+    for (int round = 0; round < 20; round++) {
+      tree.Rebuild();
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; t++) {
+    readers.emplace_back([&] {
+      GenericKey<8> index_key;
+      while (!done) {
+        size_t found = 0;
+        int64_t last = -1;
+        for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+          int64_t key = (*iterator).second.GetSlotNum();
+          ASSERT_GT(key, last);
+          last = key;
+          found += key % 4 == 0 ? 1 : 0;
+        }
+        ASSERT_EQ(found, stable_keys.size());
+        for (auto key : stable_keys) {
+          std::vector<RID> rids;
+          index_key.SetFromInteger(key);
+          ASSERT_TRUE(tree.GetValue(index_key, &rids));
+        }
+      }
+    });
+  }
+  writer.join();
+  rebuilder.join();
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t size = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), stable_keys[size]);
+    size = size + 1;
+  }
+  EXPECT_EQ(size, stable_keys.size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
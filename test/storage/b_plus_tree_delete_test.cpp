@@ -163,4 +163,65 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, DefragmentTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  // pages packed to 90% when split at the right edge or rebuilt
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 10, 10, true, 90);
+  GenericKey<8> index_key;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 2000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+  }
+  // an ascending load leaves nothing to defragment
+  EXPECT_FALSE(tree.Defragment());
+
+  // thin out the tree, merges keep the pages at least half full but not packed
+  std::vector<int64_t> kept;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    if (key % 3 == 0) {
+      tree.Remove(index_key);
+    } else {
+      kept.push_back(key);
+    }
+  }
+  EXPECT_TRUE(tree.Defragment());
+  EXPECT_FALSE(tree.Defragment());
+
+  size_t size = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    ASSERT_LT(size, kept.size());
+    EXPECT_EQ((*iterator).second.GetSlotNum(), kept[size]);
+    size = size + 1;
+  }
+  EXPECT_EQ(size, kept.size());
+
+  // the rebuilt tree takes writes as usual
+  for (auto key : kept) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_FALSE(tree.Defragment());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
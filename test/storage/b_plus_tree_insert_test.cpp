@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -195,4 +196,214 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, BatchLookupTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // the batch lookup on an empty tree finds nothing
+  std::vector<GenericKey<8>> probes(3);
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(probes, &results, transaction);
+  EXPECT_EQ(results, std::vector<std::vector<RID>>(3));
+
+  // odd keys only, so that half of the probes miss
+  for (int64_t key = 1; key < 500; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // unsorted probes with duplicates, the results follow the order of the probes
+  std::vector<int64_t> probe_keys;
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 300; i++) {
+    probe_keys.push_back(static_cast<int64_t>(rng() % 520) - 10);
+  }
+  probes.clear();
+  for (auto key : probe_keys) {
+    index_key.SetFromInteger(key);
+    probes.push_back(index_key);
+  }
+  tree.GetValues(probes, &results, transaction);
+  ASSERT_EQ(results.size(), probe_keys.size());
+  for (size_t i = 0; i < probe_keys.size(); i++) {
+    auto key = probe_keys[i];
+    if (key > 0 && key < 500 && key % 2 == 1) {
+      ASSERT_EQ(results[i].size(), 1);
+      EXPECT_EQ(results[i][0].GetSlotNum(), key);
+    } else {
+      EXPECT_TRUE(results[i].empty());
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+TEST(BPlusTreeTests, DuplicateKeyTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // create a non-unique b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4, false);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // every tenth key gets a posting list that spans several overflow pages
+  auto num_values = [](int64_t key) -> int64_t { return key % 10 == 0 ? 2 * POSTING_PAGE_SIZE + 7 : key % 4 + 1; };
+  for (int64_t key = 0; key < 50; key++) {
+    index_key.SetFromInteger(key);
+    for (int64_t value = 0; value < num_values(key); value++) {
+      ASSERT_TRUE(tree.Insert(index_key, RID(key, value), transaction));
+    }
+    // a key with a single value still rejects that value a second time
+    if (num_values(key) == 1) {
+      EXPECT_FALSE(tree.Insert(index_key, RID(key, 0), transaction));
+    }
+  }
+
+  for (int64_t key = 0; key < 50; key++) {
+    std::vector<RID> rids;
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids, transaction));
+    ASSERT_EQ(rids.size(), num_values(key));
+    std::sort(rids.begin(), rids.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    for (int64_t value = 0; value < num_values(key); value++) {
+      EXPECT_EQ(rids[value], RID(key, value));
+    }
+  }
+
+  // the iterator returns one entry per value
+  int64_t count = 0;
+  int64_t last_key = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_LE(last_key, (*iterator).second.GetPageId());
+    last_key = (*iterator).second.GetPageId();
+    count++;
+  }
+  int64_t expected = 0;
+  for (int64_t key = 0; key < 50; key++) {
+    expected += num_values(key);
+  }
+  EXPECT_EQ(count, expected);
+
+  // removing values one at a time keeps the key until its last value is gone
+  for (int64_t key = 0; key < 50; key++) {
+    index_key.SetFromInteger(key);
+    for (int64_t value = 1; value < num_values(key); value++) {
+      tree.Remove(index_key, RID(key, value), transaction);
+    }
+    tree.Remove(index_key, RID(key, num_values(key)), transaction);
+    std::vector<RID> rids;
+    ASSERT_TRUE(tree.GetValue(index_key, &rids, transaction));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0], RID(key, 0));
+  }
+  // removing a key drops all its values
+  for (int64_t key = 0; key < 50; key += 2) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(key, 1), transaction));
+    tree.Remove(index_key, transaction);
+    std::vector<RID> rids;
+    EXPECT_FALSE(tree.GetValue(index_key, &rids, transaction));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, CollectStatsTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // create a non-unique b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 5, 5, false);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  auto stats = tree.CollectStats();
+  EXPECT_EQ(stats.height_, 0);
+  EXPECT_EQ(stats.leaf_page_count_, 0);
+  EXPECT_TRUE(stats.histogram_.empty());
+
+  // keys 1 to 1000, and every key above 500 has three values
+  for (int64_t key = 1; key <= 1000; key++) {
+    index_key.SetFromInteger(key);
+    for (int64_t value = 0; value < (key > 500 ? 3 : 1); value++) {
+      ASSERT_TRUE(tree.Insert(index_key, RID(key, value), transaction));
+    }
+  }
+
+  // sampling every leaf gives exact counts
+  stats = tree.CollectStats(1000, 4);
+  EXPECT_GE(stats.height_, 4);
+  EXPECT_GE(stats.leaf_page_count_, 1000 / 4);
+  EXPECT_GT(stats.internal_page_count_, stats.leaf_page_count_ / 5);
+  EXPECT_EQ(stats.distinct_keys_, 1000);
+  EXPECT_EQ(stats.num_values_, 2000);
+  EXPECT_GT(stats.leaf_fill_, 0.4);
+  EXPECT_LE(stats.leaf_fill_, 1.0);
+  // the histogram is equi-depth by values, so the upper half of the keys takes three of the four buckets
+  ASSERT_EQ(stats.histogram_.size(), 5);
+  int64_t expected_bounds[] = {1, 500, 667, 834, 1000};
+  for (size_t i = 0; i < stats.histogram_.size(); i++) {
+    index_key.SetFromInteger(expected_bounds[i]);
+    EXPECT_EQ(comparator(stats.histogram_[i], index_key), 0) << "bound " << i;
+  }
+
+  // a sample still sees the smallest and the largest key, and estimates the counts
+  stats = tree.CollectStats(20, 4);
+  EXPECT_NEAR(stats.distinct_keys_, 1000, 200);
+  EXPECT_NEAR(stats.num_values_, 2000, 400);
+  ASSERT_EQ(stats.histogram_.size(), 5);
+  index_key.SetFromInteger(1);
+  EXPECT_EQ(comparator(stats.histogram_.front(), index_key), 0);
+  index_key.SetFromInteger(1000);
+  EXPECT_EQ(comparator(stats.histogram_.back(), index_key), 0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
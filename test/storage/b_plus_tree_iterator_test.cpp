@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_iterator_test.cpp
+//
+// Identification: test/storage/b_plus_tree_iterator_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using Iterator = IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
+
+auto MakeKey(int64_t key) -> GenericKey<8> {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+auto Collect(Iterator iterator) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (; !iterator.IsEnd(); ++iterator) {
+    keys.push_back((*iterator).second.GetSlotNum());
+  }
+  return keys;
+}
+
+TEST(BPlusTreeTests, RangeIteratorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  Tree tree("foo_pk", bpm, comparator, 3, 4);
+  auto *transaction = new Transaction(0);
+
+  // even keys only, so that the bounds can fall between two keys
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 200; key += 2) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    RID rid;
+    rid.Set(static_cast<int32_t>(key >> 32), key);
+    tree.Insert(MakeKey(key), rid, transaction);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // full scans in both directions
+  EXPECT_EQ(Collect(tree.Begin()), keys);
+  std::vector<int64_t> reversed(keys.rbegin(), keys.rend());
+  EXPECT_EQ(Collect(tree.RBegin()), reversed);
+
+  auto expected = [&](int64_t low, bool low_inclusive, int64_t high, bool high_inclusive, bool reverse) {
+    std::vector<int64_t> result;
+    for (auto key : keys) {
+      if ((low_inclusive ? key >= low : key > low) && (high_inclusive ? key <= high : key < high)) {
+        result.push_back(key);
+      }
+    }
+    if (reverse) {
+      std::reverse(result.begin(), result.end());
+    }
+    return result;
+  };
+
+  for (int64_t low : {-1, 0, 1, 50, 51, 198, 199}) {
+    for (int64_t high : {0, 1, 50, 51, 120, 198, 500}) {
+      for (bool low_inclusive : {true, false}) {
+        for (bool high_inclusive : {true, false}) {
+          for (bool reverse : {false, true}) {
+            EXPECT_EQ(Collect(tree.BeginRange(MakeKey(low), low_inclusive, MakeKey(high), high_inclusive, reverse)),
+                      expected(low, low_inclusive, high, high_inclusive, reverse));
+          }
+        }
+      }
+    }
+  }
+
+  // an open bound runs to the end of the tree
+  EXPECT_EQ(Collect(tree.BeginRange(std::nullopt, true, MakeKey(9), true)), expected(0, true, 9, true, false));
+  EXPECT_EQ(Collect(tree.BeginRange(MakeKey(190), false, std::nullopt, true, true)),
+            expected(190, false, 1000, true, true));
+
+  // the range scan must not leave pages pinned behind, even when it is abandoned halfway
+  {
+    auto iterator = tree.BeginRange(MakeKey(10), true, std::nullopt, true);
+    ++iterator;
+  }
+  for (int64_t key = 0; key < 200; key += 2) {
+    tree.Remove(MakeKey(key), transaction);
+  }
+  EXPECT_TRUE(tree.Begin() == tree.End());
+  EXPECT_TRUE(tree.RBegin().IsEnd());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -119,6 +119,7 @@ auto main(int argc, char **argv) -> int {
   argparse::ArgumentParser program("bustub-terrier-bench");
   program.add_argument("--duration").help("run terrier bench for n milliseconds");
   program.add_argument("--force-create-index").help("create index in terrier bench");
+  program.add_argument("--index-type").help("index to create in terrier bench, btree (default) or art");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
 
   try {
@@ -149,9 +150,14 @@ auto main(int argc, char **argv) -> int {
     enable_index = ParseBool(program.get("--force-create-index"));
   }
 
+  std::string index_type = "btree";
+  if (program.present("--index-type")) {
+    index_type = program.get("--index-type");
+  }
+
   if (enable_index) {
-    auto schema = "CREATE INDEX nftid on nft(id);";
-    std::cerr << "x: create index" << std::endl;
+    auto schema = fmt::format("CREATE INDEX nftid on nft USING {} (id);", index_type);
+    std::cerr << "x: create " << index_type << " index" << std::endl;
     bustub->ExecuteSql(schema, writer);
   } else {
     std::cerr << "x: create index disabled" << std::endl;